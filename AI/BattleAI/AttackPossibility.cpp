@@ -119,12 +119,34 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleS
 	}
 }
 
+std::optional<float> DamageCache::findCachedDamage(uint32_t attackerId, uint32_t defenderId) const
+{
+	auto attackerDamageMap = damageCache.find(attackerId);
+
+	if(attackerDamageMap != damageCache.end())
+	{
+		auto targetDamage = attackerDamageMap->second.find(defenderId);
+
+		if(targetDamage != attackerDamageMap->second.end())
+			return targetDamage->second;
+	}
+
+	return parent ? parent->findCachedDamage(attackerId, defenderId) : std::nullopt;
+}
+
 int64_t DamageCache::getDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
 	bool wasComputedBefore = damageCache[attacker->unitId()].count(defender->unitId());
 
 	if (!wasComputedBefore)
-		cacheDamage(attacker, defender, hb);
+	{
+		auto parentDamage = parent ? parent->findCachedDamage(attacker->unitId(), defender->unitId()) : std::nullopt;
+
+		if(parentDamage)
+			damageCache[attacker->unitId()][defender->unitId()] = *parentDamage;
+		else
+			cacheDamage(attacker, defender, hb);
+	}
 
 	return damageCache[attacker->unitId()][defender->unitId()] * attacker->getCount();
 }
@@ -319,10 +341,10 @@ AttackPossibility AttackPossibility::evaluate(
 {
 	auto attacker = attackInfo.attacker;
 	auto defender = attackInfo.defender;
-	const std::string cachingStringBlocksRetaliation = "type_BLOCKS_RETALIATION";
+	static const auto cachingKeyBlocksRetaliation = BonusCacheKey::type(BonusType::BLOCKS_RETALIATION);
 	static const auto selectorBlocksRetaliation = Selector::type()(BonusType::BLOCKS_RETALIATION);
 	const auto attackerSide = state->playerToSide(state->battleGetOwner(attacker));
-	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation, cachingStringBlocksRetaliation);
+	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation, cachingKeyBlocksRetaliation);
 
 	AttackPossibility bestAp(hex, BattleHex::INVALID, attackInfo);
 
@@ -22,9 +22,12 @@ private:
 	DamageCache * parent;
 
 	void buildObstacleDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleSide side);
+	std::optional<float> findCachedDamage(uint32_t attackerId, uint32_t defenderId) const;
 
 public:
 	DamageCache() : parent(nullptr) {}
+	/// Child cache falls back to values of parent cache and never modifies it,
+	/// so one parent can be shared by several threads as long as it is not modified itself
 	DamageCache(DamageCache * parent) : parent(parent) {}
 
 	void cacheDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb);
@@ -137,11 +137,18 @@ std::optional<PossibleSpellcast> BattleEvaluator::findBestCreatureSpell(const CS
 				PossibleSpellcast ps;
 				ps.dest = target;
 				ps.spell = spell;
-				evaluateCreatureSpellcast(stack, ps);
 				possibleCasts.push_back(ps);
 			}
 
-			std::sort(possibleCasts.begin(), possibleCasts.end(), [&](const PossibleSpellcast & lhs, const PossibleSpellcast & rhs) { return lhs.value > rhs.value; });
+			// each cast is evaluated on its own hypothetic battle
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, possibleCasts.size()), [&](const tbb::blocked_range<size_t> & r)
+			{
+				for(auto i = r.begin(); i != r.end(); i++)
+					evaluateCreatureSpellcast(stack, possibleCasts[i]);
+			});
+
+			// keep order of potential targets for casts with equal value
+			std::stable_sort(possibleCasts.begin(), possibleCasts.end(), [&](const PossibleSpellcast & lhs, const PossibleSpellcast & rhs) { return lhs.value > rhs.value; });
 			if(!possibleCasts.empty() && possibleCasts.front().value > 0)
 			{
 				return possibleCasts.front();
@@ -683,8 +690,7 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 						return  !original || u->getMovementRange() != original->getMovementRange();
 					});
 
-				DamageCache safeCopy = damageCache;
-				DamageCache innerCache(&safeCopy);
+				DamageCache innerCache(&damageCache);
 
 				innerCache.buildDamageCache(state, side);
 
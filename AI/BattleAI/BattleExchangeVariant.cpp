@@ -10,6 +10,7 @@
 #include "StdInc.h"
 #include "BattleExchangeVariant.h"
 #include "../../lib/CStack.h"
+#include "tbb/parallel_for.h"
 
 AttackerValue::AttackerValue()
 	: value(0),
@@ -131,9 +132,9 @@ float BattleExchangeVariant::trackAttack(
 	std::shared_ptr<HypotheticBattle> hb,
 	bool evaluateOnly)
 {
-	const std::string cachingStringBlocksRetaliation = "type_BLOCKS_RETALIATION";
+	static const auto cachingKeyBlocksRetaliation = BonusCacheKey::type(BonusType::BLOCKS_RETALIATION);
 	static const auto selectorBlocksRetaliation = Selector::type()(BonusType::BLOCKS_RETALIATION);
-	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation, cachingStringBlocksRetaliation);
+	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation, cachingKeyBlocksRetaliation);
 
 	int64_t attackDamage = damageCache.getDamage(attacker.get(), defender.get(), hb);
 	float defenderDamageReduce = AttackPossibility::calculateDamageReduce(attacker.get(), defender.get(), attackDamage, damageCache, hb);
@@ -229,14 +230,16 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 
 		updateReachabilityMap(hbWaited);
 
-		for(auto & ap : targets.possibleAttacks)
+		auto scores = evaluateExchanges(targets, damageCache, hbWaited);
+
+		for(size_t i = 0; i < scores.size(); i++)
 		{
-			float score = evaluateExchange(ap, 0, targets, damageCache, hbWaited);
+			float score = scores[i];
 
 			if(score > result.score)
 			{
 				result.score = score;
-				result.bestAttack = ap;
+				result.bestAttack = targets.possibleAttacks[i];
 				result.wait = true;
 
 #if BATTLE_TRACE_LEVEL >= 1
@@ -261,15 +264,17 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 			return result; // lets wait
 	}
 
-	for(auto & ap : targets.possibleAttacks)
+	auto scores = evaluateExchanges(targets, damageCache, hb);
+
+	for(size_t i = 0; i < scores.size(); i++)
 	{
-		float score = evaluateExchange(ap, 0, targets, damageCache, hb);
+		float score = scores[i];
 		bool sameScoreButWaited = vstd::isAlmostEqual(score, result.score) && result.wait;
 
 		if(score > result.score || sameScoreButWaited)
 		{
 			result.score = score;
-			result.bestAttack = ap;
+			result.bestAttack = targets.possibleAttacks[i];
 			result.wait = false;
 
 #if BATTLE_TRACE_LEVEL >= 1
@@ -578,6 +583,33 @@ ReachabilityData BattleExchangeEvaluator::getExchangeUnits(
 	return result;
 }
 
+std::vector<float> BattleExchangeEvaluator::evaluateExchanges(
+	PotentialTargets & targets,
+	DamageCache & damageCache,
+	std::shared_ptr<HypotheticBattle> hb) const
+{
+	std::vector<float> scores(targets.possibleAttacks.size());
+
+	auto evaluateRange = [&](const tbb::blocked_range<size_t> & r)
+	{
+		for(auto i = r.begin(); i != r.end(); i++)
+		{
+			// every attack starts from same cache state, so score does not depend on evaluation order
+			DamageCache localCache(&damageCache);
+
+			scores[i] = evaluateExchange(targets.possibleAttacks[i], 0, targets, localCache, hb);
+		}
+	};
+
+#if BATTLE_TRACE_LEVEL >= 1
+	evaluateRange(tbb::blocked_range<size_t>(0, scores.size()));
+#else
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, scores.size()), evaluateRange);
+#endif
+
+	return scores;
+}
+
 float BattleExchangeEvaluator::evaluateExchange(
 	const AttackPossibility & ap,
 	uint8_t turn,
@@ -882,16 +914,18 @@ void BattleExchangeEvaluator::updateReachabilityMap(std::shared_ptr<HypotheticBa
 	const int TURN_DEPTH = 2;
 
 	turnOrder.clear();
+	unitsReachability.clear();
 
 	hb->battleGetTurnOrder(turnOrder, std::numeric_limits<int>::max(), TURN_DEPTH);
 
+	// served from reachability cache of hypothetic battle, which is shared with its forks until units move or die
 	for(auto turn : turnOrder)
 	{
 		for(auto u : turn)
 		{
-			if(!vstd::contains(reachabilityCache, u->unitId()))
+			if(!vstd::contains(unitsReachability, u->unitId()))
 			{
-				reachabilityCache[u->unitId()] = hb->getReachability(u);
+				unitsReachability[u->unitId()] = hb->getReachability(u);
 			}
 		}
 	}
@@ -926,10 +960,10 @@ std::vector<const battle::Unit *> BattleExchangeEvaluator::getOneTurnReachableUn
 			auto unitSpeed = unit->getMovementRange(turn);
 			auto radius = unitSpeed * (turn + 1);
 
-			auto reachabilityIter = reachabilityCache.find(unit->unitId());
-			assert(reachabilityIter != reachabilityCache.end()); // missing updateReachabilityMap call?
+			auto reachabilityIter = unitsReachability.find(unit->unitId());
+			assert(reachabilityIter != unitsReachability.end()); // missing updateReachabilityMap call?
 
-			ReachabilityInfo unitReachability = reachabilityIter != reachabilityCache.end() ? reachabilityIter->second : turnBattle.getReachability(unit);
+			ReachabilityInfo unitReachability = reachabilityIter != unitsReachability.end() ? reachabilityIter->second : turnBattle.getReachability(unit);
 
 			bool reachable = unitReachability.distances.at(hex) <= radius;
 
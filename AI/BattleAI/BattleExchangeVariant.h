@@ -128,7 +128,8 @@ class BattleExchangeEvaluator
 private:
 	std::shared_ptr<CBattleInfoCallback> cb;
 	std::shared_ptr<Environment> env;
-	std::map<uint32_t, ReachabilityInfo> reachabilityCache;
+	/// reachability of units in turn order of battle passed to last updateReachabilityMap call
+	std::map<uint32_t, ReachabilityInfo> unitsReachability;
 	std::map<BattleHex, std::vector<const battle::Unit *>> reachabilityMap;
 	std::vector<battle::Units> turnOrder;
 	float negativeEffectMultiplier;
@@ -146,6 +147,12 @@ private:
 
 	bool canBeHitThisTurn(const AttackPossibility & ap);
 
+	/// Scores every possible attack of active unit, attacks are evaluated in parallel
+	std::vector<float> evaluateExchanges(
+		PotentialTargets & targets,
+		DamageCache & damageCache,
+		std::shared_ptr<HypotheticBattle> hb) const;
+
 public:
 	BattleExchangeEvaluator(
 		std::shared_ptr<CBattleInfoCallback> cb,
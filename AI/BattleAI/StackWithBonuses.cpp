@@ -94,6 +94,26 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	summoned = info.summoned;
 }
 
+StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const StackWithBonuses & other)
+	: battle::CUnitState(),
+	bonusesToAdd(other.bonusesToAdd),
+	bonusesToUpdate(other.bonusesToUpdate),
+	bonusesToRemove(other.bonusesToRemove),
+	treeVersionLocal(other.treeVersionLocal),
+	origBearer(other.origBearer),
+	owner(Owner),
+	type(other.type),
+	baseAmount(other.baseAmount),
+	id(other.id),
+	side(other.side),
+	player(other.player),
+	slot(other.slot)
+{
+	localInit(Owner);
+
+	battle::CUnitState::operator=(other);
+}
+
 StackWithBonuses::~StackWithBonuses() = default;
 
 StackWithBonuses & StackWithBonuses::operator=(const battle::CUnitState & other)
@@ -133,10 +153,10 @@ SlotID StackWithBonuses::unitSlot() const
 }
 
 TConstBonusListPtr StackWithBonuses::getAllBonuses(const CSelector & selector, const CSelector & limit,
-	const std::string & cachingStr) const
+	const BonusCacheKey & cachingKey) const
 {
 	auto ret = std::make_shared<BonusList>();
-	TConstBonusListPtr originalList = origBearer->getAllBonuses(selector, limit, cachingStr);
+	TConstBonusListPtr originalList = origBearer->getAllBonuses(selector, limit, cachingKey);
 
 	vstd::copy_if(*originalList, std::back_inserter(*ret), [this](const std::shared_ptr<Bonus> & b)
 	{
@@ -172,7 +192,7 @@ TConstBonusListPtr StackWithBonuses::getAllBonuses(const CSelector & selector, c
 
 int64_t StackWithBonuses::getTreeVersion() const
 {
-	auto result = owner->getTreeVersion();
+	auto result = owner->getTreeVersion() + origBearer->getTreeVersion();
 
 	if(bonusesToAdd.empty() && bonusesToUpdate.empty() && bonusesToRemove.empty())
 		return result;
@@ -259,10 +279,35 @@ HypotheticBattle::HypotheticBattle(const Environment * ENV, Subject realBattle)
 
 	nextId = 0x00F00000;
 
+	if(auto forked = std::dynamic_pointer_cast<HypotheticBattle>(realBattle))
+	{
+		//share unit states with parent battle instead of proxying every query through it
+		parent = forked;
+		subject = forked->subject;
+		stackStates = forked->stackStates;
+
+		for(const auto & state : stackStates)
+			state.second->markShared();
+		bonusTreeVersion = forked->bonusTreeVersion;
+		nextId = forked->nextId;
+
+		boost::lock_guard<boost::mutex> lock(forked->reachabilityCacheMutex);
+		reachabilityCache = forked->reachabilityCache;
+		reachabilityCacheLayout = forked->reachabilityCacheLayout;
+	}
+}
+
+void HypotheticBattle::initServerCallback() const
+{
+	if(serverCallback)
+		return;
+
+	auto * self = const_cast<HypotheticBattle *>(this);
+
 	eventBus.reset(new events::EventBus());
 
-	localEnvironment.reset(new HypotheticEnvironment(this, env));
-	serverCallback.reset(new HypotheticServerCallback(this));
+	localEnvironment.reset(new HypotheticEnvironment(self, env));
+	serverCallback.reset(new HypotheticServerCallback(self));
 
 #if SCRIPTING_ENABLED
 	pool.reset(new scripting::PoolImpl(localEnvironment.get(), serverCallback.get()));
@@ -294,6 +339,10 @@ std::shared_ptr<StackWithBonuses> HypotheticBattle::getForUpdate(uint32_t id)
 	}
 	else
 	{
+		//state is shared with parent battle or with battle forked from this one, copy it before modification
+		if(!iter->second->ownedBy(this) || iter->second->isShared())
+			iter->second = std::make_shared<StackWithBonuses>(this, *iter->second);
+
 		return iter->second;
 	}
 }
@@ -352,11 +401,11 @@ void HypotheticBattle::nextTurn(uint32_t unitId)
 	unit->afterGetsTurn();
 }
 
-void HypotheticBattle::addUnit(uint32_t id, const JsonNode & data)
+void HypotheticBattle::addUnit(uint32_t id, const battle::UnitInfo & info)
 {
-	battle::UnitInfo info;
-	info.load(id, data);
-	auto newUnit = std::make_shared<StackWithBonuses>(this, info);
+	battle::UnitInfo newInfo = info;
+	newInfo.id = id;
+	auto newUnit = std::make_shared<StackWithBonuses>(this, newInfo);
 	stackStates[newUnit->unitId()] = newUnit;
 }
 
@@ -366,7 +415,7 @@ void HypotheticBattle::moveUnit(uint32_t id, BattleHex destination)
 	changed->position = destination;
 }
 
-void HypotheticBattle::setUnitState(uint32_t id, const JsonNode & data, int64_t healthDelta)
+void HypotheticBattle::setUnitState(uint32_t id, const battle::UnitStateSnapshot & data, int64_t healthDelta)
 {
 	std::shared_ptr<StackWithBonuses> changed = getForUpdate(id);
 
@@ -485,6 +534,36 @@ BattleLayout HypotheticBattle::getLayout() const
 	return subject->getBattle()->getLayout();
 }
 
+std::vector<uint64_t> HypotheticBattle::getUnitsLayout() const
+{
+	std::vector<uint64_t> layout;
+	layout.reserve(stackStates.size());
+
+	//obstacles and walls are never changed by hypothetic battle, units that are not in stackStates are same as in subject
+	for(const auto & [id, state] : stackStates)
+	{
+		uint64_t position = static_cast<uint16_t>(static_cast<si16>(state->getPosition()));
+		layout.push_back(static_cast<uint64_t>(id) << 32 | position << 2 | state->alive() << 1 | state->isGhost());
+	}
+
+	return layout;
+}
+
+ReachabilityCache * HypotheticBattle::getReachabilityCache() const
+{
+	auto layout = getUnitsLayout();
+
+	boost::lock_guard<boost::mutex> lock(reachabilityCacheMutex);
+
+	if(!reachabilityCache || layout != reachabilityCacheLayout)
+	{
+		reachabilityCache = std::make_shared<ReachabilityCache>();
+		reachabilityCacheLayout = std::move(layout);
+	}
+
+	return reachabilityCache.get();
+}
+
 int64_t HypotheticBattle::getTreeVersion() const
 {
 	return getBonusBearer()->getTreeVersion() + bonusTreeVersion;
@@ -493,12 +572,14 @@ int64_t HypotheticBattle::getTreeVersion() const
 #if SCRIPTING_ENABLED
 Pool * HypotheticBattle::getContextPool() const
 {
+	initServerCallback();
 	return pool.get();
 }
 #endif
 
 ServerCallback * HypotheticBattle::getServerCallback()
 {
+	initServerCallback();
 	return serverCallback.get();
 }
 
@@ -17,6 +17,7 @@
 #include "../../lib/bonuses/Bonus.h"
 #include "../../lib/battle/BattleProxy.h"
 #include "../../lib/battle/CUnitState.h"
+#include "../../lib/battle/ReachabilityCache.h"
 
 class HypotheticBattle;
 
@@ -75,6 +76,9 @@ public:
 
 	StackWithBonuses(const HypotheticBattle * Owner, const battle::UnitInfo & info);
 
+	/// Copies state of unit owned by another hypothetic battle
+	StackWithBonuses(const HypotheticBattle * Owner, const StackWithBonuses & other);
+
 	virtual ~StackWithBonuses();
 
 	StackWithBonuses & operator= (const battle::CUnitState & other);
@@ -91,7 +95,7 @@ public:
 
 	///IBonusBearer
 	TConstBonusListPtr getAllBonuses(const CSelector & selector, const CSelector & limit,
-		const std::string & cachingStr = "") const override;
+		const BonusCacheKey & cachingKey = {}) const override;
 
 	int64_t getTreeVersion() const override;
 
@@ -104,9 +108,27 @@ public:
 	void spendMana(ServerCallback * server, const int spellCost) const override;
 	std::string getDescription() const override;
 
+	bool ownedBy(const HypotheticBattle * battle) const
+	{
+		return owner == battle;
+	}
+
+	/// State is referenced by battle forked from its owner, so owner must copy it before modification too
+	void markShared() const
+	{
+		shared = true;
+	}
+
+	bool isShared() const
+	{
+		return shared;
+	}
+
 private:
 	const IBonusBearer * origBearer;
 	const HypotheticBattle * owner;
+	/// set by forks that may be created concurrently from the same battle
+	mutable std::atomic<bool> shared{false};
 
 	const CCreature * type;
 	ui32 baseAmount;
@@ -116,9 +138,17 @@ private:
 	SlotID slot;
 };
 
+/// Battle state used by AI to evaluate possible actions.
+/// Battle created from another hypothetic battle shares unit states with it and copies them on first write,
+/// so forking costs O(changed units) and lookups never go through chain of nested proxies.
+/// Both sides copy shared state on write, so battle may keep changing after fork without affecting its forks.
+/// Pointers returned by getForUpdate before fork still point to shared state and must not be used for modification after it
+/// Accessibility and reachability are cached per battle, fork starts with cache of battle it was forked from
+/// and drops it as soon as position or alive state of any of its changed units differs from the one cache was filled for
 class HypotheticBattle : public BattleProxy, public battle::IUnitEnvironment
 {
 public:
+	/// changed units, including ones shared with battle this battle was forked from
 	std::map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
 
 	const Environment * env;
@@ -139,8 +169,8 @@ public:
 	void nextRound() override;
 	void nextTurn(uint32_t unitId) override;
 
-	void addUnit(uint32_t id, const JsonNode & data) override;
-	void setUnitState(uint32_t id, const JsonNode & data, int64_t healthDelta) override;
+	void addUnit(uint32_t id, const battle::UnitInfo & info) override;
+	void setUnitState(uint32_t id, const battle::UnitStateSnapshot & data, int64_t healthDelta) override;
 	void moveUnit(uint32_t id, BattleHex destination) override;
 	void removeUnit(uint32_t id) override;
 	void updateUnit(uint32_t id, const JsonNode & data) override;
@@ -161,6 +191,7 @@ public:
 	std::vector<SpellID> getUsedSpells(BattleSide side) const override;
 	int3 getLocation() const override;
 	BattleLayout getLayout() const override;
+	ReachabilityCache * getReachabilityCache() const override;
 
 	int64_t getTreeVersion() const;
 
@@ -178,6 +209,7 @@ public:
 	ServerCallback * getServerCallback();
 
 private:
+	void initServerCallback() const;
 
 	class HypotheticServerCallback : public ServerCallback
 	{
@@ -223,8 +255,20 @@ private:
 	int32_t activeUnitId;
 	mutable uint32_t nextId;
 
-	std::unique_ptr<HypotheticServerCallback> serverCallback;
-	std::unique_ptr<HypotheticEnvironment> localEnvironment;
+	/// battle this battle was forked from, owns unit states that were not changed yet
+	std::shared_ptr<const HypotheticBattle> parent;
+
+	/// unit states may be changed directly through getForUpdate, so cache is validated against layout of changed units on every query
+	std::vector<uint64_t> getUnitsLayout() const;
+
+	/// shared with forks until layout of one of them changes, never invalidated in place
+	mutable std::shared_ptr<ReachabilityCache> reachabilityCache;
+	mutable std::vector<uint64_t> reachabilityCacheLayout;
+	mutable boost::mutex reachabilityCacheMutex;
+
+	/// created on first use, most of hypothetic battles are never used to apply spells
+	mutable std::unique_ptr<HypotheticServerCallback> serverCallback;
+	mutable std::unique_ptr<HypotheticEnvironment> localEnvironment;
 
 #if SCRIPTING_ENABLED
 	mutable std::shared_ptr<scripting::Pool> pool;
@@ -15,12 +15,14 @@
 #include "../AIGateway.h"
 #include "../Engine/Nullkiller.h"
 #include "../../../CCallback.h"
+#include "../../../lib/gameState/CGameState.h"
 #include "../../../lib/mapping/CMap.h"
 #include "../../../lib/mapObjects/MapObjects.h"
 #include "../../../lib/pathfinder/CPathfinder.h"
-#include "../../../lib/pathfinder/PathfinderUtil.h"
+#include "../../../lib/pathfinder/PathfinderAccessibility.h"
 #include "../../../lib/pathfinder/PathfinderOptions.h"
 #include "../../../lib/CPlayerState.h"
+#include "../../../lib/TerrainHandler.h"
 
 namespace NKAI
 {
@@ -120,7 +122,8 @@ void AINodeStorage::initialize(const PathfinderOptions & options, const CGameSta
 
 	//TODO: fix this code duplication with NodeStorage::initialize, problem is to keep `resetTile` inline
 	const PlayerColor fowPlayer = ai->playerID;
-	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(fowPlayer)->fogOfWarMap;
+	const auto accessibilityLayer = gs->getPathfinderAccessibility(playerID, fowPlayer);
+	const PathfinderAccessibility & tileAccessibility = *accessibilityLayer;
 	const int3 sizes = gs->getMapSize();
 
 	//Each thread gets different x, but an array of y located next to each other in memory
@@ -133,7 +136,6 @@ void AINodeStorage::initialize(const PathfinderOptions & options, const CGameSta
 		{
 			const bool useFlying = options.useFlying;
 			const bool useWaterWalking = options.useWaterWalking;
-			const PlayerColor player = playerID;
 
 			for(pos.x = r.begin(); pos.x != r.end(); ++pos.x)
 			{
@@ -145,17 +147,17 @@ void AINodeStorage::initialize(const PathfinderOptions & options, const CGameSta
 
 					if (tile.isWater())
 					{
-						resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
+						resetTile(pos, ELayer::SAIL, tileAccessibility.get(pos, ELayer::SAIL));
 						if (useFlying)
-							resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+							resetTile(pos, ELayer::AIR, tileAccessibility.get(pos, ELayer::AIR));
 						if (useWaterWalking)
-							resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
+							resetTile(pos, ELayer::WATER, tileAccessibility.get(pos, ELayer::WATER));
 					}
 					else
 					{
-						resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
+						resetTile(pos, ELayer::LAND, tileAccessibility.get(pos, ELayer::LAND));
 						if (useFlying)
-							resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+							resetTile(pos, ELayer::AIR, tileAccessibility.get(pos, ELayer::AIR));
 					}
 				}
 			}
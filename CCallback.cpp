@@ -389,6 +389,11 @@ std::shared_ptr<const CPathsInfo> CCallback::getPathsInfo(const CGHeroInstance *
 	return cl->getPathsInfo(h);
 }
 
+void CCallback::preparePathsInfo(const std::vector<const CGHeroInstance *> & heroes)
+{
+	cl->preparePathsInfo(heroes);
+}
+
 std::optional<PlayerColor> CCallback::getPlayerID() const
 {
 	return CBattleCallback::getPlayerID();
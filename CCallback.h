@@ -158,6 +158,7 @@ public:
 	virtual bool canMoveBetween(const int3 &a, const int3 &b);
 	virtual int3 getGuardingCreaturePosition(int3 tile);
 	virtual std::shared_ptr<const CPathsInfo> getPathsInfo(const CGHeroInstance * h);
+	virtual void preparePathsInfo(const std::vector<const CGHeroInstance *> & heroes); //calculates paths of several heroes at once, later getPathsInfo calls return them from cache
 
 	std::optional<PlayerColor> getPlayerID() const override;
 
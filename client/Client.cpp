@@ -224,6 +224,7 @@ void CClient::initMapHandler()
 	}
 
 	pathCache.clear();
+	outdatedPathCache.clear();
 }
 
 void CClient::initPlayerEnvironments()
@@ -510,6 +511,8 @@ void CClient::updatePath(const CGHeroInstance * hero)
 void CClient::invalidatePaths()
 {
 	boost::unique_lock<boost::mutex> pathLock(pathCacheMutex);
+	for(auto & entry : pathCache)
+		outdatedPathCache[entry.first] = std::move(entry.second);
 	pathCache.clear();
 }
 
@@ -520,6 +523,25 @@ vstd::RNG & CClient::getRandomGenerator()
 	throw std::runtime_error("Illegal access to random number generator from client code!");
 }
 
+std::shared_ptr<CPathsInfo> CClient::takePathsStorage(const CGHeroInstance * h)
+{
+	std::shared_ptr<CPathsInfo> paths;
+
+	// reuse outdated paths if nobody else holds them, pathfinder may repair them after single hero step
+	auto outdated = outdatedPathCache.find(h);
+	if(outdated != std::end(outdatedPathCache))
+	{
+		if(outdated->second.use_count() == 1)
+			paths = std::move(outdated->second);
+		outdatedPathCache.erase(outdated);
+	}
+
+	if(!paths)
+		paths = std::make_shared<CPathsInfo>(getMapSize(), h);
+
+	return paths;
+}
+
 std::shared_ptr<const CPathsInfo> CClient::getPathsInfo(const CGHeroInstance * h)
 {
 	assert(h);
@@ -529,7 +551,7 @@ std::shared_ptr<const CPathsInfo> CClient::getPathsInfo(const CGHeroInstance * h
 
 	if(iter == std::end(pathCache))
 	{
-		auto paths = std::make_shared<CPathsInfo>(getMapSize(), h);
+		std::shared_ptr<CPathsInfo> paths = takePathsStorage(h);
 
 		gs->calculatePaths(h, *paths.get());
 
@@ -542,6 +564,28 @@ std::shared_ptr<const CPathsInfo> CClient::getPathsInfo(const CGHeroInstance * h
 	}
 }
 
+void CClient::preparePathsInfo(const std::vector<const CGHeroInstance *> & heroes)
+{
+	boost::unique_lock<boost::mutex> pathLock(pathCacheMutex);
+
+	std::vector<std::shared_ptr<CPathsInfo>> missingPaths;
+	std::vector<CPathsInfo *> batch;
+
+	for(const auto * h : heroes)
+	{
+		assert(h);
+		if(pathCache.count(h))
+			continue;
+
+		missingPaths.push_back(takePathsStorage(h));
+		batch.push_back(missingPaths.back().get());
+		pathCache[h] = missingPaths.back();
+	}
+
+	if(!batch.empty())
+		gs->calculatePaths(batch);
+}
+
 #if SCRIPTING_ENABLED
 scripting::Pool * CClient::getGlobalContextPool() const
 {
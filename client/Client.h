@@ -153,6 +153,7 @@ public:
 	void updatePath(const ObjectInstanceID & heroID); // invalidatePaths and update displayed hero path 
 	void updatePath(const CGHeroInstance * hero);
 	std::shared_ptr<const CPathsInfo> getPathsInfo(const CGHeroInstance * h);
+	void preparePathsInfo(const std::vector<const CGHeroInstance *> & heroes); // calculates paths of all given heroes that are not cached yet in one parallel batch
 
 	friend class CCallback; //handling players actions
 	friend class CBattleCallback; //handling players actions
@@ -237,6 +238,9 @@ private:
 
 	mutable boost::mutex pathCacheMutex;
 	std::map<const CGHeroInstance *, std::shared_ptr<CPathsInfo>> pathCache;
+	std::map<const CGHeroInstance *, std::shared_ptr<CPathsInfo>> outdatedPathCache; // invalidated paths, may be repaired instead of full recalculation
+
+	std::shared_ptr<CPathsInfo> takePathsStorage(const CGHeroInstance * h); // outdated paths of hero if possible, new storage otherwise, pathCacheMutex must be locked
 
 	void reinitScripting();
 };
@@ -278,6 +278,13 @@ void AdventureMapShortcuts::endTurn()
 
 	if(settings["adventure"]["heroReminder"].Bool())
 	{
+		// paths of all heroes that may be checked below are calculated in parallel
+		std::vector<const CGHeroInstance *> heroesWithPaths;
+		for(auto hero : LOCPLINT->localState->getWanderingHeroes())
+			if(!LOCPLINT->localState->isHeroSleeping(hero) && hero->movementPointsRemaining() > 0 && LOCPLINT->localState->hasPath(hero))
+				heroesWithPaths.push_back(hero);
+		LOCPLINT->cb->preparePathsInfo(heroesWithPaths);
+
 		for(auto hero : LOCPLINT->localState->getWanderingHeroes())
 		{
 			if(!LOCPLINT->localState->isHeroSleeping(hero) && hero->movementPointsRemaining() > 0)
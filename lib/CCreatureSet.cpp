@@ -428,7 +428,10 @@ void CCreatureSet::setStackCount(const SlotID & slot, TQuantity count)
 	assert(hasStackAtSlot(slot));
 	assert(stacks[slot]->count + count > 0);
 	if (count > stacks[slot]->count)
+	{
 		stacks[slot]->experience = static_cast<TExpType>(stacks[slot]->experience * (count / static_cast<double>(stacks[slot]->count)));
+		stacks[slot]->nodeHasChanged();
+	}
 	stacks[slot]->count = count;
 	armyChanged();
 }
@@ -442,6 +445,7 @@ void CCreatureSet::setStackExp(const SlotID & slot, TExpType exp)
 {
 	assert(hasStackAtSlot(slot));
 	stacks[slot]->experience = exp;
+	stacks[slot]->nodeHasChanged();
 }
 
 void CCreatureSet::clearSlots()
@@ -747,6 +751,7 @@ void CStackInstance::giveStackExp(TExpType exp)
 	vstd::amin(exp, static_cast<TExpType>(maxExp)); //prevent exp overflow due to different types
 	vstd::amin(exp, (maxExp * VLC->creh->maxExpPerBattle[level])/100);
 	vstd::amin(experience += exp, maxExp); //can't get more exp than this limit
+	nodeHasChanged();
 }
 
 void CStackInstance::setType(const CreatureID & creID)
@@ -971,7 +976,10 @@ void CCommanderInstance::setAlive (bool Alive)
 void CCommanderInstance::giveStackExp (TExpType exp)
 {
 	if (alive)
+	{
 		experience += exp;
+		nodeHasChanged();
+	}
 }
 
 int CCommanderInstance::getExpRank() const
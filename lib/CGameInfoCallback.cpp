@@ -955,6 +955,16 @@ void CGameInfoCallback::calculatePaths( const CGHeroInstance *hero, CPathsInfo &
 	gs->calculatePaths(hero, out);
 }
 
+void CGameInfoCallback::calculatePaths(const std::vector<CPathsInfo *> & paths)
+{
+	gs->calculatePaths(paths);
+}
+
+void CGameInfoCallback::calculatePaths(const std::vector<std::shared_ptr<PathfinderConfig>> & configs)
+{
+	gs->calculatePaths(configs);
+}
+
 const CArtifactInstance * CGameInfoCallback::getArtInstance( ArtifactInstanceID aid ) const
 {
 	return gs->map->artInstances.at(aid.num);
@@ -124,15 +124,14 @@ std::vector<SpellID> CStack::activeSpells() const
 {
 	std::vector<SpellID> ret;
 
-	std::stringstream cachingStr;
-	cachingStr << "!type_" << vstd::to_underlying(BonusType::NONE) << "source_" << vstd::to_underlying(BonusSource::SPELL_EFFECT);
+	static const BonusCacheKey cachingKey("CStack::activeSpells");
 	CSelector selector = Selector::sourceType()(BonusSource::SPELL_EFFECT)
 						 .And(CSelector([](const Bonus * b)->bool
 	{
 		return b->type != BonusType::NONE && b->sid.as<SpellID>().toSpell() && !b->sid.as<SpellID>().toSpell()->isAdventure();
 	}));
 
-	TConstBonusListPtr spellEffects = getBonuses(selector, Selector::all, cachingStr.str());
+	TConstBonusListPtr spellEffects = getBonuses(selector, Selector::all, cachingKey);
 	for(const auto & it : *spellEffects)
 	{
 		if(!vstd::contains(ret, it->sid.as<SpellID>()))  //do not duplicate spells with multiple effects
@@ -236,7 +235,7 @@ void CStack::prepareAttacked(BattleStackAttacked & bsa, vstd::RNG & rand, const
 		}
 	}
 
-	customState->save(bsa.newState.data);
+	customState->save(bsa.newState.state);
 	bsa.newState.healthDelta = -bsa.damageAmount;
 	bsa.newState.id = customState->unitId();
 	bsa.newState.operation = UnitChanges::EOperation::RESET_STATE;
@@ -179,6 +179,10 @@ CGameState * CPrivilegedInfoCallback::gameState()
 	return gs;
 }
 
+/// Rough number of serialized pointers in saves of large maps, mostly bonuses and map objects
+/// Used to preallocate pointer tables of serializer instead of growing them gradually
+static constexpr size_t expectedSavedPointers = 1 << 16;
+
 void CPrivilegedInfoCallback::loadCommonState(CLoadFile & in)
 {
 	logGlobal->info("Loading lib part of game...");
@@ -198,6 +202,8 @@ void CPrivilegedInfoCallback::loadCommonState(CLoadFile & in)
 	in.serializer & activeMods;
 
 	logGlobal->info("\tReading gamestate");
+	in.serializer.loadedPointers.reserve(expectedSavedPointers);
+	in.serializer.loadedSharedPointers.reserve(expectedSavedPointers);
 	in.serializer & gs;
 }
 
@@ -214,6 +220,7 @@ void CPrivilegedInfoCallback::saveCommonState(CSaveFile & out) const
 	logGlobal->info("\tSaving mod list");
 	out.serializer & activeMods;
 	logGlobal->info("\tSaving gamestate");
+	out.serializer.savedPointers.reserve(expectedSavedPointers);
 	out.serializer & gs;
 }
 
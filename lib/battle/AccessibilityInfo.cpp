@@ -60,4 +60,19 @@ bool AccessibilityInfo::accessible(BattleHex tile, bool doubleWide, BattleSide s
 	return true;
 }
 
+BattleHexMask AccessibilityInfo::accessibleHexes(bool doubleWide, BattleSide side) const
+{
+	BattleHexMask ret;
+
+	for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+		if(tileAccessibleWithGate(hex, side))
+			ret.set(hex);
+
+	if(!doubleWide)
+		return ret;
+
+	//second hex of double wide stack is next one in hex numbering, see battle::Unit::occupiedHex
+	return ret & ret.shifted(side == BattleSide::ATTACKER ? 1 : -1);
+}
+
 VCMI_LIB_NAMESPACE_END
@@ -9,6 +9,7 @@
  */
 #pragma once
 #include "BattleHex.h"
+#include "BattleHexMask.h"
 #include "../GameConstants.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -40,6 +41,7 @@ struct DLL_LINKAGE AccessibilityInfo : TAccessibilityArray
 	public:
 		bool accessible(BattleHex tile, const battle::Unit * stack) const; //checks for both tiles if stack is double wide
 		bool accessible(BattleHex tile, bool doubleWide, BattleSide side) const; //checks for both tiles if stack is double wide
+		BattleHexMask accessibleHexes(bool doubleWide, BattleSide side) const; //all hexes for which accessible() is true
 	private:
 		bool tileAccessibleWithGate(BattleHex tile, BattleSide side) const;
 };
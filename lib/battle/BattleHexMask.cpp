@@ -0,0 +1,223 @@
+/*
+ * BattleHexMask.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "BattleHexMask.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace
+{
+	struct BattlefieldLayout
+	{
+		BattleHexMask all;
+		BattleHexMask available;
+		BattleHexMask evenRows;
+		BattleHexMask oddRows;
+		std::array<BattleHexMask, GameConstants::BFIELD_SIZE> neighbours;
+
+		BattlefieldLayout()
+		{
+			for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+			{
+				BattleHex tile(hex);
+
+				all.set(tile);
+
+				if(tile.isAvailable())
+					available.set(tile);
+
+				if(tile.getY() % 2)
+					oddRows.set(tile);
+				else
+					evenRows.set(tile);
+
+				for(auto neighbour : tile.neighbouringTiles())
+					neighbours[hex].set(neighbour);
+			}
+		}
+	};
+
+	const BattlefieldLayout & layout()
+	{
+		static const BattlefieldLayout instance;
+		return instance;
+	}
+}
+
+int BattleHexMask::countTrailingZeros(uint64_t word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+const BattleHexMask & BattleHexMask::all()
+{
+	return layout().all;
+}
+
+const BattleHexMask & BattleHexMask::neighbours(BattleHex hex)
+{
+	assert(hex.isValid());
+	return layout().neighbours[hex.hex];
+}
+
+void BattleHexMask::set(BattleHex hex)
+{
+	assert(hex.isValid());
+	words[hex.hex / WORD_BITS] |= uint64_t(1) << (hex.hex % WORD_BITS);
+}
+
+void BattleHexMask::reset(BattleHex hex)
+{
+	assert(hex.isValid());
+	words[hex.hex / WORD_BITS] &= ~(uint64_t(1) << (hex.hex % WORD_BITS));
+}
+
+bool BattleHexMask::test(BattleHex hex) const
+{
+	if(!hex.isValid())
+		return false;
+
+	return (words[hex.hex / WORD_BITS] >> (hex.hex % WORD_BITS)) & 1;
+}
+
+bool BattleHexMask::empty() const
+{
+	for(auto word : words)
+		if(word)
+			return false;
+
+	return true;
+}
+
+size_t BattleHexMask::count() const
+{
+	size_t ret = 0;
+
+	for(auto word : words)
+		ret += std::bitset<WORD_BITS>(word).count();
+
+	return ret;
+}
+
+BattleHex BattleHexMask::first() const
+{
+	for(int wordIndex = 0; wordIndex < WORDS; wordIndex++)
+		if(words[wordIndex])
+			return BattleHex(wordIndex * WORD_BITS + countTrailingZeros(words[wordIndex]));
+
+	return BattleHex::INVALID;
+}
+
+BattleHexMask BattleHexMask::shifted(int offset) const
+{
+	BattleHexMask ret;
+
+	int wordShift = std::abs(offset) / WORD_BITS;
+	int bitShift = std::abs(offset) % WORD_BITS;
+
+	if(offset >= 0)
+	{
+		for(int i = WORDS - 1; i >= wordShift; i--)
+		{
+			uint64_t value = words[i - wordShift] << bitShift;
+			if(bitShift && i - wordShift > 0)
+				value |= words[i - wordShift - 1] >> (WORD_BITS - bitShift);
+			ret.words[i] = value;
+		}
+	}
+	else
+	{
+		for(int i = 0; i + wordShift < WORDS; i++)
+		{
+			uint64_t value = words[i + wordShift] >> bitShift;
+			if(bitShift && i + wordShift + 1 < WORDS)
+				value |= words[i + wordShift + 1] << (WORD_BITS - bitShift);
+			ret.words[i] = value;
+		}
+	}
+
+	return ret & all();
+}
+
+BattleHexMask BattleHexMask::dilated() const
+{
+	// left and right neighbours are in same row, other ones depend on row parity, see BattleHex::moveInDirection
+	// shifts that wrap around a row can only land in first or last column, which are never neighbours
+	const auto & l = layout();
+
+	BattleHexMask ret;
+	ret |= shifted(1);
+	ret |= shifted(-1);
+	ret |= shifted(GameConstants::BFIELD_WIDTH);
+	ret |= shifted(-GameConstants::BFIELD_WIDTH);
+	ret |= (*this & l.evenRows).shifted(GameConstants::BFIELD_WIDTH + 1);
+	ret |= (*this & l.evenRows).shifted(-GameConstants::BFIELD_WIDTH + 1);
+	ret |= (*this & l.oddRows).shifted(GameConstants::BFIELD_WIDTH - 1);
+	ret |= (*this & l.oddRows).shifted(-GameConstants::BFIELD_WIDTH - 1);
+	return ret & l.available;
+}
+
+BattleHexMask BattleHexMask::operator&(const BattleHexMask & other) const
+{
+	BattleHexMask ret = *this;
+	ret &= other;
+	return ret;
+}
+
+BattleHexMask BattleHexMask::operator|(const BattleHexMask & other) const
+{
+	BattleHexMask ret = *this;
+	ret |= other;
+	return ret;
+}
+
+BattleHexMask BattleHexMask::operator~() const
+{
+	BattleHexMask ret;
+
+	for(int i = 0; i < WORDS; i++)
+		ret.words[i] = ~words[i] & all().words[i];
+
+	return ret;
+}
+
+BattleHexMask & BattleHexMask::operator&=(const BattleHexMask & other)
+{
+	for(int i = 0; i < WORDS; i++)
+		words[i] &= other.words[i];
+
+	return *this;
+}
+
+BattleHexMask & BattleHexMask::operator|=(const BattleHexMask & other)
+{
+	for(int i = 0; i < WORDS; i++)
+		words[i] |= other.words[i];
+
+	return *this;
+}
+
+bool BattleHexMask::operator==(const BattleHexMask & other) const
+{
+	return words == other.words;
+}
+
+bool BattleHexMask::operator!=(const BattleHexMask & other) const
+{
+	return words != other.words;
+}
+
+VCMI_LIB_NAMESPACE_END
@@ -0,0 +1,77 @@
+/*
+ * BattleHexMask.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "BattleHex.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Set of battlefield hexes stored as one bit per hex.
+/// Whole battlefield of 187 hexes fits into three 64-bit words (192 bits), so set operations and neighbour expansion are a handful of word operations.
+class DLL_LINKAGE BattleHexMask
+{
+public:
+	static constexpr int WORD_BITS = 64;
+	static constexpr int WORDS = (GameConstants::BFIELD_SIZE + WORD_BITS - 1) / WORD_BITS;
+
+	BattleHexMask() = default;
+
+	/// Mask with every valid battlefield hex set
+	static const BattleHexMask & all();
+	/// Precomputed mask of neighbours of given hex, same as BattleHex::neighbouringTiles()
+	static const BattleHexMask & neighbours(BattleHex hex);
+
+	void set(BattleHex hex);
+	void reset(BattleHex hex);
+	bool test(BattleHex hex) const;
+
+	bool empty() const;
+	size_t count() const;
+
+	/// Lowest hex in the set, BattleHex::INVALID if set is empty
+	BattleHex first() const;
+
+	/// Moves every hex by offset in hex numbering. Hexes moved outside of battlefield are dropped, rows are not respected
+	BattleHexMask shifted(int offset) const;
+
+	/// All hexes adjacent to any hex of this set, side columns excluded as in BattleHex::neighbouringTiles()
+	BattleHexMask dilated() const;
+
+	BattleHexMask operator&(const BattleHexMask & other) const;
+	BattleHexMask operator|(const BattleHexMask & other) const;
+	BattleHexMask operator~() const;
+	BattleHexMask & operator&=(const BattleHexMask & other);
+	BattleHexMask & operator|=(const BattleHexMask & other);
+	bool operator==(const BattleHexMask & other) const;
+	bool operator!=(const BattleHexMask & other) const;
+
+	/// Calls handler for every hex of the set in ascending order
+	template<typename Handler>
+	void forEach(const Handler & handler) const
+	{
+		for(int wordIndex = 0; wordIndex < WORDS; wordIndex++)
+		{
+			uint64_t word = words[wordIndex];
+
+			while(word)
+			{
+				handler(BattleHex(wordIndex * WORD_BITS + countTrailingZeros(word)));
+				word &= word - 1;
+			}
+		}
+	}
+
+private:
+	static int countTrailingZeros(uint64_t word);
+
+	std::array<uint64_t, WORDS> words{};
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -433,6 +433,9 @@ BattleInfo * BattleInfo::setupBattle(const int3 & tile, TerrainId terrain, const
 			currentBattle->tacticDistance = 0;
 	}
 
+	//obstacles and stacks above were placed directly, drop anything cached while placing them
+	currentBattle->reachabilityCache.invalidate();
+
 	return currentBattle;
 }
 
@@ -500,6 +503,11 @@ std::optional<PlayerColor> BattleInfo::getPlayerID() const
 	return std::nullopt;
 }
 
+ReachabilityCache * BattleInfo::getReachabilityCache() const
+{
+	return &reachabilityCache;
+}
+
 BattleInfo::~BattleInfo()
 {
 	for (auto & elem : stacks)
@@ -653,6 +661,8 @@ void BattleInfo::nextRound()
 
 	for(auto & obst : obstacles)
 		obst->battleTurnPassed();
+
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::nextTurn(uint32_t unitId)
@@ -667,19 +677,18 @@ void BattleInfo::nextTurn(uint32_t unitId)
 	st->afterGetsTurn();
 }
 
-void BattleInfo::addUnit(uint32_t id, const JsonNode & data)
+void BattleInfo::addUnit(uint32_t id, const battle::UnitInfo & info)
 {
-	battle::UnitInfo info;
-	info.load(id, data);
 	CStackBasicDescriptor base(info.type, info.count);
 
 	PlayerColor owner = getSidePlayer(info.side);
 
-	auto * ret = new CStack(&base, owner, info.id, info.side, SlotID::SUMMONED_SLOT_PLACEHOLDER);
+	auto * ret = new CStack(&base, owner, id, info.side, SlotID::SUMMONED_SLOT_PLACEHOLDER);
 	ret->initialPosition = info.position;
 	stacks.push_back(ret);
 	ret->localInit(this);
 	ret->summoned = info.summoned;
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::moveUnit(uint32_t id, BattleHex destination)
@@ -691,12 +700,13 @@ void BattleInfo::moveUnit(uint32_t id, BattleHex destination)
 		return;
 	}
 	sta->position = destination;
-	//Bonuses can be limited by unit placement, so, change tree version 
+	reachabilityCache.invalidate();
+	//Bonuses can be limited by unit placement, so, change node version
 	//to force updating a bonus. TODO: update version only when such bonuses are present
-	CBonusSystemNode::treeHasChanged();
+	sta->nodeHasChanged();
 }
 
-void BattleInfo::setUnitState(uint32_t id, const JsonNode & data, int64_t healthDelta)
+void BattleInfo::setUnitState(uint32_t id, const battle::UnitStateSnapshot & data, int64_t healthDelta)
 {
 	CStack * changedStack = getStack(id, false);
 	if(!changedStack)
@@ -761,6 +771,8 @@ void BattleInfo::setUnitState(uint32_t id, const JsonNode & data, int64_t health
 				s->cloneID = -1;
 		}
 	}
+
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::removeUnit(uint32_t id)
@@ -802,6 +814,8 @@ void BattleInfo::removeUnit(uint32_t id)
 
 		ids.erase(toRemoveId);
 	}
+
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::updateUnit(uint32_t id, const JsonNode & data)
@@ -890,13 +904,20 @@ void BattleInfo::addOrUpdateUnitBonus(CStack * sta, const Bonus & value, bool fo
 				stackBonus->turnsRemain = std::max(stackBonus->turnsRemain, value.turnsRemain);
 			}
 		}
-		CBonusSystemNode::treeHasChanged();
+		sta->nodeHasChanged();
 	}
 }
 
 void BattleInfo::setWallState(EWallPart partOfWall, EWallState state)
 {
 	si.wallState[partOfWall] = state;
+	reachabilityCache.invalidate();
+}
+
+void BattleInfo::setGateState(EGateState state)
+{
+	si.gateState = state;
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::addObstacle(const ObstacleChanges & changes)
@@ -904,6 +925,7 @@ void BattleInfo::addObstacle(const ObstacleChanges & changes)
 	auto obstacle = std::make_shared<SpellCreatedObstacle>();
 	obstacle->fromInfo(changes);
 	obstacles.push_back(obstacle);
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::updateObstacle(const ObstacleChanges& changes)
@@ -924,6 +946,7 @@ void BattleInfo::updateObstacle(const ObstacleChanges& changes)
 			break;
 		}
 	}
+	reachabilityCache.invalidate();
 }
 
 void BattleInfo::removeObstacle(uint32_t id)
@@ -936,6 +959,7 @@ void BattleInfo::removeObstacle(uint32_t id)
 			break;
 		}
 	}
+	reachabilityCache.invalidate();
 }
 
 CArmedInstance * BattleInfo::battleGetArmyObject(BattleSide side) const
@@ -13,6 +13,7 @@
 #include "../bonuses/CBonusSystemNode.h"
 #include "CBattleInfoCallback.h"
 #include "IBattleState.h"
+#include "ReachabilityCache.h"
 #include "SiegeInfo.h"
 #include "SideInBattle.h"
 
@@ -28,6 +29,7 @@ class DLL_LINKAGE BattleInfo : public CBonusSystemNode, public CBattleInfoCallba
 {
 	BattleSideArray<SideInBattle> sides; //sides[0] - attacker, sides[1] - defender
 	std::unique_ptr<BattleLayout> layout;
+	mutable ReachabilityCache reachabilityCache;
 public:
 	BattleID battleID = BattleID(0);
 
@@ -114,15 +116,17 @@ public:
 
 	std::vector<SpellID> getUsedSpells(BattleSide side) const override;
 
+	ReachabilityCache * getReachabilityCache() const override;
+
 	//////////////////////////////////////////////////////////////////////////
 	// IBattleState
 
 	void nextRound() override;
 	void nextTurn(uint32_t unitId) override;
 
-	void addUnit(uint32_t id, const JsonNode & data) override;
+	void addUnit(uint32_t id, const battle::UnitInfo & info) override;
 	void moveUnit(uint32_t id, BattleHex destination) override;
-	void setUnitState(uint32_t id, const JsonNode & data, int64_t healthDelta) override;
+	void setUnitState(uint32_t id, const battle::UnitStateSnapshot & data, int64_t healthDelta) override;
 	void removeUnit(uint32_t id) override;
 	void updateUnit(uint32_t id, const JsonNode & data) override;
 
@@ -131,6 +135,7 @@ public:
 	void removeUnitBonus(uint32_t id, const std::vector<Bonus> & bonus) override;
 
 	void setWallState(EWallPart partOfWall, EWallState state) override;
+	void setGateState(EGateState state);
 
 	void addObstacle(const ObstacleChanges & changes) override;
 	void updateObstacle(const ObstacleChanges& changes) override;
@@ -19,6 +19,7 @@
 #include "DamageCalculator.h"
 #include "IGameSettings.h"
 #include "PossiblePlayerBattleAction.h"
+#include "ReachabilityCache.h"
 #include "../entities/building/TownFortifications.h"
 #include "../spells/ObstacleCasterProxy.h"
 #include "../spells/ISpellMechanics.h"
@@ -242,10 +243,10 @@ bool CBattleInfoCallback::battleHasWallPenalty(const IBonusBearer * shooter, Bat
 	if(battleGetFortifications().wallsHealth == 0)
 		return false;
 
-	const std::string cachingStrNoWallPenalty = "type_NO_WALL_PENALTY";
+	static const auto cachingKeyNoWallPenalty = BonusCacheKey::type(BonusType::NO_WALL_PENALTY);
 	static const auto selectorNoWallPenalty = Selector::type()(BonusType::NO_WALL_PENALTY);
 
-	if(shooter->hasBonus(selectorNoWallPenalty, cachingStrNoWallPenalty))
+	if(shooter->hasBonus(selectorNoWallPenalty, cachingKeyNoWallPenalty))
 		return false;
 
 	const auto shooterOutsideWalls = shooterPosition < lineToWallHex(shooterPosition.getY());
@@ -963,6 +964,25 @@ bool CBattleInfoCallback::handleObstacleTriggersForUnit(SpellCastEnvironment & s
 }
 
 AccessibilityInfo CBattleInfoCallback::getAccessibility() const
+{
+	auto * cache = getBattle() ? getBattle()->getReachabilityCache() : nullptr;
+
+	if(!cache)
+		return computeAccessibility();
+
+	// hidden obstacles are filtered by side of the caller, so it is part of cache key
+	auto viewer = battleGetMySide();
+	auto version = cache->getStateVersion();
+
+	if(auto cached = cache->getAccessibility(viewer))
+		return *cached;
+
+	auto ret = computeAccessibility();
+	cache->setAccessibility(viewer, ret, version);
+	return ret;
+}
+
+AccessibilityInfo CBattleInfoCallback::computeAccessibility() const
 {
 	AccessibilityInfo ret;
 	ret.fill(EAccessibility::ACCESSIBLE);
@@ -1071,87 +1091,101 @@ ReachabilityInfo CBattleInfoCallback::makeBFS(const AccessibilityInfo &accessibi
 	if(!params.startPosition.isValid()) //if got call for arrow turrets
 		return ret;
 
-	const std::set<BattleHex> obstacles = getStoppers(params.perspective);
-	auto checkParams = params;
-	checkParams.ignoreKnownAccessible = true; //Ignore starting hexes obstacles
-
-	std::queue<BattleHex> hexq; //bfs queue
+	//walking stack can't step past the obstacles
+	const BattleHexMask expandable = ~getStopperPositions(params);
+	const BattleHexMask accessible = accessibility.accessibleHexes(params.doubleWide, params.side);
 
-	//first element
-	hexq.push(params.startPosition);
 	ret.distances[params.startPosition] = 0;
 
-	std::array<bool, GameConstants::BFIELD_SIZE> accessibleCache{};
-	for(int hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
-		accessibleCache[hex] = accessibility.accessible(hex, params.doubleWide, params.side);
-
-	while(!hexq.empty()) //bfs loop
+	if(params.bypassEnemyStacks && !params.destructibleEnemyTurns.empty())
 	{
-		const BattleHex curHex = hexq.front();
-		hexq.pop();
+		//moving through enemy costs additional turns, so distances are not uniform and plain bfs queue is needed
+		std::array<ui8, GameConstants::BFIELD_SIZE> additionalCost{};
+		for(const auto & enemy : params.destructibleEnemyTurns)
+			if(enemy.first.isValid())
+				additionalCost[enemy.first.hex] = enemy.second;
 
-		//walking stack can't step past the obstacles
-		if(isInObstacle(curHex, obstacles, checkParams))
-			continue;
-
-		const int costToNeighbour = ret.distances.at(curHex.hex) + 1;
+		std::queue<BattleHex> hexq; //bfs queue
+		hexq.push(params.startPosition);
 
-		for(BattleHex neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
+		while(!hexq.empty()) //bfs loop
 		{
-			if(neighbour.isValid())
-			{
-				auto additionalCost = 0;
+			const BattleHex curHex = hexq.front();
+			hexq.pop();
 
-				if(params.bypassEnemyStacks)
-				{
-					auto enemyToBypass = params.destructibleEnemyTurns.find(neighbour);
+			if(!expandable.test(curHex))
+				continue;
 
-					if(enemyToBypass != params.destructibleEnemyTurns.end())
-					{
-						additionalCost = enemyToBypass->second;
-					}
-				}
+			const int costToNeighbour = ret.distances.at(curHex.hex) + 1;
+
+			for(BattleHex neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
+			{
+				if(!neighbour.isValid() || !accessible.test(neighbour))
+					continue;
 
+				const int cost = costToNeighbour + additionalCost[neighbour.hex];
 				const int costFoundSoFar = ret.distances[neighbour.hex];
 
-				if(accessibleCache[neighbour.hex] && costToNeighbour + additionalCost < costFoundSoFar)
+				if(cost < costFoundSoFar)
 				{
 					hexq.push(neighbour);
-					ret.distances[neighbour.hex] = costToNeighbour + additionalCost;
+					ret.distances[neighbour.hex] = cost;
 					ret.predecessors[neighbour.hex] = curHex;
 				}
 			}
 		}
+
+		return ret;
+	}
+
+	//every step costs the same, so each bfs layer is dilation of previous one
+	BattleHexMask reached;
+	reached.set(params.startPosition);
+	BattleHexMask layer = reached;
+
+	for(uint32_t distance = 1;; distance++)
+	{
+		const BattleHexMask expanded = layer & expandable;
+
+		layer = expanded.dilated() & accessible & ~reached;
+		if(layer.empty())
+			break;
+
+		reached |= layer;
+		layer.forEach([&](BattleHex hex)
+		{
+			//start hex in side column is not neighbour of its own neighbours, see BattleHex::neighbouringTiles
+			BattleHexMask sources = BattleHexMask::neighbours(hex) & expanded;
+
+			ret.distances[hex.hex] = distance;
+			ret.predecessors[hex.hex] = sources.empty() ? params.startPosition : sources.first();
+		});
 	}
 
 	return ret;
 }
 
-bool CBattleInfoCallback::isInObstacle(
-	BattleHex hex,
-	const std::set<BattleHex> & obstacles,
-	const ReachabilityInfo::Parameters & params) const
+BattleHexMask CBattleInfoCallback::getStopperPositions(const ReachabilityInfo::Parameters & params) const
 {
-	auto occupiedHexes = battle::Unit::getHexes(hex, params.doubleWide, params.side);
+	BattleHexMask stoppers;
 
-	for(auto occupiedHex : occupiedHexes)
+	for(auto hex : getStoppers(params.perspective))
 	{
-		if(params.ignoreKnownAccessible && vstd::contains(params.knownAccessible, occupiedHex))
+		//obstacles under starting position are ignored
+		if(!hex.isValid() || vstd::contains(params.knownAccessible, hex))
 			continue;
 
-		if(vstd::contains(obstacles, occupiedHex))
-		{
-			if(occupiedHex == BattleHex::GATE_BRIDGE)
-			{
-				if(battleGetGateState() != EGateState::DESTROYED && params.side == BattleSide::ATTACKER)
-					return true;
-			}
-			else
-				return true;
-		}
+		if(hex == BattleHex::GATE_BRIDGE && (battleGetGateState() == EGateState::DESTROYED || params.side != BattleSide::ATTACKER))
+			continue;
+
+		stoppers.set(hex);
 	}
 
-	return false;
+	if(!params.doubleWide)
+		return stoppers;
+
+	//double wide stack stops if any of its hexes is in obstacle, second hex is next one in hex numbering
+	return stoppers | stoppers.shifted(params.side == BattleSide::ATTACKER ? 1 : -1);
 }
 
 std::set<BattleHex> CBattleInfoCallback::getStoppers(BattleSide whichSidePerspective) const
@@ -1288,6 +1322,24 @@ ReachabilityInfo CBattleInfoCallback::getReachability(const battle::Unit * unit)
 }
 
 ReachabilityInfo CBattleInfoCallback::getReachability(const ReachabilityInfo::Parameters &params) const
+{
+	auto * cache = getBattle() ? getBattle()->getReachabilityCache() : nullptr;
+
+	if(!cache || !ReachabilityCache::isCacheable(params))
+		return computeReachability(params);
+
+	auto viewer = battleGetMySide();
+	auto version = cache->getStateVersion();
+
+	if(auto cached = cache->getReachability(viewer, params))
+		return *cached;
+
+	auto ret = computeReachability(params);
+	cache->setReachability(viewer, params, ret, version);
+	return ret;
+}
+
+ReachabilityInfo CBattleInfoCallback::computeReachability(const ReachabilityInfo::Parameters &params) const
 {
 	if(params.flying)
 		return getFlyingReachability(params);
@@ -1605,10 +1657,10 @@ bool CBattleInfoCallback::battleHasDistancePenalty(const IBonusBearer * shooter,
 {
 	RETURN_IF_NOT_BATTLE(false);
 
-	const std::string cachingStrNoDistancePenalty = "type_NO_DISTANCE_PENALTY";
+	static const auto cachingKeyNoDistancePenalty = BonusCacheKey::type(BonusType::NO_DISTANCE_PENALTY);
 	static const auto selectorNoDistancePenalty = Selector::type()(BonusType::NO_DISTANCE_PENALTY);
 
-	if(shooter->hasBonus(selectorNoDistancePenalty, cachingStrNoDistancePenalty))
+	if(shooter->hasBonus(selectorNoDistancePenalty, cachingKeyNoDistancePenalty))
 		return false;
 
 	if(const auto * target = battleGetUnitByPos(destHex, true))
@@ -1800,10 +1852,9 @@ SpellID CBattleInfoCallback::getRandomBeneficialSpell(vstd::RNG & rand, const ba
 
 	for(const SpellID& spellID : allPossibleSpells)
 	{
-		std::stringstream cachingStr;
-		cachingStr << "source_" << vstd::to_underlying(BonusSource::SPELL_EFFECT) << "id_" << spellID.num;
+		const auto cachingKey = BonusCacheKey::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID));
 
-		if(subject->hasBonus(Selector::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID)), Selector::all, cachingStr.str()))
+		if(subject->hasBonus(Selector::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID)), Selector::all, cachingKey))
 			continue;
 
 		auto spellPtr = spellID.toSpell();
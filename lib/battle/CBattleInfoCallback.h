@@ -167,9 +167,11 @@ public:
 
 	BattleHex getAvailableHex(const CreatureID & creID, BattleSide side, int initialPos = -1) const; //find place for adding new stack
 protected:
+	AccessibilityInfo computeAccessibility() const;
+	ReachabilityInfo computeReachability(const ReachabilityInfo::Parameters & params) const;
 	ReachabilityInfo getFlyingReachability(const ReachabilityInfo::Parameters & params) const;
 	ReachabilityInfo makeBFS(const AccessibilityInfo & accessibility, const ReachabilityInfo::Parameters & params) const;
-	bool isInObstacle(BattleHex hex, const std::set<BattleHex> & obstacles, const ReachabilityInfo::Parameters & params) const;
+	BattleHexMask getStopperPositions(const ReachabilityInfo::Parameters & params) const; //positions where walking stack has to stop
 	std::set<BattleHex> getStoppers(BattleSide whichSidePerspective) const; //get hexes with stopping obstacles (quicksands)
 };
 
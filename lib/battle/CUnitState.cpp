@@ -15,9 +15,6 @@
 
 #include "../CCreatureHandler.h"
 
-#include "../serializer/JsonDeserializer.h"
-#include "../serializer/JsonSerializer.h"
-
 VCMI_LIB_NAMESPACE_BEGIN
 
 namespace battle
@@ -77,9 +74,14 @@ void CAmmo::use(int32_t amount)
 		used += amount;
 }
 
-void CAmmo::serializeJson(JsonSerializeFormat & handler)
+void CAmmo::save(UnitStateSnapshot::Ammo & data) const
+{
+	data.used = used;
+}
+
+void CAmmo::load(const UnitStateSnapshot::Ammo & data)
 {
-	handler.serializeInt("used", used, 0);
+	used = data.used;
 }
 
 ///CShots
@@ -129,6 +131,23 @@ CRetaliations::CRetaliations(const battle::Unit * Owner)
 {
 }
 
+CRetaliations::CRetaliations(const CRetaliations & other):
+	CAmmo(other),
+	totalCache(other.totalCache.load()),
+	noRetaliation(other.noRetaliation),
+	unlimited(other.unlimited)
+{
+}
+
+CRetaliations & CRetaliations::operator=(const CRetaliations & other)
+{
+	CAmmo::operator=(other);
+	totalCache = other.totalCache.load();
+	noRetaliation = other.noRetaliation;
+	unlimited = other.unlimited;
+	return *this;
+}
+
 bool CRetaliations::isLimited() const
 {
 	return !unlimited.getHasBonus() || noRetaliation.getHasBonus();
@@ -141,8 +160,11 @@ int32_t CRetaliations::total() const
 
 	//after dispel bonus should remain during current round
 	int32_t val = 1 + totalProxy->totalValue();
-	vstd::amax(totalCache, val);
-	return totalCache;
+	int32_t cached = totalCache;
+	while(cached < val && !totalCache.compare_exchange_weak(cached, val))
+	{
+	}
+	return std::max(cached, val);
 }
 
 void CRetaliations::reset()
@@ -151,11 +173,17 @@ void CRetaliations::reset()
 	totalCache = 0;
 }
 
-void CRetaliations::serializeJson(JsonSerializeFormat & handler)
+void CRetaliations::save(UnitStateSnapshot::Ammo & data) const
 {
-	CAmmo::serializeJson(handler);
+	CAmmo::save(data);
 	//we may be serialized in the middle of turn
-	handler.serializeInt("totalCache", totalCache, 0);
+	data.totalCache = totalCache;
+}
+
+void CRetaliations::load(const UnitStateSnapshot::Ammo & data)
+{
+	CAmmo::load(data);
+	totalCache = data.totalCache;
 }
 
 ///CHealth
@@ -314,11 +342,18 @@ void CHealth::takeResurrected()
 	}
 }
 
-void CHealth::serializeJson(JsonSerializeFormat & handler)
+void CHealth::save(UnitStateSnapshot::Health & data) const
+{
+	data.firstHPleft = firstHPleft;
+	data.fullUnits = fullUnits;
+	data.resurrected = resurrected;
+}
+
+void CHealth::load(const UnitStateSnapshot::Health & data)
 {
-	handler.serializeInt("firstHPleft", firstHPleft, 0);
-	handler.serializeInt("fullUnits", fullUnits, 0);
-	handler.serializeInt("resurrected", resurrected, 0);
+	firstHPleft = data.firstHPleft;
+	fullUnits = data.fullUnits;
+	resurrected = data.resurrected;
 }
 
 ///CUnitState
@@ -742,32 +777,6 @@ std::shared_ptr<CUnitState> CUnitState::acquireState() const
 	return ret;
 }
 
-void CUnitState::serializeJson(JsonSerializeFormat & handler)
-{
-	handler.serializeBool("cloned", cloned);
-	handler.serializeBool("defending", defending);
-	handler.serializeBool("defendingAnim", defendingAnim);
-	handler.serializeBool("drainedMana", drainedMana);
-	handler.serializeBool("fear", fear);
-	handler.serializeBool("hadMorale", hadMorale);
-	handler.serializeBool("castSpellThisTurn", castSpellThisTurn);
-	handler.serializeBool("ghost", ghost);
-	handler.serializeBool("ghostPending", ghostPending);
-	handler.serializeBool("moved", movedThisRound);
-	handler.serializeBool("summoned", summoned);
-	handler.serializeBool("waiting", waiting);
-	handler.serializeBool("waitedThisTurn", waitedThisTurn);
-
-	handler.serializeStruct("casts", casts);
-	handler.serializeStruct("counterAttacks", counterAttacks);
-	handler.serializeStruct("health", health);
-	handler.serializeStruct("shots", shots);
-
-	handler.serializeInt("cloneID", cloneID);
-
-	handler.serializeInt("position", position);
-}
-
 void CUnitState::localInit(const IUnitEnvironment * env_)
 {
 	env = env_;
@@ -803,20 +812,56 @@ void CUnitState::reset()
 	position = BattleHex::INVALID;
 }
 
-void CUnitState::save(JsonNode & data)
+void CUnitState::save(UnitStateSnapshot & data)
 {
-	//TODO: use instance resolver
-	data.clear();
-	JsonSerializer ser(nullptr, data);
-	ser.serializeStruct("state", *this);
+	data.cloned = cloned;
+	data.defending = defending;
+	data.defendingAnim = defendingAnim;
+	data.drainedMana = drainedMana;
+	data.fear = fear;
+	data.hadMorale = hadMorale;
+	data.castSpellThisTurn = castSpellThisTurn;
+	data.ghost = ghost;
+	data.ghostPending = ghostPending;
+	data.movedThisRound = movedThisRound;
+	data.summoned = summoned;
+	data.waiting = waiting;
+	data.waitedThisTurn = waitedThisTurn;
+
+	casts.save(data.casts);
+	counterAttacks.save(data.counterAttacks);
+	health.save(data.health);
+	shots.save(data.shots);
+
+	data.cloneID = cloneID;
+	data.position = position;
 }
 
-void CUnitState::load(const JsonNode & data)
+void CUnitState::load(const UnitStateSnapshot & data)
 {
-	//TODO: use instance resolver
 	reset();
-	JsonDeserializer deser(nullptr, data);
-	deser.serializeStruct("state", *this);
+
+	cloned = data.cloned;
+	defending = data.defending;
+	defendingAnim = data.defendingAnim;
+	drainedMana = data.drainedMana;
+	fear = data.fear;
+	hadMorale = data.hadMorale;
+	castSpellThisTurn = data.castSpellThisTurn;
+	ghost = data.ghost;
+	ghostPending = data.ghostPending;
+	movedThisRound = data.movedThisRound;
+	summoned = data.summoned;
+	waiting = data.waiting;
+	waitedThisTurn = data.waitedThisTurn;
+
+	casts.load(data.casts);
+	counterAttacks.load(data.counterAttacks);
+	health.load(data.health);
+	shots.load(data.shots);
+
+	cloneID = data.cloneID;
+	position = data.position;
 }
 
 void CUnitState::damage(int64_t & amount)
@@ -906,9 +951,14 @@ CUnitStateDetached::CUnitStateDetached(const IUnitInfo * unit_, const IBonusBear
 {
 }
 
-TConstBonusListPtr CUnitStateDetached::getAllBonuses(const CSelector & selector, const CSelector & limit, const std::string & cachingStr) const
+TConstBonusListPtr CUnitStateDetached::getAllBonuses(const CSelector & selector, const CSelector & limit, const BonusCacheKey & cachingKey) const
+{
+	return bonus->getAllBonuses(selector, limit, cachingKey);
+}
+
+int CUnitStateDetached::totalValueOfBonuses(const CSelector & selector, const BonusCacheKey & cachingKey) const
 {
-	return bonus->getAllBonuses(selector, limit, cachingStr);
+	return bonus->totalValueOfBonuses(selector, cachingKey);
 }
 
 int64_t CUnitStateDetached::getTreeVersion() const
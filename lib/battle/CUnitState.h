@@ -15,7 +15,6 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-class JsonSerializeFormat;
 class UnitChanges;
 
 namespace vstd
@@ -32,7 +31,7 @@ class DLL_LINKAGE CAmmo
 public:
 	explicit CAmmo(const battle::Unit * Owner, CSelector totalSelector);
 
-	//only copy construction is allowed for acquire(), serializeJson should be used for any other "assignment"
+	//only copy construction is allowed for acquire(), save/load should be used for any other "assignment"
 	CAmmo(const CAmmo & other) = default;
 	CAmmo(CAmmo && other) = delete;
 
@@ -46,7 +45,8 @@ public:
 	virtual int32_t total() const;
 	virtual void use(int32_t amount = 1);
 
-	virtual void serializeJson(JsonSerializeFormat & handler);
+	virtual void save(UnitStateSnapshot::Ammo & data) const;
+	virtual void load(const UnitStateSnapshot::Ammo & data);
 protected:
 	int32_t used;
 	const battle::Unit * owner;
@@ -81,15 +81,16 @@ class DLL_LINKAGE CRetaliations : public CAmmo
 {
 public:
 	explicit CRetaliations(const battle::Unit * Owner);
-	CRetaliations(const CRetaliations & other) = default;
-	CRetaliations & operator=(const CRetaliations & other) = default;
+	CRetaliations(const CRetaliations & other);
+	CRetaliations & operator=(const CRetaliations & other);
 	bool isLimited() const override;
 	int32_t total() const override;
 	void reset() override;
 
-	void serializeJson(JsonSerializeFormat & handler) override;
+	void save(UnitStateSnapshot::Ammo & data) const override;
+	void load(const UnitStateSnapshot::Ammo & data) override;
 private:
-	mutable int32_t totalCache;
+	mutable std::atomic<int32_t> totalCache; //raised by const total(), that can be called from several threads
 
 	CCheckProxy noRetaliation;
 	CCheckProxy unlimited;
@@ -121,7 +122,8 @@ public:
 
 	void takeResurrected();
 
-	void serializeJson(JsonSerializeFormat & handler);
+	void save(UnitStateSnapshot::Health & data) const;
+	void load(const UnitStateSnapshot::Health & data);
 private:
 	void addResurrected(int32_t amount);
 	void setFromTotal(const int64_t totalHealth);
@@ -244,14 +246,13 @@ public:
 	int getAttack(bool ranged) const override;
 	int getDefense(bool ranged) const override;
 
-	void save(JsonNode & data) override;
-	void load(const JsonNode & data) override;
+	void save(UnitStateSnapshot & data) override;
+	void load(const UnitStateSnapshot & data) override;
 
 	void damage(int64_t & amount) override;
 	HealInfo heal(int64_t & amount, EHealLevel level, EHealPower power) override;
 
 	void localInit(const IUnitEnvironment * env_);
-	void serializeJson(JsonSerializeFormat & handler);
 
 	FactionID getFactionID() const override;
 
@@ -283,7 +284,8 @@ public:
 	explicit CUnitStateDetached(const IUnitInfo * unit_, const IBonusBearer * bonus_);
 
 	TConstBonusListPtr getAllBonuses(const CSelector & selector, const CSelector & limit,
-		const std::string & cachingStr = "") const override;
+		const BonusCacheKey & cachingKey = {}) const override;
+	int totalValueOfBonuses(const CSelector & selector, const BonusCacheKey & cachingKey) const override;
 
 	int64_t getTreeVersion() const override;
 
@@ -57,10 +57,10 @@ DamageRange DamageCalculator::getBaseDamageSingle() const
 		}
 	}
 
-	const std::string cachingStrSiedgeWeapon = "type_SIEGE_WEAPON";
+	static const auto cachingKeySiedgeWeapon = BonusCacheKey::type(BonusType::SIEGE_WEAPON);
 	static const auto selectorSiedgeWeapon = Selector::type()(BonusType::SIEGE_WEAPON);
 
-	if(info.attacker->hasBonus(selectorSiedgeWeapon, cachingStrSiedgeWeapon) && info.attacker->creatureIndex() != CreatureID::ARROW_TOWERS)
+	if(info.attacker->hasBonus(selectorSiedgeWeapon, cachingKeySiedgeWeapon) && info.attacker->creatureIndex() != CreatureID::ARROW_TOWERS)
 	{
 		auto retrieveHeroPrimSkill = [&](PrimarySkill skill) -> int
 		{
@@ -77,14 +77,14 @@ DamageRange DamageCalculator::getBaseDamageSingle() const
 
 DamageRange DamageCalculator::getBaseDamageBlessCurse() const
 {
-	const std::string cachingStrForcedMinDamage = "type_ALWAYS_MINIMUM_DAMAGE";
+	static const auto cachingKeyForcedMinDamage = BonusCacheKey::type(BonusType::ALWAYS_MINIMUM_DAMAGE);
 	static const auto selectorForcedMinDamage = Selector::type()(BonusType::ALWAYS_MINIMUM_DAMAGE);
 
-	const std::string cachingStrForcedMaxDamage = "type_ALWAYS_MAXIMUM_DAMAGE";
+	static const auto cachingKeyForcedMaxDamage = BonusCacheKey::type(BonusType::ALWAYS_MAXIMUM_DAMAGE);
 	static const auto selectorForcedMaxDamage = Selector::type()(BonusType::ALWAYS_MAXIMUM_DAMAGE);
 
-	TConstBonusListPtr curseEffects = info.attacker->getBonuses(selectorForcedMinDamage, cachingStrForcedMinDamage);
-	TConstBonusListPtr blessEffects = info.attacker->getBonuses(selectorForcedMaxDamage, cachingStrForcedMaxDamage);
+	TConstBonusListPtr curseEffects = info.attacker->getBonuses(selectorForcedMinDamage, cachingKeyForcedMinDamage);
+	TConstBonusListPtr blessEffects = info.attacker->getBonuses(selectorForcedMaxDamage, cachingKeyForcedMaxDamage);
 
 	int curseBlessAdditiveModifier = blessEffects->totalValue() - curseEffects->totalValue();
 
@@ -154,13 +154,13 @@ int DamageCalculator::getActorAttackIgnored() const
 
 int DamageCalculator::getActorAttackSlayer() const
 {
-	const std::string cachingStrSlayer = "type_SLAYER";
+	static const auto cachingKeySlayer = BonusCacheKey::type(BonusType::SLAYER);
 	static const auto selectorSlayer = Selector::type()(BonusType::SLAYER);
 
 	if (!info.defender->hasBonusOfType(BonusType::KING))
 		return 0;
 
-	auto slayerEffects = info.attacker->getBonuses(selectorSlayer, cachingStrSlayer);
+	auto slayerEffects = info.attacker->getBonuses(selectorSlayer, cachingKeySlayer);
 	auto slayerAffected = info.defender->unitType()->valOfBonuses(Selector::type()(BonusType::KING));
 
 	if(std::shared_ptr<const Bonus> slayerEffect = slayerEffects->getFirst(Selector::all))
@@ -224,9 +224,9 @@ double DamageCalculator::getAttackSkillFactor() const
 
 double DamageCalculator::getAttackBlessFactor() const
 {
-	const std::string cachingStrDamage = "type_GENERAL_DAMAGE_PREMY";
+	static const auto cachingKeyDamage = BonusCacheKey::type(BonusType::GENERAL_DAMAGE_PREMY);
 	static const auto selectorDamage = Selector::type()(BonusType::GENERAL_DAMAGE_PREMY);
-	return info.attacker->valOfBonuses(selectorDamage, cachingStrDamage) / 100.0;
+	return info.attacker->valOfBonuses(selectorDamage, cachingKeyDamage) / 100.0;
 }
 
 double DamageCalculator::getAttackOffenseArcheryFactor() const
@@ -234,13 +234,13 @@ double DamageCalculator::getAttackOffenseArcheryFactor() const
 	
 	if(info.shooting)
 	{
-		const std::string cachingStrArchery = "type_PERCENTAGE_DAMAGE_BOOSTs_1";
+		static const auto cachingKeyArchery = BonusCacheKey::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeRanged);
 		static const auto selectorArchery = Selector::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeRanged);
-		return info.attacker->valOfBonuses(selectorArchery, cachingStrArchery) / 100.0;
+		return info.attacker->valOfBonuses(selectorArchery, cachingKeyArchery) / 100.0;
 	}
-	const std::string cachingStrOffence = "type_PERCENTAGE_DAMAGE_BOOSTs_0";
+	static const auto cachingKeyOffence = BonusCacheKey::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeMelee);
 	static const auto selectorOffence = Selector::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeMelee);
-	return info.attacker->valOfBonuses(selectorOffence, cachingStrOffence) / 100.0;
+	return info.attacker->valOfBonuses(selectorOffence, cachingKeyOffence) / 100.0;
 }
 
 double DamageCalculator::getAttackLuckFactor() const
@@ -260,23 +260,23 @@ double DamageCalculator::getAttackDeathBlowFactor() const
 double DamageCalculator::getAttackDoubleDamageFactor() const
 {
 	if(info.doubleDamage) {
-		const auto cachingStr = "type_BONUS_DAMAGE_PERCENTAGEs_" + std::to_string(info.attacker->creatureIndex());
+		const auto cachingKey = BonusCacheKey::typeSubtype(BonusType::BONUS_DAMAGE_PERCENTAGE, BonusSubtypeID(info.attacker->creatureId()));
 		const auto selector = Selector::typeSubtype(BonusType::BONUS_DAMAGE_PERCENTAGE, BonusSubtypeID(info.attacker->creatureId()));
-		return info.attacker->valOfBonuses(selector, cachingStr) / 100.0;
+		return info.attacker->valOfBonuses(selector, cachingKey) / 100.0;
 	}
 	return 0.0;
 }
 
 double DamageCalculator::getAttackJoustingFactor() const
 {
-	const std::string cachingStrJousting = "type_JOUSTING";
+	static const auto cachingKeyJousting = BonusCacheKey::type(BonusType::JOUSTING);
 	static const auto selectorJousting = Selector::type()(BonusType::JOUSTING);
 
-	const std::string cachingStrChargeImmunity = "type_CHARGE_IMMUNITY";
+	static const auto cachingKeyChargeImmunity = BonusCacheKey::type(BonusType::CHARGE_IMMUNITY);
 	static const auto selectorChargeImmunity = Selector::type()(BonusType::CHARGE_IMMUNITY);
 
 	//applying jousting bonus
-	if(info.chargeDistance > 0 && info.attacker->hasBonus(selectorJousting, cachingStrJousting) && !info.defender->hasBonus(selectorChargeImmunity, cachingStrChargeImmunity))
+	if(info.chargeDistance > 0 && info.attacker->hasBonus(selectorJousting, cachingKeyJousting) && !info.defender->hasBonus(selectorChargeImmunity, cachingKeyChargeImmunity))
 		return info.chargeDistance * (info.attacker->valOfBonuses(selectorJousting))/100.0;
 	return 0.0;
 }
@@ -284,10 +284,10 @@ double DamageCalculator::getAttackJoustingFactor() const
 double DamageCalculator::getAttackHateFactor() const
 {
 	//assume that unit have only few HATE features and cache them all
-	const std::string cachingStrHate = "type_HATE";
+	static const auto cachingKeyHate = BonusCacheKey::type(BonusType::HATE);
 	static const auto selectorHate = Selector::type()(BonusType::HATE);
 
-	auto allHateEffects = info.attacker->getBonuses(selectorHate, cachingStrHate);
+	auto allHateEffects = info.attacker->getBonuses(selectorHate, cachingKeyHate);
 
 	return allHateEffects->valOfBonuses(Selector::subtype()(BonusSubtypeID(info.defender->creatureId()))) / 100.0;
 }
@@ -325,25 +325,25 @@ double DamageCalculator::getDefenseSkillFactor() const
 
 double DamageCalculator::getDefenseArmorerFactor() const
 {
-	const std::string cachingStrArmorer = "type_GENERAL_DAMAGE_REDUCTIONs_N1_NsrcSPELL_EFFECT";
+	static const BonusCacheKey cachingKeyArmorer("type_GENERAL_DAMAGE_REDUCTIONs_N1_NsrcSPELL_EFFECT");
 	static const auto selectorArmorer = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeAll).And(Selector::sourceTypeSel(BonusSource::SPELL_EFFECT).Not());
-	return info.defender->valOfBonuses(selectorArmorer, cachingStrArmorer) / 100.0;
+	return info.defender->valOfBonuses(selectorArmorer, cachingKeyArmorer) / 100.0;
 
 }
 
 double DamageCalculator::getDefenseMagicShieldFactor() const
 {
-	const std::string cachingStrMeleeReduction = "type_GENERAL_DAMAGE_REDUCTIONs_0";
+	static const auto cachingKeyMeleeReduction = BonusCacheKey::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeMelee);
 	static const auto selectorMeleeReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeMelee);
 
-	const std::string cachingStrRangedReduction = "type_GENERAL_DAMAGE_REDUCTIONs_1";
+	static const auto cachingKeyRangedReduction = BonusCacheKey::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeRanged);
 	static const auto selectorRangedReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeRanged);
 
 	//handling spell effects - shield and air shield
 	if(info.shooting)
-		return info.defender->valOfBonuses(selectorRangedReduction, cachingStrRangedReduction) / 100.0;
+		return info.defender->valOfBonuses(selectorRangedReduction, cachingKeyRangedReduction) / 100.0;
 	else
-		return info.defender->valOfBonuses(selectorMeleeReduction, cachingStrMeleeReduction) / 100.0;
+		return info.defender->valOfBonuses(selectorMeleeReduction, cachingKeyMeleeReduction) / 100.0;
 }
 
 double DamageCalculator::getDefenseRangePenaltiesFactor() const
@@ -353,7 +353,7 @@ double DamageCalculator::getDefenseRangePenaltiesFactor() const
 		BattleHex attackerPos = info.attackerPos.isValid() ? info.attackerPos : info.attacker->getPosition();
 		BattleHex defenderPos = info.defenderPos.isValid() ? info.defenderPos : info.defender->getPosition();
 
-		const std::string cachingStrAdvAirShield = "isAdvancedAirShield";
+		static const BonusCacheKey cachingKeyAdvAirShield("isAdvancedAirShield");
 		auto isAdvancedAirShield = [](const Bonus* bonus)
 		{
 			return bonus->source == BonusSource::SPELL_EFFECT
@@ -363,16 +363,16 @@ double DamageCalculator::getDefenseRangePenaltiesFactor() const
 
 		const bool distPenalty = callback.battleHasDistancePenalty(info.attacker, attackerPos, defenderPos);
 
-		if(distPenalty || info.defender->hasBonus(isAdvancedAirShield, cachingStrAdvAirShield))
+		if(distPenalty || info.defender->hasBonus(isAdvancedAirShield, cachingKeyAdvAirShield))
 			return 0.5;
 
 	}
 	else
 	{
-		const std::string cachingStrNoMeleePenalty = "type_NO_MELEE_PENALTY";
+		static const auto cachingKeyNoMeleePenalty = BonusCacheKey::type(BonusType::NO_MELEE_PENALTY);
 		static const auto selectorNoMeleePenalty = Selector::type()(BonusType::NO_MELEE_PENALTY);
 
-		if(info.attacker->isShooter() && !info.attacker->hasBonus(selectorNoMeleePenalty, cachingStrNoMeleePenalty))
+		if(info.attacker->isShooter() && !info.attacker->hasBonus(selectorNoMeleePenalty, cachingKeyNoMeleePenalty))
 			return 0.5;
 	}
 	return 0.0;
@@ -430,10 +430,10 @@ double DamageCalculator::getDefenseForgetfulnessFactor() const
 double DamageCalculator::getDefensePetrificationFactor() const
 {
 	// Creatures that are petrified by a Basilisk's Petrifying attack or a Medusa's Stone gaze take 50% damage (R8 = 0.50) from ranged and melee attacks. Taking damage also deactivates the effect.
-	const std::string cachingStrAllReduction = "type_GENERAL_DAMAGE_REDUCTIONs_N1_srcSPELL_EFFECT";
+	static const BonusCacheKey cachingKeyAllReduction("type_GENERAL_DAMAGE_REDUCTIONs_N1_srcSPELL_EFFECT");
 	static const auto selectorAllReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeAll).And(Selector::sourceTypeSel(BonusSource::SPELL_EFFECT));
 
-	return info.defender->valOfBonuses(selectorAllReduction, cachingStrAllReduction) / 100.0;
+	return info.defender->valOfBonuses(selectorAllReduction, cachingKeyAllReduction) / 100.0;
 }
 
 double DamageCalculator::getDefenseMagicFactor() const
@@ -441,10 +441,10 @@ double DamageCalculator::getDefenseMagicFactor() const
 	// Magic Elementals deal half damage (R8 = 0.50) against Magic Elementals and Black Dragons. This is not affected by the Orb of Vulnerability, Anti-Magic, or Magic Resistance.
 	if(info.attacker->creatureIndex() == CreatureID::MAGIC_ELEMENTAL)
 	{
-		const std::string cachingStrMagicImmunity = "type_LEVEL_SPELL_IMMUNITY";
+		static const auto cachingKeyMagicImmunity = BonusCacheKey::type(BonusType::LEVEL_SPELL_IMMUNITY);
 		static const auto selectorMagicImmunity = Selector::type()(BonusType::LEVEL_SPELL_IMMUNITY);
 
-		if(info.defender->valOfBonuses(selectorMagicImmunity, cachingStrMagicImmunity) >= 5)
+		if(info.defender->valOfBonuses(selectorMagicImmunity, cachingKeyMagicImmunity) >= 5)
 			return 0.5;
 	}
 	return 0.0;
@@ -455,10 +455,10 @@ double DamageCalculator::getDefenseMindFactor() const
 	// Psychic Elementals deal half damage (R8 = 0.50) against creatures that are immune to Mind spells, such as Giants and Undead. This is not affected by the Orb of Vulnerability.
 	if(info.attacker->creatureIndex() == CreatureID::PSYCHIC_ELEMENTAL)
 	{
-		const std::string cachingStrMindImmunity = "type_MIND_IMMUNITY";
+		static const auto cachingKeyMindImmunity = BonusCacheKey::type(BonusType::MIND_IMMUNITY);
 		static const auto selectorMindImmunity = Selector::type()(BonusType::MIND_IMMUNITY);
 
-		if(info.defender->hasBonus(selectorMindImmunity, cachingStrMindImmunity))
+		if(info.defender->hasBonus(selectorMindImmunity, cachingKeyMindImmunity))
 			return 0.5;
 	}
 	return 0.0;
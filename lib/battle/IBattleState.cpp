@@ -11,3 +11,11 @@
 
 #include "IBattleState.h"
 
+VCMI_LIB_NAMESPACE_BEGIN
+
+ReachabilityCache * IBattleInfo::getReachabilityCache() const
+{
+	return nullptr;
+}
+
+VCMI_LIB_NAMESPACE_END
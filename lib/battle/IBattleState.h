@@ -17,6 +17,7 @@ class ObstacleChanges;
 class UnitChanges;
 struct Bonus;
 struct BattleLayout;
+class ReachabilityCache;
 class JsonNode;
 class JsonSerializeFormat;
 class BattleField;
@@ -30,6 +31,7 @@ namespace vstd
 namespace battle
 {
 	class UnitInfo;
+	struct UnitStateSnapshot;
 }
 
 class DLL_LINKAGE IBattleInfo : public IConstBonusProvider
@@ -74,6 +76,9 @@ public:
 
 	virtual int3 getLocation() const = 0;
 	virtual BattleLayout getLayout() const = 0;
+
+	/// Shared cache for accessibility and reachability of this battle state, nullptr if state does not maintain one
+	virtual ReachabilityCache * getReachabilityCache() const;
 };
 
 class DLL_LINKAGE IBattleState : public IBattleInfo
@@ -82,8 +87,8 @@ public:
 	virtual void nextRound() = 0;
 	virtual void nextTurn(uint32_t unitId) = 0;
 
-	virtual void addUnit(uint32_t id, const JsonNode & data) = 0;
-	virtual void setUnitState(uint32_t id, const JsonNode & data, int64_t healthDelta) = 0;
+	virtual void addUnit(uint32_t id, const battle::UnitInfo & info) = 0;
+	virtual void setUnitState(uint32_t id, const battle::UnitStateSnapshot & data, int64_t healthDelta) = 0;
 	virtual void moveUnit(uint32_t id, BattleHex destination) = 0;
 	virtual void removeUnit(uint32_t id) = 0;
 	virtual void updateUnit(uint32_t id, const JsonNode & data) = 0;
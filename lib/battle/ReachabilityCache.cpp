@@ -0,0 +1,106 @@
+/*
+ * ReachabilityCache.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "ReachabilityCache.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+ReachabilityCache::Key::Key(BattleSide viewer, const ReachabilityInfo::Parameters & params):
+	viewer(viewer),
+	side(params.side),
+	perspective(params.perspective),
+	doubleWide(params.doubleWide),
+	flying(params.flying),
+	ignoreKnownAccessible(params.ignoreKnownAccessible),
+	startPosition(params.startPosition),
+	knownAccessible(params.knownAccessible)
+{
+}
+
+bool ReachabilityCache::Key::operator<(const Key & other) const
+{
+	return std::tie(viewer, side, perspective, doubleWide, flying, ignoreKnownAccessible, startPosition, knownAccessible)
+		< std::tie(other.viewer, other.side, other.perspective, other.doubleWide, other.flying, other.ignoreKnownAccessible, other.startPosition, other.knownAccessible);
+}
+
+bool ReachabilityCache::isCacheable(const ReachabilityInfo::Parameters & params)
+{
+	return !params.bypassEnemyStacks && params.destructibleEnemyTurns.empty();
+}
+
+std::optional<AccessibilityInfo> ReachabilityCache::getAccessibility(BattleSide viewer) const
+{
+	boost::lock_guard<boost::mutex> lock(mx);
+
+	auto it = accessibility.find(viewer);
+	if(it == accessibility.end())
+		return std::nullopt;
+
+	return it->second;
+}
+
+void ReachabilityCache::setAccessibility(BattleSide viewer, const AccessibilityInfo & value, uint64_t computedAtVersion)
+{
+	boost::lock_guard<boost::mutex> lock(mx);
+
+	if(computedAtVersion != stateVersion)
+		return;
+
+	accessibility[viewer] = value;
+}
+
+std::optional<ReachabilityInfo> ReachabilityCache::getReachability(BattleSide viewer, const ReachabilityInfo::Parameters & params) const
+{
+	if(!isCacheable(params))
+		return std::nullopt;
+
+	boost::lock_guard<boost::mutex> lock(mx);
+
+	auto it = reachability.find(Key(viewer, params));
+	if(it == reachability.end())
+		return std::nullopt;
+
+	return it->second;
+}
+
+void ReachabilityCache::setReachability(BattleSide viewer, const ReachabilityInfo::Parameters & params, const ReachabilityInfo & value, uint64_t computedAtVersion)
+{
+	if(!isCacheable(params))
+		return;
+
+	boost::lock_guard<boost::mutex> lock(mx);
+
+	if(computedAtVersion != stateVersion)
+		return;
+
+	if(reachability.size() >= MAX_ENTRIES)
+		reachability.clear();
+
+	reachability[Key(viewer, params)] = value;
+}
+
+void ReachabilityCache::invalidate()
+{
+	boost::lock_guard<boost::mutex> lock(mx);
+
+	stateVersion++;
+	accessibility.clear();
+	reachability.clear();
+}
+
+uint64_t ReachabilityCache::getStateVersion() const
+{
+	boost::lock_guard<boost::mutex> lock(mx);
+
+	return stateVersion;
+}
+
+VCMI_LIB_NAMESPACE_END
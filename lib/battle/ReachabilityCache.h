@@ -0,0 +1,62 @@
+/*
+ * ReachabilityCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+#include "ReachabilityInfo.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Memoizes accessibility and reachability queries against a battle state.
+/// Owner must call invalidate() whenever units move, die, spawn or obstacles and walls change.
+/// Results depend on the side that asks (hidden obstacles), so it is part of every key.
+/// Values computed before an invalidation are discarded on store, see getStateVersion().
+class DLL_LINKAGE ReachabilityCache : boost::noncopyable
+{
+public:
+	/// Only plain per-unit queries are cached, queries that look through enemy stacks are computed every time
+	static bool isCacheable(const ReachabilityInfo::Parameters & params);
+
+	std::optional<AccessibilityInfo> getAccessibility(BattleSide viewer) const;
+	void setAccessibility(BattleSide viewer, const AccessibilityInfo & value, uint64_t computedAtVersion);
+
+	std::optional<ReachabilityInfo> getReachability(BattleSide viewer, const ReachabilityInfo::Parameters & params) const;
+	void setReachability(BattleSide viewer, const ReachabilityInfo::Parameters & params, const ReachabilityInfo & value, uint64_t computedAtVersion);
+
+	void invalidate();
+
+	/// Incremented on every invalidation, read it before computing a value that will be stored
+	uint64_t getStateVersion() const;
+
+private:
+	struct Key
+	{
+		BattleSide viewer;
+		BattleSide side;
+		BattleSide perspective;
+		bool doubleWide;
+		bool flying;
+		bool ignoreKnownAccessible;
+		BattleHex startPosition;
+		std::vector<BattleHex> knownAccessible;
+
+		Key(BattleSide viewer, const ReachabilityInfo::Parameters & params);
+
+		bool operator<(const Key & other) const;
+	};
+
+	/// Amount of reachability entries kept before the cache is dropped as a whole
+	static constexpr size_t MAX_ENTRIES = 256;
+
+	mutable boost::mutex mx;
+	uint64_t stateVersion = 0;
+	std::map<BattleSide, AccessibilityInfo> accessibility;
+	std::map<Key, ReachabilityInfo> reachability;
+};
+
+VCMI_LIB_NAMESPACE_END
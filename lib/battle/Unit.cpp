@@ -213,6 +213,88 @@ int Unit::getRawSurrenderCost() const
 		return 0;
 }
 
+///UnitStateSnapshot
+void UnitStateSnapshot::serializeJson(JsonSerializeFormat & handler)
+{
+	handler.serializeBool("cloned", cloned);
+	handler.serializeBool("defending", defending);
+	handler.serializeBool("defendingAnim", defendingAnim);
+	handler.serializeBool("drainedMana", drainedMana);
+	handler.serializeBool("fear", fear);
+	handler.serializeBool("hadMorale", hadMorale);
+	handler.serializeBool("castSpellThisTurn", castSpellThisTurn);
+	handler.serializeBool("ghost", ghost);
+	handler.serializeBool("ghostPending", ghostPending);
+	handler.serializeBool("moved", movedThisRound);
+	handler.serializeBool("summoned", summoned);
+	handler.serializeBool("waiting", waiting);
+	handler.serializeBool("waitedThisTurn", waitedThisTurn);
+
+	{
+		auto guard = handler.enterStruct("casts");
+		handler.serializeInt("used", casts.used, 0);
+	}
+	{
+		auto guard = handler.enterStruct("counterAttacks");
+		handler.serializeInt("used", counterAttacks.used, 0);
+		//we may be serialized in the middle of turn
+		handler.serializeInt("totalCache", counterAttacks.totalCache, 0);
+	}
+	{
+		auto guard = handler.enterStruct("health");
+		handler.serializeInt("firstHPleft", health.firstHPleft, 0);
+		handler.serializeInt("fullUnits", health.fullUnits, 0);
+		handler.serializeInt("resurrected", health.resurrected, 0);
+	}
+	{
+		auto guard = handler.enterStruct("shots");
+		handler.serializeInt("used", shots.used, 0);
+	}
+
+	handler.serializeInt("cloneID", cloneID);
+
+	handler.serializeInt("position", position);
+}
+
+void UnitStateSnapshot::save(JsonNode & data)
+{
+	data.clear();
+	JsonSerializer ser(nullptr, data);
+	ser.serializeStruct("state", *this);
+}
+
+void UnitStateSnapshot::load(const JsonNode & data)
+{
+	*this = UnitStateSnapshot();
+	JsonDeserializer deser(nullptr, data);
+	deser.serializeStruct("state", *this);
+}
+
+uint16_t UnitStateSnapshot::packFlags() const
+{
+	const std::array<bool, 13> values = {
+		cloned, defending, defendingAnim, drainedMana, fear, hadMorale, castSpellThisTurn,
+		ghost, ghostPending, movedThisRound, summoned, waiting, waitedThisTurn
+	};
+
+	uint16_t flags = 0;
+	for(size_t i = 0; i < values.size(); ++i)
+		if(values[i])
+			flags |= 1 << i;
+	return flags;
+}
+
+void UnitStateSnapshot::unpackFlags(uint16_t flags)
+{
+	const std::array<bool *, 13> values = {
+		&cloned, &defending, &defendingAnim, &drainedMana, &fear, &hadMorale, &castSpellThisTurn,
+		&ghost, &ghostPending, &movedThisRound, &summoned, &waiting, &waitedThisTurn
+	};
+
+	for(size_t i = 0; i < values.size(); ++i)
+		*values[i] = (flags & (1 << i)) != 0;
+}
+
 ///UnitInfo
 void UnitInfo::serializeJson(JsonSerializeFormat & handler)
 {
@@ -62,6 +62,84 @@ struct HealInfo
 
 class CUnitState;
 
+/// Complete mutable state of battle unit, used to transfer unit state in battle packs
+struct DLL_LINKAGE UnitStateSnapshot
+{
+	struct Ammo
+	{
+		int32_t used = 0;
+		int32_t totalCache = 0;
+
+		template <typename Handler> void serialize(Handler & h)
+		{
+			h & used;
+			h & totalCache;
+		}
+	};
+
+	struct Health
+	{
+		int32_t firstHPleft = 0;
+		int32_t fullUnits = 0;
+		int32_t resurrected = 0;
+
+		template <typename Handler> void serialize(Handler & h)
+		{
+			h & firstHPleft;
+			h & fullUnits;
+			h & resurrected;
+		}
+	};
+
+	bool cloned = false;
+	bool defending = false;
+	bool defendingAnim = false;
+	bool drainedMana = false;
+	bool fear = false;
+	bool hadMorale = false;
+	bool castSpellThisTurn = false;
+	bool ghost = false;
+	bool ghostPending = false;
+	bool movedThisRound = false;
+	bool summoned = false;
+	bool waiting = false;
+	bool waitedThisTurn = false;
+
+	Ammo casts;
+	Ammo counterAttacks;
+	Ammo shots;
+	Health health;
+
+	si32 cloneID = -1;
+	BattleHex position;
+
+	/// json form of unit state, used by scripting and by older protocol versions
+	void serializeJson(JsonSerializeFormat & handler);
+	void save(JsonNode & data);
+	void load(const JsonNode & data);
+
+	template <typename Handler> void serialize(Handler & h)
+	{
+		uint16_t flags = 0;
+		if (h.saving)
+			flags = packFlags();
+		h & flags;
+		if (!h.saving)
+			unpackFlags(flags);
+
+		h & casts;
+		h & counterAttacks;
+		h & shots;
+		h & health;
+		h & cloneID;
+		h & position;
+	}
+
+private:
+	uint16_t packFlags() const;
+	void unpackFlags(uint16_t flags);
+};
+
 class DLL_LINKAGE Unit : public IUnitInfo, public spells::Caster, public virtual IBonusBearer, public ACreature
 {
 public:
@@ -151,10 +229,9 @@ public:
 	//IConstBonusProvider
 	const IBonusBearer* getBonusBearer() const override;
 
-	//NOTE: save could possibly be const, but this requires heavy changes to Json serialization,
-	//also this method should be called only after modifying object
-	virtual void save(JsonNode & data) = 0;
-	virtual void load(const JsonNode & data) = 0;
+	//NOTE: this method should be called only after modifying object
+	virtual void save(UnitStateSnapshot & data) = 0;
+	virtual void load(const UnitStateSnapshot & data) = 0;
 
 	virtual void damage(int64_t & amount) = 0;
 	virtual HealInfo heal(int64_t & amount, EHealLevel level, EHealPower power) = 0;
@@ -174,6 +251,16 @@ public:
 
 	void save(JsonNode & data);
 	void load(uint32_t id_, const JsonNode & data);
+
+	template <typename Handler> void serialize(Handler & h)
+	{
+		h & id;
+		h & count;
+		h & type;
+		h & side;
+		h & position;
+		h & summoned;
+	}
 };
 
 }
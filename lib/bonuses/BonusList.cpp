@@ -14,19 +14,14 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-BonusList::BonusList(bool BelongsToTree) : belongsToTree(BelongsToTree)
-{
-}
-
-BonusList::BonusList(const BonusList & bonusList): belongsToTree(false)
+BonusList::BonusList(const BonusList & bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
 }
 
-BonusList::BonusList(BonusList && other) noexcept: belongsToTree(false)
+BonusList::BonusList(BonusList && other) noexcept
 {
-	std::swap(belongsToTree, other.belongsToTree);
 	std::swap(bonuses, other.bonuses);
 }
 
@@ -34,16 +29,9 @@ BonusList& BonusList::operator=(const BonusList &bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
 	return *this;
 }
 
-void BonusList::changed() const
-{
-    if(belongsToTree)
-		CBonusSystemNode::treeHasChanged();
-}
-
 void BonusList::stackBonuses()
 {
 	boost::sort(bonuses, [](const std::shared_ptr<Bonus> & b1, const std::shared_ptr<Bonus> & b2) -> bool
@@ -83,11 +71,21 @@ void BonusList::stackBonuses()
 	}
 }
 
-int BonusList::totalValue() const
+namespace
+{
+/// Fields of bonus that affect total value
+struct BonusValueFields
+{
+	int32_t val;
+	BonusValueType valType;
+	BonusSource source;
+	BonusSource targetSourceType;
+};
+
+/// Computes total value of bonuses with non-zero mask (of all bonuses if there is no mask), fieldsOf(i) returns fields of i-th bonus
+template<typename FieldsAccessor>
+int computeTotalValue(size_t count, const uint8_t * mask, const FieldsAccessor & fieldsOf)
 {
-	if (bonuses.empty())
-		return 0;
-
 	struct BonusCollection
 	{
 		int base = 0;
@@ -104,30 +102,40 @@ int BonusList::totalValue() const
 	};
 
 	BonusCollection accumulated;
+	int selectedCount = 0;
 	int indexMaxCount = 0;
 	int indexMinCount = 0;
 
 	std::array<int, vstd::to_underlying(BonusSource::NUM_BONUS_SOURCE)> percentToSource = {};
 
-	for(const auto & b : bonuses)
+	for(size_t i = 0; i < count; ++i)
 	{
-		switch(b->valType)
+		if(mask && !mask[i])
+			continue;
+
+		const BonusValueFields b = fieldsOf(i);
+		switch(b.valType)
 		{
 		case BonusValueType::PERCENT_TO_SOURCE:
-			percentToSource[vstd::to_underlying(b->source)] += b->val;
+			percentToSource[vstd::to_underlying(b.source)] += b.val;
 		break;
 		case BonusValueType::PERCENT_TO_TARGET_TYPE:
-			percentToSource[vstd::to_underlying(b->targetSourceType)] += b->val;
+			percentToSource[vstd::to_underlying(b.targetSourceType)] += b.val;
 			break;
 		}
 	}
 
-	for(const auto & b : bonuses)
+	for(size_t i = 0; i < count; ++i)
 	{
-		int sourceIndex = vstd::to_underlying(b->source);
-		int valModified	= applyPercentage(b->val, percentToSource[sourceIndex]);
+		if(mask && !mask[i])
+			continue;
+
+		const BonusValueFields b = fieldsOf(i);
+		int sourceIndex = vstd::to_underlying(b.source);
+		int valModified	= applyPercentage(b.val, percentToSource[sourceIndex]);
+		selectedCount++;
 
-		switch(b->valType)
+		switch(b.valType)
 		{
 		case BonusValueType::BASE_NUMBER:
 			accumulated.base += valModified;
@@ -159,7 +167,7 @@ int BonusList::totalValue() const
 	if(indexMinCount && indexMaxCount && accumulated.indepMin < accumulated.indepMax)
 		accumulated.indepMax = accumulated.indepMin;
 
-	const int notIndepBonuses = bonuses.size() - indexMaxCount - indexMinCount;
+	const int notIndepBonuses = selectedCount - indexMaxCount - indexMinCount;
 
 	if(notIndepBonuses)
 		return std::clamp(valFirst, accumulated.indepMax, accumulated.indepMin);
@@ -173,6 +181,20 @@ int BonusList::totalValue() const
 	return 0;
 }
 
+BonusValueFields valueFieldsOf(const Bonus & b)
+{
+	return {b.val, b.valType, b.source, b.targetSourceType};
+}
+}
+
+int BonusList::totalValue() const
+{
+	if (bonuses.empty())
+		return 0;
+
+	return computeTotalValue(bonuses.size(), nullptr, [this](size_t i){ return valueFieldsOf(*bonuses[i]); });
+}
+
 std::shared_ptr<Bonus> BonusList::getFirst(const CSelector &select)
 {
 	for (auto & b : bonuses)
@@ -211,10 +233,12 @@ void BonusList::getAllBonuses(BonusList &out) const
 
 int BonusList::valOfBonuses(const CSelector &select) const
 {
-	BonusList ret;
-	CSelector limit = nullptr;
-	getBonuses(ret, select, limit);
-	return ret.totalValue();
+	// sum matching bonuses in place instead of copying them into temporary list
+	std::vector<uint8_t> mask(bonuses.size());
+	for(size_t i = 0; i < bonuses.size(); ++i)
+		mask[i] = select(bonuses[i].get());
+
+	return computeTotalValue(bonuses.size(), mask.data(), [this](size_t i){ return valueFieldsOf(*bonuses[i]); });
 }
 
 JsonNode BonusList::toJsonNode() const
@@ -228,19 +252,16 @@ JsonNode BonusList::toJsonNode() const
 void BonusList::push_back(const std::shared_ptr<Bonus> & x)
 {
 	bonuses.push_back(x);
-	changed();
 }
 
 BonusList::TInternalContainer::iterator BonusList::erase(const int position)
 {
-	changed();
 	return bonuses.erase(bonuses.begin() + position);
 }
 
 void BonusList::clear()
 {
 	bonuses.clear();
-	changed();
 }
 
 std::vector<BonusList *>::size_type BonusList::operator-=(const std::shared_ptr<Bonus> & i)
@@ -249,14 +270,12 @@ std::vector<BonusList *>::size_type BonusList::operator-=(const std::shared_ptr<
 	if(itr == bonuses.end())
 		return false;
 	bonuses.erase(itr);
-	changed();
 	return true;
 }
 
 void BonusList::resize(BonusList::TInternalContainer::size_type sz, const std::shared_ptr<Bonus> & c)
 {
 	bonuses.resize(sz, c);
-	changed();
 }
 
 void BonusList::reserve(TInternalContainer::size_type sz)
@@ -267,7 +286,107 @@ void BonusList::reserve(TInternalContainer::size_type sz)
 void BonusList::insert(BonusList::TInternalContainer::iterator position, BonusList::TInternalContainer::size_type n, const std::shared_ptr<Bonus> & x)
 {
 	bonuses.insert(position, n, x);
-	changed();
+}
+
+template<typename Identifier>
+static uint64_t packIdentifier(const Identifier & identifier)
+{
+	return (static_cast<uint64_t>(identifier.getIndex()) << 32) | static_cast<uint32_t>(identifier.getNum());
+}
+
+void PackedBonusList::build(const BonusList & bonuses)
+{
+	clear();
+	types.reserve(bonuses.size());
+	sources.reserve(bonuses.size());
+	targetSourceTypes.reserve(bonuses.size());
+	valTypes.reserve(bonuses.size());
+	durations.reserve(bonuses.size());
+	turnsRemain.reserve(bonuses.size());
+	vals.reserve(bonuses.size());
+	subtypes.reserve(bonuses.size());
+	sids.reserve(bonuses.size());
+
+	for(const auto & b : bonuses)
+	{
+		types.push_back(b->type);
+		sources.push_back(b->source);
+		targetSourceTypes.push_back(b->targetSourceType);
+		valTypes.push_back(b->valType);
+		durations.push_back(b->duration);
+		turnsRemain.push_back(b->turnsRemain);
+		vals.push_back(b->val);
+		subtypes.push_back(packIdentifier(b->subtype));
+		sids.push_back(packIdentifier(b->sid));
+	}
+}
+
+void PackedBonusList::clear()
+{
+	types.clear();
+	sources.clear();
+	targetSourceTypes.clear();
+	valTypes.clear();
+	durations.clear();
+	turnsRemain.clear();
+	vals.clear();
+	subtypes.clear();
+	sids.clear();
+}
+
+void PackedBonusList::filter(std::vector<uint8_t> & mask, const BonusFieldSelector & selector) const
+{
+	mask.resize(types.size());
+
+	if(selector.fields & BonusFieldSelector::NOTHING)
+	{
+		std::fill(mask.begin(), mask.end(), 0);
+		return;
+	}
+
+	const bool anyType = !(selector.fields & BonusFieldSelector::TYPE);
+	const bool anySource = !(selector.fields & BonusFieldSelector::SOURCE);
+	const bool anyValType = !(selector.fields & BonusFieldSelector::VALUE_TYPE);
+	const bool anySubtype = !(selector.fields & BonusFieldSelector::SUBTYPE);
+	const bool anySid = !(selector.fields & BonusFieldSelector::SOURCE_ID);
+	const bool anyTurns = !(selector.fields & BonusFieldSelector::LASTS_TURNS);
+	const uint64_t subtype = packIdentifier(selector.subtype);
+	const uint64_t sid = packIdentifier(selector.sid);
+
+	// no branches in loop body so compiler can vectorize it
+	for(size_t i = 0; i < types.size(); ++i)
+	{
+		mask[i] = (anyType | (types[i] == selector.type))
+			& (anySource | (sources[i] == selector.source))
+			& (anyValType | (valTypes[i] == selector.valType))
+			& (anySubtype | (subtypes[i] == subtype))
+			& (anySid | (sids[i] == sid))
+			& (anyTurns | !(durations[i] & BonusDuration::N_TURNS) | (turnsRemain[i] > selector.turns));
+	}
+}
+
+int PackedBonusList::totalValue(const std::vector<uint8_t> & mask) const
+{
+	assert(mask.size() == types.size());
+
+	return computeTotalValue(types.size(), mask.data(), [this](size_t i) -> BonusValueFields
+	{
+		return {vals[i], valTypes[i], sources[i], targetSourceTypes[i]};
+	});
+}
+
+void PackedBonusList::getBonuses(BonusList & out, const BonusList & bonuses, const BonusFieldSelector & selector) const
+{
+	assert(bonuses.size() == types.size());
+
+	std::vector<uint8_t> mask;
+	filter(mask, selector);
+
+	for(size_t i = 0; i < mask.size(); ++i)
+	{
+		if(mask[i])
+			out.push_back(bonuses[i]);
+	}
 }
 
 DLL_LINKAGE std::ostream & operator<<(std::ostream &out, const BonusList &bonusList)
@@ -21,8 +21,6 @@ public:
 
 private:
 	TInternalContainer bonuses;
-	bool belongsToTree;
-	void changed() const;
 
 public:
 	using const_reference = TInternalContainer::const_reference;
@@ -31,7 +29,7 @@ public:
 	using const_iterator = TInternalContainer::const_iterator;
 	using iterator = TInternalContainer::iterator;
 
-	BonusList(bool BelongsToTree = false);
+	BonusList() = default;
 	BonusList(const BonusList &bonusList);
 	BonusList(BonusList && other) noexcept;
 	BonusList& operator=(const BonusList &bonusList);
@@ -108,6 +106,36 @@ public:
 	}
 };
 
+/// Packed copy of bonus fields used by BonusFieldSelector and by total value computation, stored in parallel arrays
+/// Allows filtering and summing of long bonus lists without touching Bonus objects themselves
+class DLL_LINKAGE PackedBonusList
+{
+	std::vector<BonusType> types;
+	std::vector<BonusSource> sources;
+	std::vector<BonusSource> targetSourceTypes;
+	std::vector<BonusValueType> valTypes;
+	std::vector<BonusDuration::Type> durations;
+	std::vector<int16_t> turnsRemain;
+	std::vector<int32_t> vals;
+	std::vector<uint64_t> subtypes;
+	std::vector<uint64_t> sids;
+
+public:
+	/// Rebuilds packed fields from list, list must not be modified while packed data is in use
+	void build(const BonusList & bonuses);
+	void clear();
+	size_t size() const { return types.size(); }
+
+	/// Sets mask[i] to 1 if i-th bonus matches selector and to 0 otherwise
+	void filter(std::vector<uint8_t> & mask, const BonusFieldSelector & selector) const;
+
+	/// Same as totalValue() of list containing only bonuses with non-zero mask
+	int totalValue(const std::vector<uint8_t> & mask) const;
+
+	/// Same as bonuses.getBonuses(out, selector), bonuses must be the list this object was built from
+	void getBonuses(BonusList & out, const BonusList & bonuses, const BonusFieldSelector & selector) const;
+};
+
 DLL_LINKAGE std::ostream & operator<<(std::ostream &out, const BonusList &bonusList);
 
 
@@ -0,0 +1,202 @@
+/*
+ * BonusQueryCache.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "BonusQueryCache.h"
+
+#include "BonusList.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace
+{
+	constexpr uint64_t FIELD_TYPE = 1ull << 60;
+	constexpr uint64_t FIELD_SUBTYPE = 1ull << 61;
+	constexpr uint64_t FIELD_SOURCE = 1ull << 63;
+
+	constexpr int SHIFT_TYPE = 52;
+	constexpr int SHIFT_SOURCE = 36;
+	constexpr int SHIFT_SUBTYPE_INDEX = 32;
+
+	constexpr uint64_t ARGUMENT_INFO = 1ull << 32;
+	constexpr uint64_t ARGUMENT_SOURCE_ID = 2ull << 32;
+
+	uint64_t packType(BonusType type)
+	{
+		return FIELD_TYPE | (static_cast<uint64_t>(type) << SHIFT_TYPE);
+	}
+
+	uint64_t packSubtype(BonusSubtypeID subtype)
+	{
+		return FIELD_SUBTYPE
+			| (static_cast<uint64_t>(subtype.getIndex()) << SHIFT_SUBTYPE_INDEX)
+			| static_cast<uint32_t>(subtype.getNum());
+	}
+
+	uint64_t packSource(BonusSource source)
+	{
+		return FIELD_SOURCE | (static_cast<uint64_t>(source) << SHIFT_SOURCE);
+	}
+
+	uint64_t packArgument(uint64_t kind, int32_t value)
+	{
+		return kind | static_cast<uint32_t>(value);
+	}
+
+	uint64_t mixBits(uint64_t value)
+	{
+		// splitmix64 finalizer
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9ull;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111ebull;
+		value ^= value >> 31;
+		return value;
+	}
+
+	uint64_t hashName(std::string_view name)
+	{
+		// FNV-1a
+		uint64_t result = 0xcbf29ce484222325ull;
+		for(char c : name)
+		{
+			result ^= static_cast<uint8_t>(c);
+			result *= 0x100000001b3ull;
+		}
+		return result;
+	}
+}
+
+BonusCacheKey::BonusCacheKey(uint64_t fields, uint64_t argument)
+	: fields(fields)
+	, argument(argument)
+	, hashValue(std::max<uint64_t>(1, mixBits(fields ^ mixBits(argument))))
+{
+}
+
+BonusCacheKey::BonusCacheKey(const std::string & name)
+	: hashValue(name.empty() ? 0 : std::max<uint64_t>(1, hashName(name)))
+	, name(name)
+{
+}
+
+BonusCacheKey::BonusCacheKey(const char * name)
+	: name(name)
+{
+	if(!this->name.empty())
+		hashValue = std::max<uint64_t>(1, hashName(this->name));
+}
+
+BonusCacheKey BonusCacheKey::type(BonusType type)
+{
+	return BonusCacheKey(packType(type));
+}
+
+BonusCacheKey BonusCacheKey::typeSubtype(BonusType type, BonusSubtypeID subtype)
+{
+	return BonusCacheKey(packType(type) | packSubtype(subtype));
+}
+
+BonusCacheKey BonusCacheKey::typeInfo(BonusType type, int32_t info)
+{
+	return BonusCacheKey(packType(type), packArgument(ARGUMENT_INFO, info));
+}
+
+BonusCacheKey BonusCacheKey::typeSubtypeInfo(BonusType type, BonusSubtypeID subtype, int32_t info)
+{
+	return BonusCacheKey(packType(type) | packSubtype(subtype), packArgument(ARGUMENT_INFO, info));
+}
+
+BonusCacheKey BonusCacheKey::typeSubtypeSource(BonusType type, BonusSubtypeID subtype, BonusSource source)
+{
+	return BonusCacheKey(packType(type) | packSubtype(subtype) | packSource(source));
+}
+
+BonusCacheKey BonusCacheKey::source(BonusSource source, BonusSourceID sourceID)
+{
+	return BonusCacheKey(packSource(source), packArgument(ARGUMENT_SOURCE_ID, sourceID.getNum()));
+}
+
+size_t BonusQueryCache::findSlot(const std::vector<Entry> & table, const BonusCacheKey & key) const
+{
+	const size_t mask = table.size() - 1;
+	size_t slot = key.hash() & mask;
+
+	// linear probing, table always has at least one empty slot
+	while(table[slot].hash != 0)
+	{
+		const auto & entry = table[slot];
+		if(entry.hash == key.hash() && entry.fields == key.getFields() && entry.argument == key.getArgument() && entry.name == key.getName())
+			break;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void BonusQueryCache::grow()
+{
+	std::vector<Entry> newEntries(entries.empty() ? 16 : entries.size() * 2);
+
+	for(auto & entry : entries)
+	{
+		if(entry.hash == 0)
+			continue;
+
+		size_t slot = entry.hash & (newEntries.size() - 1);
+		while(newEntries[slot].hash != 0)
+			slot = (slot + 1) & (newEntries.size() - 1);
+
+		newEntries[slot] = std::move(entry);
+	}
+	entries = std::move(newEntries);
+}
+
+TBonusListPtr BonusQueryCache::find(const BonusCacheKey & key) const
+{
+	if(usedEntries == 0 || !key.isCacheable())
+		return nullptr;
+
+	return entries[findSlot(entries, key)].bonuses;
+}
+
+void BonusQueryCache::insert(const BonusCacheKey & key, const TBonusListPtr & bonuses)
+{
+	assert(key.isCacheable());
+
+	// keep load factor below 3/4 to keep probe sequences short
+	if((usedEntries + 1) * 4 > entries.size() * 3)
+		grow();
+
+	auto & entry = entries[findSlot(entries, key)];
+	if(entry.hash == 0)
+	{
+		entry.hash = key.hash();
+		entry.fields = key.getFields();
+		entry.argument = key.getArgument();
+		entry.name.assign(key.getName());
+		usedEntries++;
+	}
+	entry.bonuses = bonuses;
+}
+
+void BonusQueryCache::clear()
+{
+	if(usedEntries == 0)
+		return;
+
+	for(auto & entry : entries)
+	{
+		entry.hash = 0;
+		entry.bonuses.reset();
+	}
+	usedEntries = 0;
+}
+
+VCMI_LIB_NAMESPACE_END
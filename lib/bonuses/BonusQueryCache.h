@@ -0,0 +1,116 @@
+/*
+ * BonusQueryCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "Bonus.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Compact identifier of bonus query that allows caching of its result in bonus system node
+/// Typed keys are built from bonus type, subtype, source and additional info or source id and can be created without any allocations
+/// Named keys are created from string that must uniquely identify selector that is used with this key
+class DLL_LINKAGE BonusCacheKey
+{
+	uint64_t fields = 0; //packed fields of typed key, 0 for named keys
+	uint64_t argument = 0; //additional info or source id of typed key, tagged with its kind
+	uint64_t hashValue = 0; //0 if query should not be cached
+	std::string_view name; //only for named keys, must outlive the query
+
+	explicit BonusCacheKey(uint64_t fields, uint64_t argument = 0);
+
+public:
+	/// Creates key for query that should not be cached
+	BonusCacheKey() = default;
+
+	/// Creates named key, empty string disables caching
+	BonusCacheKey(const std::string & name);
+	BonusCacheKey(const char * name);
+
+	/// Key for Selector::type()(type)
+	static BonusCacheKey type(BonusType type);
+	/// Key for Selector::typeSubtype(type, subtype)
+	static BonusCacheKey typeSubtype(BonusType type, BonusSubtypeID subtype);
+	/// Key for Selector::type()(type).And(Selector::info()(info))
+	static BonusCacheKey typeInfo(BonusType type, int32_t info);
+	/// Key for Selector::typeSubtypeInfo(type, subtype, info)
+	static BonusCacheKey typeSubtypeInfo(BonusType type, BonusSubtypeID subtype, int32_t info);
+	/// Key for Selector::typeSubtype(type, subtype).And(Selector::sourceType()(source))
+	static BonusCacheKey typeSubtypeSource(BonusType type, BonusSubtypeID subtype, BonusSource source);
+	/// Key for Selector::source(source, sourceID)
+	static BonusCacheKey source(BonusSource source, BonusSourceID sourceID);
+
+	bool isCacheable() const
+	{
+		return hashValue != 0;
+	}
+
+	uint64_t hash() const
+	{
+		return hashValue;
+	}
+
+	uint64_t getFields() const
+	{
+		return fields;
+	}
+
+	uint64_t getArgument() const
+	{
+		return argument;
+	}
+
+	std::string_view getName() const
+	{
+		return name;
+	}
+
+	bool operator==(const BonusCacheKey & other) const
+	{
+		return hashValue == other.hashValue && fields == other.fields && argument == other.argument && name == other.name;
+	}
+};
+
+/// Open-addressing hash table that stores results of cacheable bonus queries of single bonus system node
+/// Not thread-safe, synchronization is responsibility of the owner
+class DLL_LINKAGE BonusQueryCache
+{
+	struct Entry
+	{
+		uint64_t hash = 0; //0 - empty slot
+		uint64_t fields = 0;
+		uint64_t argument = 0;
+		std::string name;
+		TBonusListPtr bonuses;
+	};
+
+	std::vector<Entry> entries; //size is always power of two
+	size_t usedEntries = 0;
+
+	size_t findSlot(const std::vector<Entry> & table, const BonusCacheKey & key) const;
+	void grow();
+
+public:
+	/// Returns cached result or nullptr if there is none
+	TBonusListPtr find(const BonusCacheKey & key) const;
+
+	/// Stores query result, key must be cacheable
+	void insert(const BonusCacheKey & key, const TBonusListPtr & bonuses);
+
+	/// Removes all results but keeps allocated storage for reuse
+	void clear();
+
+	size_t size() const
+	{
+		return usedEntries;
+	}
+};
+
+VCMI_LIB_NAMESPACE_END
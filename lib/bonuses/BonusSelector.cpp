@@ -13,17 +13,81 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+BonusFieldSelector::BonusFieldSelector(BonusType type)
+	: fields(TYPE)
+	, type(type)
+{
+}
+
+BonusFieldSelector::BonusFieldSelector(BonusSubtypeID subtype)
+	: fields(SUBTYPE)
+	, subtype(subtype)
+{
+}
+
+BonusFieldSelector::BonusFieldSelector(BonusSource source)
+	: fields(SOURCE)
+	, source(source)
+{
+}
+
+BonusFieldSelector::BonusFieldSelector(BonusValueType valType)
+	: fields(VALUE_TYPE)
+	, valType(valType)
+{
+}
+
+BonusFieldSelector BonusFieldSelector::nothing()
+{
+	BonusFieldSelector result;
+	result.fields = NOTHING;
+	return result;
+}
+
+BonusFieldSelector BonusFieldSelector::And(const BonusFieldSelector & other) const
+{
+	BonusFieldSelector result = *this;
+	const uint8_t common = fields & other.fields;
+
+	if((common & TYPE) && type != other.type)
+		return nothing();
+	if((common & SUBTYPE) && subtype != other.subtype)
+		return nothing();
+	if((common & SOURCE) && source != other.source)
+		return nothing();
+	if((common & SOURCE_ID) && sid != other.sid)
+		return nothing();
+	if((common & VALUE_TYPE) && valType != other.valType)
+		return nothing();
+
+	if(other.fields & TYPE)
+		result.type = other.type;
+	if(other.fields & SUBTYPE)
+		result.subtype = other.subtype;
+	if(other.fields & SOURCE)
+		result.source = other.source;
+	if(other.fields & SOURCE_ID)
+		result.sid = other.sid;
+	if(other.fields & VALUE_TYPE)
+		result.valType = other.valType;
+	if(other.fields & LASTS_TURNS)
+		result.turns = (fields & LASTS_TURNS) ? std::max(turns, other.turns) : other.turns;
+
+	result.fields |= other.fields;
+	return result;
+}
+
 namespace Selector
 {
 	DLL_LINKAGE const CSelectFieldEqual<BonusType> & type()
 	{
-		static const CSelectFieldEqual<BonusType> stype(&Bonus::type);
+		static const CSelectFieldEqual<BonusType> stype(&Bonus::type, true);
 		return stype;
 	}
 
 	DLL_LINKAGE const CSelectFieldEqual<BonusSubtypeID> & subtype()
 	{
-		static const CSelectFieldEqual<BonusSubtypeID> ssubtype(&Bonus::subtype);
+		static const CSelectFieldEqual<BonusSubtypeID> ssubtype(&Bonus::subtype, true);
 		return ssubtype;
 	}
 
@@ -35,7 +99,7 @@ namespace Selector
 
 	DLL_LINKAGE const CSelectFieldEqual<BonusSource> & sourceType()
 	{
-		static const CSelectFieldEqual<BonusSource> ssourceType(&Bonus::source);
+		static const CSelectFieldEqual<BonusSource> ssourceType(&Bonus::source, true);
 		return ssourceType;
 	}
 
@@ -51,9 +115,16 @@ namespace Selector
 		return seffectRange;
 	}
 
-	DLL_LINKAGE CWillLastTurns turns(int turns)
+	DLL_LINKAGE CSelector turns(int turns)
 	{
-		return CWillLastTurns(turns);
+		//every present effect will last zero (or "less") turns
+		if(turns <= 0)
+			return BonusFieldSelector();
+
+		BonusFieldSelector result;
+		result.fields = BonusFieldSelector::LASTS_TURNS;
+		result.turns = turns;
+		return result;
 	}
 
 	DLL_LINKAGE CWillLastDays days(int days)
@@ -68,25 +139,26 @@ namespace Selector
 
 	CSelector DLL_LINKAGE typeSubtypeInfo(BonusType type, BonusSubtypeID subtype, const CAddInfo & info)
 	{
-		return CSelectFieldEqual<BonusType>(&Bonus::type)(type)
-			.And(CSelectFieldEqual<BonusSubtypeID>(&Bonus::subtype)(subtype))
+		return typeSubtype(type, subtype)
 			.And(CSelectFieldEqual<CAddInfo>(&Bonus::additionalInfo)(info));
 	}
 
 	CSelector DLL_LINKAGE source(BonusSource source, BonusSourceID sourceID)
 	{
-		return CSelectFieldEqual<BonusSource>(&Bonus::source)(source)
-			.And(CSelectFieldEqual<BonusSourceID>(&Bonus::sid)(sourceID));
+		BonusFieldSelector result(source);
+		result.fields |= BonusFieldSelector::SOURCE_ID;
+		result.sid = sourceID;
+		return result;
 	}
 
 	CSelector DLL_LINKAGE sourceTypeSel(BonusSource source)
 	{
-		return CSelectFieldEqual<BonusSource>(&Bonus::source)(source);
+		return BonusFieldSelector(source);
 	}
 
 	CSelector DLL_LINKAGE valueType(BonusValueType valType)
 	{
-		return CSelectFieldEqual<BonusValueType>(&Bonus::valType)(valType);
+		return BonusFieldSelector(valType);
 	}
 
 	CSelector DLL_LINKAGE typeSubtypeValueType(BonusType Type, BonusSubtypeID Subtype, BonusValueType valType)
@@ -96,8 +168,8 @@ namespace Selector
 				.And(valueType(valType));
 	}
 
-	DLL_LINKAGE CSelector all([](const Bonus * b){return true;});
-	DLL_LINKAGE CSelector none([](const Bonus * b){return false;});
+	DLL_LINKAGE CSelector all(BonusFieldSelector{});
+	DLL_LINKAGE CSelector none(BonusFieldSelector::nothing());
 }
 
 VCMI_LIB_NAMESPACE_END
@@ -14,29 +14,103 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Selector that compares common bonus fields against fixed values, stored as plain data
+/// Conjunction of such selectors is again plain data, so checking a bonus needs no indirect calls
+class DLL_LINKAGE BonusFieldSelector
+{
+public:
+	enum EField : uint8_t
+	{
+		TYPE = 1 << 0,
+		SUBTYPE = 1 << 1,
+		SOURCE = 1 << 2,
+		SOURCE_ID = 1 << 3,
+		VALUE_TYPE = 1 << 4,
+		LASTS_TURNS = 1 << 5, //bonuses that expire after N turns must have more than "turns" turns remaining
+		NOTHING = 1 << 7 //set if conjunction requires different values of the same field
+	};
+
+	/// Types of fields that can be compared by this selector
+	template<typename T>
+	static constexpr bool isFieldType = std::is_same_v<T, BonusType> || std::is_same_v<T, BonusSubtypeID> || std::is_same_v<T, BonusSource> || std::is_same_v<T, BonusValueType>;
+
+	uint8_t fields = 0; //compared fields, selector without fields selects all bonuses
+	BonusType type = BonusType::NONE;
+	BonusSource source = BonusSource::OTHER;
+	BonusValueType valType = BonusValueType::ADDITIVE_VALUE;
+	BonusSubtypeID subtype;
+	BonusSourceID sid;
+	int turns = 0;
+
+	BonusFieldSelector() = default;
+	explicit BonusFieldSelector(BonusType type);
+	explicit BonusFieldSelector(BonusSubtypeID subtype);
+	explicit BonusFieldSelector(BonusSource source);
+	explicit BonusFieldSelector(BonusValueType valType);
+
+	static BonusFieldSelector nothing();
+
+	/// Selector that requires both this and other to match
+	BonusFieldSelector And(const BonusFieldSelector & other) const;
+
+	bool operator()(const Bonus * b) const
+	{
+		// single byte fields are compared without branches, identifiers only if requested
+		bool matches = ((fields & NOTHING) == 0)
+			& (!(fields & TYPE) | (b->type == type))
+			& (!(fields & SOURCE) | (b->source == source))
+			& (!(fields & VALUE_TYPE) | (b->valType == valType))
+			& (!(fields & LASTS_TURNS) | !(b->duration & BonusDuration::N_TURNS) | (b->turnsRemain > turns));
+
+		return matches
+			&& (!(fields & SUBTYPE) || b->subtype == subtype)
+			&& (!(fields & SOURCE_ID) || b->sid == sid);
+	}
+};
+
 class CSelector : std::function<bool(const Bonus*)>
 {
 	using TBase = std::function<bool(const Bonus*)>;
+
+	BonusFieldSelector fieldSelector;
+	bool isFieldSelector = false; //if set, fieldSelector is used instead of type-erased function
 public:
 	CSelector() = default;
 	template<typename T>
-	CSelector(const T &t,	//SFINAE trick -> include this c-tor in overload resolution only if parameter is class
-							//(includes functors, lambdas) or function. Without that VC is going mad about ambiguities.
-		typename std::enable_if_t < std::is_class_v<T> || std::is_function_v<T> > *dummy = nullptr)
+	CSelector(const T &t,	//SFINAE trick -> include this c-tor in overload resolution only if parameter is callable with bonus
+							//(functors, lambdas, functions). Without that there are ambiguities with other class parameters, e.g. caching keys.
+		typename std::enable_if_t < std::is_invocable_r_v<bool, std::decay_t<T> &, const Bonus *> > *dummy = nullptr)
 		: TBase(t)
 	{}
 
+	CSelector(const BonusFieldSelector & selector)
+		: fieldSelector(selector)
+		, isFieldSelector(true)
+	{}
+
 	CSelector(std::nullptr_t)
 	{}
 
 	CSelector And(CSelector rhs) const
 	{
+		if(isFieldSelector && rhs.isFieldSelector)
+			return fieldSelector.And(rhs.fieldSelector);
+		if(isFieldSelector && fieldSelector.fields == 0)
+			return rhs;
+		if(rhs.isFieldSelector && rhs.fieldSelector.fields == 0)
+			return *this;
+
 		//lambda may likely outlive "this" (it can be even a temporary) => we copy the OBJECT (not pointer)
 		auto thisCopy = *this;
 		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) && rhs(b); };
 	}
 	CSelector Or(CSelector rhs) const
 	{
+		if(isFieldSelector && fieldSelector.fields == BonusFieldSelector::NOTHING)
+			return rhs;
+		if(rhs.isFieldSelector && rhs.fieldSelector.fields == BonusFieldSelector::NOTHING)
+			return *this;
+
 		auto thisCopy = *this;
 		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) || rhs(b); };
 	}
@@ -49,12 +123,20 @@ public:
 
 	bool operator()(const Bonus *b) const
 	{
+		if(isFieldSelector)
+			return fieldSelector(b);
 		return TBase::operator()(b);
 	}
 
 	operator bool() const
 	{
-		return !!static_cast<const TBase&>(*this);
+		return isFieldSelector || !!static_cast<const TBase&>(*this);
+	}
+
+	/// Returns data form of this selector, or nullptr if selector is an arbitrary function
+	const BonusFieldSelector * getFieldSelector() const
+	{
+		return isFieldSelector ? &fieldSelector : nullptr;
 	}
 };
 
@@ -62,15 +144,23 @@ template<typename T>
 class CSelectFieldEqual
 {
 	T Bonus::*ptr;
+	bool asFieldSelector; //field is compared by BonusFieldSelector
 
 public:
-	CSelectFieldEqual(T Bonus::*Ptr)
+	CSelectFieldEqual(T Bonus::*Ptr, bool asFieldSelector = false)
 		: ptr(Ptr)
+		, asFieldSelector(asFieldSelector)
 	{
 	}
 
 	CSelector operator()(const T &valueToCompareAgainst) const
 	{
+		if constexpr(BonusFieldSelector::isFieldType<T>)
+		{
+			if(asFieldSelector)
+				return BonusFieldSelector(valueToCompareAgainst);
+		}
+
 		auto ptr2 = ptr; //We need a COPY because we don't want to reference this (might be outlived by lambda)
 		return [ptr2, valueToCompareAgainst](const Bonus *bonus)
 		{
@@ -79,22 +169,6 @@ public:
 	}
 };
 
-class DLL_LINKAGE CWillLastTurns
-{
-	int turnsRequested;
-public:
-	CWillLastTurns(int turnsRequested):
-		turnsRequested(turnsRequested)
-	{}
-
-	bool operator()(const Bonus *bonus) const
-	{
-		return turnsRequested <= 0					//every present effect will last zero (or "less") turns
-			|| !Bonus::NTurns(bonus) //so do every not expriing after N-turns effect
-			|| bonus->turnsRemain > turnsRequested;
-	}
-};
-
 class DLL_LINKAGE CWillLastDays
 {
 	int daysRequested;
@@ -127,7 +201,7 @@ namespace Selector
 	extern DLL_LINKAGE const CSelectFieldEqual<BonusSource> & sourceType();
 	extern DLL_LINKAGE const CSelectFieldEqual<BonusSource> & targetSourceType();
 	extern DLL_LINKAGE const CSelectFieldEqual<BonusLimitEffect> & effectRange();
-	CWillLastTurns DLL_LINKAGE turns(int turns);
+	CSelector DLL_LINKAGE turns(int turns);
 	CWillLastDays DLL_LINKAGE days(int days);
 
 	CSelector DLL_LINKAGE typeSubtype(BonusType Type, BonusSubtypeID Subtype);
@@ -15,33 +15,40 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+namespace
+{
+	template<typename T>
+	void swapAtomic(std::atomic<T> & left, std::atomic<T> & right)
+	{
+		left = right.exchange(left.load());
+	}
+}
+
 ///CBonusProxy
 CBonusProxy::CBonusProxy(const IBonusBearer * Target, CSelector Selector):
-	bonusListCachedLast(0),
-	target(Target),
 	selector(std::move(Selector)),
+	target(Target),
+	bonusListCachedLast(0),
 	currentBonusListIndex(0)
 {
 }
 
 CBonusProxy::CBonusProxy(const CBonusProxy & other):
-	bonusListCachedLast(other.bonusListCachedLast),
-	target(other.target),
 	selector(other.selector),
-	currentBonusListIndex(other.currentBonusListIndex)
+	target(other.target),
+	bonusListCachedLast(other.bonusListCachedLast.load()),
+	currentBonusListIndex(other.currentBonusListIndex.load())
 {
 	bonusList[currentBonusListIndex] = other.bonusList[currentBonusListIndex];
 }
 
 CBonusProxy::CBonusProxy(CBonusProxy && other) noexcept:
-	bonusListCachedLast(0),
 	target(other.target),
-	currentBonusListIndex(0)
+	bonusListCachedLast(other.bonusListCachedLast.exchange(0)),
+	currentBonusListIndex(other.currentBonusListIndex.exchange(0))
 {
-	std::swap(bonusListCachedLast, other.bonusListCachedLast);
 	std::swap(selector, other.selector);
 	std::swap(bonusList, other.bonusList);
-	std::swap(currentBonusListIndex, other.currentBonusListIndex);
 }
 
 CBonusProxy & CBonusProxy::operator=(const CBonusProxy & other)
@@ -50,17 +57,17 @@ CBonusProxy & CBonusProxy::operator=(const CBonusProxy & other)
 
 	selector = other.selector;
 	swapBonusList(other.bonusList[other.currentBonusListIndex]);
-	bonusListCachedLast = other.bonusListCachedLast;
+	bonusListCachedLast = other.bonusListCachedLast.load();
 
 	return *this;
 }
 
 CBonusProxy & CBonusProxy::operator=(CBonusProxy && other) noexcept
 {
-	std::swap(bonusListCachedLast, other.bonusListCachedLast);
+	swapAtomic(bonusListCachedLast, other.bonusListCachedLast);
 	std::swap(selector, other.selector);
 	std::swap(bonusList, other.bonusList);
-	std::swap(currentBonusListIndex, other.currentBonusListIndex);
+	swapAtomic(currentBonusListIndex, other.currentBonusListIndex);
 
 	return *this;
 }
@@ -116,11 +123,27 @@ CTotalsProxy::CTotalsProxy(const IBonusBearer * Target, CSelector Selector, int
 CTotalsProxy::CTotalsProxy(const CTotalsProxy & other)
 	: CBonusProxy(other),
 	initialValue(other.initialValue),
-	meleeCachedLast(other.meleeCachedLast),
-	meleeValue(other.meleeValue),
-	rangedCachedLast(other.rangedCachedLast),
-	rangedValue(other.rangedValue)
+	valueCachedLast(other.valueCachedLast.load()),
+	value(other.value.load()),
+	meleeCachedLast(other.meleeCachedLast.load()),
+	meleeValue(other.meleeValue.load()),
+	rangedCachedLast(other.rangedCachedLast.load()),
+	rangedValue(other.rangedValue.load())
+{
+}
+
+CTotalsProxy & CTotalsProxy::operator=(const CTotalsProxy & other)
 {
+	CBonusProxy::operator=(other);
+	initialValue = other.initialValue;
+	value = other.value.load();
+	valueCachedLast = other.valueCachedLast.load();
+	meleeValue = other.meleeValue.load();
+	meleeCachedLast = other.meleeCachedLast.load();
+	rangedValue = other.rangedValue.load();
+	rangedCachedLast = other.rangedCachedLast.load();
+
+	return *this;
 }
 
 int CTotalsProxy::getValue() const
@@ -131,8 +154,10 @@ int CTotalsProxy::getValue() const
 	{
 		auto bonuses = getBonusList();
 
-		value = initialValue + bonuses->totalValue();
+		const int newValue = initialValue + bonuses->totalValue();
+		value = newValue;
 		valueCachedLast = treeVersion;
+		return newValue;
 	}
 	return value;
 }
@@ -144,8 +169,10 @@ int CTotalsProxy::getValueAndList(TConstBonusListPtr & outBonusList) const
 
 	if(treeVersion != valueCachedLast)
 	{
-		value = initialValue + outBonusList->totalValue();
+		const int newValue = initialValue + outBonusList->totalValue();
+		value = newValue;
 		valueCachedLast = treeVersion;
+		return newValue;
 	}
 	return value;
 }
@@ -159,8 +186,10 @@ int CTotalsProxy::getMeleeValue() const
 	if(treeVersion != meleeCachedLast)
 	{
 		auto bonuses = target->getBonuses(selector, limit);
-		meleeValue = initialValue + bonuses->totalValue();
+		const int newValue = initialValue + bonuses->totalValue();
+		meleeValue = newValue;
 		meleeCachedLast = treeVersion;
+		return newValue;
 	}
 
 	return meleeValue;
@@ -175,8 +204,10 @@ int CTotalsProxy::getRangedValue() const
 	if(treeVersion != rangedCachedLast)
 	{
 		auto bonuses = target->getBonuses(selector, limit);
-		rangedValue = initialValue + bonuses->totalValue();
+		const int newValue = initialValue + bonuses->totalValue();
+		rangedValue = newValue;
 		rangedCachedLast = treeVersion;
+		return newValue;
 	}
 
 	return rangedValue;
@@ -192,7 +223,23 @@ CCheckProxy::CCheckProxy(const IBonusBearer * Target, CSelector Selector):
 }
 
 //This constructor should be placed here to avoid side effects
-CCheckProxy::CCheckProxy(const CCheckProxy & other) = default;
+CCheckProxy::CCheckProxy(const CCheckProxy & other):
+	target(other.target),
+	selector(other.selector),
+	cachedLast(other.cachedLast.load()),
+	hasBonus(other.hasBonus.load())
+{
+}
+
+CCheckProxy & CCheckProxy::operator=(const CCheckProxy & other)
+{
+	target = other.target;
+	selector = other.selector;
+	hasBonus = other.hasBonus.load();
+	cachedLast = other.cachedLast.load();
+
+	return *this;
+}
 
 bool CCheckProxy::getHasBonus() const
 {
@@ -200,8 +247,10 @@ bool CCheckProxy::getHasBonus() const
 
 	if(treeVersion != cachedLast)
 	{
-		hasBonus = target->hasBonus(selector);
+		const bool newValue = target->hasBonus(selector);
+		hasBonus = newValue;
 		cachedLast = treeVersion;
+		return newValue;
 	}
 
 	return hasBonus;
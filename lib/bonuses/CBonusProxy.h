@@ -15,6 +15,9 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Proxies cache selected bonuses of their target until its tree version changes.
+/// Cache may be refreshed from several threads at once (e.g. parallel AI evaluation of the same unit),
+/// values are stored before their version, so thread that sees current version also sees matching value
 class DLL_LINKAGE CBonusProxy
 {
 public:
@@ -30,9 +33,9 @@ public:
 protected:
 	CSelector selector;
 	const IBonusBearer * target;
-	mutable int64_t bonusListCachedLast;
+	mutable std::atomic<int64_t> bonusListCachedLast;
 	mutable TConstBonusListPtr bonusList[2];
-	mutable int currentBonusListIndex;
+	mutable std::atomic<int> currentBonusListIndex;
 	mutable boost::mutex swapGuard;
 	void swapBonusList(TConstBonusListPtr other) const;
 };
@@ -44,7 +47,7 @@ public:
 	CTotalsProxy(const CTotalsProxy & other);
 	CTotalsProxy(CTotalsProxy && other) = delete;
 
-	CTotalsProxy & operator=(const CTotalsProxy & other) = default;
+	CTotalsProxy & operator=(const CTotalsProxy & other);
 	CTotalsProxy & operator=(CTotalsProxy && other) = delete;
 
 	int getMeleeValue() const;
@@ -60,14 +63,14 @@ public:
 private:
 	int initialValue;
 
-	mutable int64_t valueCachedLast = 0;
-	mutable int value = 0;
+	mutable std::atomic<int64_t> valueCachedLast{0};
+	mutable std::atomic<int> value{0};
 
-	mutable int64_t meleeCachedLast;
-	mutable int meleeValue;
+	mutable std::atomic<int64_t> meleeCachedLast;
+	mutable std::atomic<int> meleeValue;
 
-	mutable int64_t rangedCachedLast;
-	mutable int rangedValue;
+	mutable std::atomic<int64_t> rangedCachedLast;
+	mutable std::atomic<int> rangedValue;
 };
 
 class DLL_LINKAGE CCheckProxy
@@ -75,7 +78,7 @@ class DLL_LINKAGE CCheckProxy
 public:
 	CCheckProxy(const IBonusBearer * Target, CSelector Selector);
 	CCheckProxy(const CCheckProxy & other);
-	CCheckProxy& operator= (const CCheckProxy & other) = default;
+	CCheckProxy& operator= (const CCheckProxy & other);
 
 	bool getHasBonus() const;
 
@@ -83,8 +86,8 @@ private:
 	const IBonusBearer * target;
 	CSelector selector;
 
-	mutable int64_t cachedLast;
-	mutable bool hasBonus;
+	mutable std::atomic<int64_t> cachedLast;
+	mutable std::atomic<bool> hasBonus;
 };
 
 VCMI_LIB_NAMESPACE_END
\ No newline at end of file
@@ -18,6 +18,7 @@
 VCMI_LIB_NAMESPACE_BEGIN
 
 std::atomic<int64_t> CBonusSystemNode::treeChanged(1);
+std::atomic<int64_t> CBonusSystemNode::globalChanged(1);
 constexpr bool CBonusSystemNode::cachingEnabled = true;
 
 std::shared_ptr<Bonus> CBonusSystemNode::getLocalBonus(const CSelector & selector)
@@ -107,50 +108,56 @@ void CBonusSystemNode::getAllBonusesRec(BonusList &out, const CSelector & select
 	}
 }
 
-TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr) const
+TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, const CSelector &limit, const BonusCacheKey &cachingKey) const
 {
 	if (CBonusSystemNode::cachingEnabled)
 	{
-		// Exclusive access for one thread
-		boost::lock_guard<boost::mutex> lock(sync);
-
-		// If the bonus system tree changes(state of a single node or the relations to each other) then
-		// cache all bonus objects. Selector objects doesn't matter.
-		if (cachedLast != treeChanged)
 		{
-			BonusList allBonuses;
-			allBonuses.reserve(cachedBonuses.capacity()); //we assume we'll get about the same number of bonuses
+			// Shared access is enough as long as cache is up to date
+			boost::shared_lock<boost::shared_mutex> lock(sync);
 
-			cachedBonuses.clear();
-			cachedRequests.clear();
+			if(cachedLast == getTreeVersion())
+			{
+				if(cachingKey.isCacheable())
+				{
+					auto cached = cachedRequests.find(cachingKey);
+					if(cached)
+						return cached;
+				}
+				else
+				{
+					auto ret = std::make_shared<BonusList>();
+					getCachedBonuses(*ret, selector, limit);
+					return ret;
+				}
+			}
+		}
 
-			getAllBonusesRec(allBonuses, Selector::all);
-			limitBonuses(allBonuses, cachedBonuses);
-			cachedBonuses.stackBonuses();
+		// Exclusive access for one thread
+		boost::lock_guard<boost::shared_mutex> lock(sync);
 
-			cachedLast = treeChanged;
-		}
+		updateCachedBonuses();
 
-		// If a bonus system request comes with a caching string then look up in the map if there are any
-		// pre-calculated bonus results. Limiters can't be cached so they have to be calculated.
-		if(!cachingStr.empty())
+		// If a bonus system request comes with a caching key then look up in the cache if there are any
+		// pre-calculated bonus results (another thread might have added it meanwhile).
+		if(cachingKey.isCacheable())
 		{
-			auto it = cachedRequests.find(cachingStr);
-			if(it != cachedRequests.end())
+			auto cached = cachedRequests.find(cachingKey);
+			if(cached)
 			{
 				//Cached list contains bonuses for our query with applied limiters
-				return it->second;
+				return cached;
 			}
 		}
 
 		//We still don't have the bonuses (didn't returned them from cache)
 		//Perform bonus selection
 		auto ret = std::make_shared<BonusList>();
-		cachedBonuses.getBonuses(*ret, selector, limit);
+		getCachedBonuses(*ret, selector, limit);
 
 		// Save the results in the cache
-		if(!cachingStr.empty())
-			cachedRequests[cachingStr] = ret;
+		if(cachingKey.isCacheable())
+			cachedRequests.insert(cachingKey, ret);
 
 		return ret;
 	}
@@ -160,6 +167,67 @@ TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, co
 	}
 }
 
+void CBonusSystemNode::updateCachedBonuses() const
+{
+	// If this node or any of its ancestors has changed (state of a single node or the relations to each other) then
+	// cache all bonus objects. Selector objects doesn't matter.
+	const auto treeVersion = getTreeVersion();
+	if (cachedLast == treeVersion)
+		return;
+
+	BonusList allBonuses;
+	allBonuses.reserve(cachedBonuses.capacity()); //we assume we'll get about the same number of bonuses
+
+	cachedBonuses.clear();
+	cachedRequests.clear();
+
+	getAllBonusesRec(allBonuses, Selector::all);
+	limitBonuses(allBonuses, cachedBonuses);
+	cachedBonuses.stackBonuses();
+	cachedBonusesPacked.build(cachedBonuses);
+
+	cachedLast = treeVersion;
+}
+
+int CBonusSystemNode::totalValueOfBonuses(const CSelector &selector, const BonusCacheKey &cachingKey) const
+{
+	const auto * fieldSelector = selector.getFieldSelector();
+
+	if (!CBonusSystemNode::cachingEnabled || !fieldSelector)
+		return IBonusBearer::totalValueOfBonuses(selector, cachingKey);
+
+	// values are summed on packed data, no bonus list is built for the query
+	std::vector<uint8_t> mask;
+	{
+		boost::shared_lock<boost::shared_mutex> lock(sync);
+
+		if(cachedLast == getTreeVersion())
+		{
+			cachedBonusesPacked.filter(mask, *fieldSelector);
+			return cachedBonusesPacked.totalValue(mask);
+		}
+	}
+
+	boost::lock_guard<boost::shared_mutex> lock(sync);
+	updateCachedBonuses();
+	cachedBonusesPacked.filter(mask, *fieldSelector);
+	return cachedBonusesPacked.totalValue(mask);
+}
+
+void CBonusSystemNode::getCachedBonuses(BonusList & out, const CSelector & selector, const CSelector & limit) const
+{
+	// selectors that only compare common fields can be evaluated on packed data
+	const auto * fieldSelector = selector.getFieldSelector();
+	const auto * fieldLimit = limit.getFieldSelector();
+
+	if(fieldSelector && !limit)
+		cachedBonusesPacked.getBonuses(out, cachedBonuses, *fieldSelector);
+	else if(fieldSelector && fieldLimit)
+		cachedBonusesPacked.getBonuses(out, cachedBonuses, fieldSelector->And(*fieldLimit));
+	else
+		cachedBonuses.getBonuses(out, selector, limit);
+}
+
 TConstBonusListPtr CBonusSystemNode::getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit) const
 {
 	auto ret = std::make_shared<BonusList>();
@@ -181,19 +249,17 @@ std::shared_ptr<Bonus> CBonusSystemNode::getUpdatedBonus(const std::shared_ptr<B
 }
 
 CBonusSystemNode::CBonusSystemNode(bool isHypotetic):
-	bonuses(true),
-	exportedBonuses(true),
 	nodeType(UNKNOWN),
 	cachedLast(0),
+	nodeChanged(++treeChanged),
 	isHypotheticNode(isHypotetic)
 {
 }
 
 CBonusSystemNode::CBonusSystemNode(ENodeTypes NodeType):
-	bonuses(true),
-	exportedBonuses(true),
 	nodeType(NodeType),
 	cachedLast(0),
+	nodeChanged(++treeChanged),
 	isHypotheticNode(false)
 {
 }
@@ -224,7 +290,7 @@ void CBonusSystemNode::attachTo(CBonusSystemNode & parent)
 		parent.newChildAttached(*this);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::attachToSource(const CBonusSystemNode & parent)
@@ -238,7 +304,7 @@ void CBonusSystemNode::attachToSource(const CBonusSystemNode & parent)
 			parent.newRedDescendant(*this);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::detachFrom(CBonusSystemNode & parent)
@@ -267,7 +333,7 @@ void CBonusSystemNode::detachFrom(CBonusSystemNode & parent)
 	{
 		parent.childDetached(*this);
 	}
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 
@@ -291,7 +357,7 @@ void CBonusSystemNode::detachFromSource(const CBonusSystemNode & parent)
 			, nodeShortInfo(), nodeType, parent.nodeShortInfo(), parent.nodeType);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::removeBonusesRecursive(const CSelector & s)
@@ -327,14 +393,17 @@ void CBonusSystemNode::addNewBonus(const std::shared_ptr<Bonus>& b)
 	assert(!vstd::contains(exportedBonuses, b));
 	exportedBonuses.push_back(b);
 	exportBonus(b);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::accumulateBonus(const std::shared_ptr<Bonus>& b)
 {
 	auto bonus = exportedBonuses.getFirst(Selector::typeSubtypeValueType(b->type, b->subtype, b->valType)); //only local bonuses are interesting
 	if(bonus)
+	{
 		bonus->val += b->val;
+		nodeHasChanged();
+	}
 	else
 		addNewBonus(std::make_shared<Bonus>(*b)); //duplicate needed, original may get destroyed
 }
@@ -346,7 +415,7 @@ void CBonusSystemNode::removeBonus(const std::shared_ptr<Bonus>& b)
 		unpropagateBonus(b);
 	else
 		bonuses -= b;
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::removeBonuses(const CSelector & selector)
@@ -378,6 +447,7 @@ void CBonusSystemNode::propagateBonus(const std::shared_ptr<Bonus> & b, const CB
 			? source.getUpdatedBonus(b, b->propagationUpdater)
 			: b;
 		bonuses.push_back(propagated);
+		nodeHasChanged();
 		logBonus->trace("#$# %s #propagated to# %s",  propagated->Description(nullptr), nodeName());
 	}
 
@@ -392,15 +462,18 @@ void CBonusSystemNode::unpropagateBonus(const std::shared_ptr<Bonus> & b)
 	if(b->propagator->shouldBeAttached(this))
 	{
 		if (bonuses -= b)
+		{
+			nodeHasChanged();
 			logBonus->trace("#$# %s #is no longer propagated to# %s",  b->Description(nullptr), nodeName());
+		}
 		else
 			logBonus->warn("Attempt to remove #$# %s, which is not propagated to %s", b->Description(nullptr), nodeName());
 
-		bonuses.remove_if([b](const auto & bonus)
+		bonuses.remove_if([this, b](const auto & bonus)
 		{
 			if (bonus->propagationUpdater && bonus->propagationUpdater == b->propagationUpdater)
 			{
-				treeHasChanged();
+				nodeHasChanged();
 				return true;
 			}
 			return false;
@@ -556,7 +629,7 @@ void CBonusSystemNode::exportBonus(const std::shared_ptr<Bonus> & b)
 	else
 		bonuses.push_back(b);
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::exportBonuses()
@@ -625,14 +698,42 @@ void CBonusSystemNode::limitBonuses(const BonusList &allBonuses, BonusList &out)
 	}
 }
 
+void CBonusSystemNode::invalidateChildrenNodes(int64_t changeCounter)
+{
+	if(nodeChanged == changeCounter)
+		return; // already visited through another path
+
+	nodeChanged = changeCounter;
+
+	for(CBonusSystemNode * child : children)
+		child->invalidateChildrenNodes(changeCounter);
+}
+
+void CBonusSystemNode::nodeHasChanged()
+{
+	// creatures and artifact types are inherited via attachToSource, which does not register children
+	if(nodeType == CREATURE || nodeType == ARTIFACT)
+		treeHasChanged();
+	else
+		invalidateChildrenNodes(++treeChanged);
+}
+
 void CBonusSystemNode::treeHasChanged()
 {
-	treeChanged++;
+	globalChanged = ++treeChanged;
 }
 
 int64_t CBonusSystemNode::getTreeVersion() const
 {
-	return treeChanged;
+	int64_t result = std::max<int64_t>(nodeChanged, globalChanged);
+
+	// hypothetic nodes are not registered as children of their parents and have to check them directly
+	if(isHypothetic())
+	{
+		for(const auto * parent : parentsToInherit)
+			result = std::max(result, parent->getTreeVersion());
+	}
+	return result;
 }
 
 VCMI_LIB_NAMESPACE_END
@@ -43,17 +43,23 @@ private:
 
 	static const bool cachingEnabled;
 	mutable BonusList cachedBonuses;
+	mutable PackedBonusList cachedBonusesPacked;
 	mutable int64_t cachedLast;
-	static std::atomic<int64_t> treeChanged;
+	static std::atomic<int64_t> treeChanged; //source of unique version stamps
+	static std::atomic<int64_t> globalChanged; //stamp of last change that invalidated every node
+	std::atomic<int64_t> nodeChanged; //stamp of last change of this node or any of its ancestors
 
-	// Setting a value to cachingStr before getting any bonuses caches the result for later requests.
-	// This string needs to be unique, that's why it has to be set in the following manner:
+	// Passing a cacheable key when getting bonuses caches the result for later requests.
+	// Named keys need to be unique, that's why they have to be set in the following manner:
 	// [property key]_[value] => only for selector
-	mutable std::map<std::string, TBonusListPtr > cachedRequests;
-	mutable boost::mutex sync;
+	mutable BonusQueryCache cachedRequests;
+	mutable boost::shared_mutex sync;
 
 	void getAllBonusesRec(BonusList &out, const CSelector & selector) const;
 	TConstBonusListPtr getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit) const;
+	void getCachedBonuses(BonusList & out, const CSelector & selector, const CSelector & limit) const;
+	/// Rebuilds cached bonuses if node tree has changed, requires exclusive lock
+	void updateCachedBonuses() const;
 	std::shared_ptr<Bonus> getUpdatedBonus(const std::shared_ptr<Bonus> & b, const TUpdaterPtr & updater) const;
 	void limitBonuses(const BonusList &allBonuses, BonusList &out) const; //out will bo populed with bonuses that are not limited here
 
@@ -63,6 +69,8 @@ private:
 
 	void getAllParents(TCNodes & out) const;
 
+	void invalidateChildrenNodes(int64_t changeCounter);
+
 	void newChildAttached(CBonusSystemNode & child);
 	void childDetached(CBonusSystemNode & child);
 	void propagateBonus(const std::shared_ptr<Bonus> & b, const CBonusSystemNode & source);
@@ -85,7 +93,8 @@ public:
 	explicit CBonusSystemNode(ENodeTypes NodeType);
 	virtual ~CBonusSystemNode();
 
-	TConstBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr = "") const override;
+	TConstBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const BonusCacheKey &cachingKey = {}) const override;
+	int totalValueOfBonuses(const CSelector &selector, const BonusCacheKey &cachingKey) const override;
 	void getParents(TCNodes &out) const;  //retrieves list of parent nodes (nodes to inherit bonuses from),
 
 	/// Returns first bonus matching selector
@@ -120,6 +129,10 @@ public:
 	void setNodeType(CBonusSystemNode::ENodeTypes type);
 	const TCNodesVector & getParentNodes() const;
 
+	/// Invalidates cached bonuses of this node and of all its descendants
+	void nodeHasChanged();
+
+	/// Invalidates cached bonuses of every node, use only if affected nodes can't be determined
 	static void treeHasChanged();
 
 	int64_t getTreeVersion() const override;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "Bonus.h"
+#include "BonusQueryCache.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -20,12 +21,14 @@ public:
 	// * selector is predicate that tests if Bonus matches our criteria
 	IBonusBearer() = default;
 	virtual ~IBonusBearer() = default;
-	virtual TConstBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr = "") const = 0;
-	int valOfBonuses(const CSelector &selector, const std::string &cachingStr = "") const;
-	bool hasBonus(const CSelector &selector, const std::string &cachingStr = "") const;
-	bool hasBonus(const CSelector &selector, const CSelector &limit, const std::string &cachingStr = "") const;
-	TConstBonusListPtr getBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr = "") const;
-	TConstBonusListPtr getBonuses(const CSelector &selector, const std::string &cachingStr = "") const;
+	virtual TConstBonusListPtr getAllBonuses(const CSelector &selector, const CSelector &limit, const BonusCacheKey &cachingKey = {}) const = 0;
+	int valOfBonuses(const CSelector &selector, const BonusCacheKey &cachingKey = {}) const;
+	/// Total value of bonuses matching selector, bearers that keep packed bonus data may compute it without building bonus list
+	virtual int totalValueOfBonuses(const CSelector &selector, const BonusCacheKey &cachingKey) const;
+	bool hasBonus(const CSelector &selector, const BonusCacheKey &cachingKey = {}) const;
+	bool hasBonus(const CSelector &selector, const CSelector &limit, const BonusCacheKey &cachingKey = {}) const;
+	TConstBonusListPtr getBonuses(const CSelector &selector, const CSelector &limit, const BonusCacheKey &cachingKey = {}) const;
+	TConstBonusListPtr getBonuses(const CSelector &selector, const BonusCacheKey &cachingKey = {}) const;
 
 	std::shared_ptr<const Bonus> getBonus(const CSelector &selector) const; //returns any bonus visible on node that matches (or nullptr if none matches)
 
@@ -36,6 +36,12 @@ public:
 		return result;
 	}
 
+	/// Index of identifier type that is currently stored
+	size_t getIndex() const
+	{
+		return value.index();
+	}
+
 	std::string toString() const
 	{
 		std::string result;
@@ -48,12 +48,14 @@
 #include "../modding/ModScope.h"
 #include "../networkPacks/NetPacksBase.h"
 #include "../pathfinder/CPathfinder.h"
+#include "../pathfinder/PathfinderAccessibility.h"
 #include "../pathfinder/PathfinderOptions.h"
 #include "../rmg/CMapGenerator.h"
 #include "../serializer/CMemorySerializer.h"
 #include "../spells/CSpellHandler.h"
 
 #include <vstd/RNG.h>
+#include <tbb/parallel_for.h>
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -1142,11 +1144,19 @@ PlayerRelations CGameState::getPlayerRelations( PlayerColor color1, PlayerColor
 void CGameState::apply(CPackForClient & pack)
 {
 	pack.applyGs(this);
+	appliedPacks++;
 }
 
 void CGameState::calculatePaths(const CGHeroInstance *hero, CPathsInfo &out)
 {
+	const size_t accessibilityRevision = getPathfinderAccessibility(hero->tempOwner)->getRevision();
+	CPathsInfo::SearchState state{hero->id, hero->visitablePos(), hero->getTreeVersion(), hero->mana, hero->getSpellsInSpellbook().size(), day, accessibilityRevision};
+
 	calculatePaths(std::make_shared<SingleHeroPathfinderConfig>(out, this, hero));
+
+	// remember state of hero so next calculation can repair these paths if hero makes only one step
+	if(state.heroBonusVersion == hero->getTreeVersion())
+		out.lastSearch = state;
 }
 
 void CGameState::calculatePaths(const std::shared_ptr<PathfinderConfig> & config)
@@ -1156,6 +1166,51 @@ void CGameState::calculatePaths(const std::shared_ptr<PathfinderConfig> & config
 	pathfinder.calculatePaths();
 }
 
+void CGameState::calculatePaths(const std::vector<CPathsInfo *> & paths)
+{
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size()), [this, &paths](const tbb::blocked_range<size_t> & r)
+	{
+		for(size_t i = r.begin(); i != r.end(); i++)
+			calculatePaths(paths[i]->hero, *paths[i]);
+	});
+}
+
+void CGameState::calculatePaths(const std::vector<std::shared_ptr<PathfinderConfig>> & configs)
+{
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, configs.size()), [this, &configs](const tbb::blocked_range<size_t> & r)
+	{
+		for(size_t i = r.begin(); i != r.end(); i++)
+			calculatePaths(configs[i]);
+	});
+}
+
+std::shared_ptr<const PathfinderAccessibility> CGameState::getPathfinderAccessibility(const PlayerColor & player, const PlayerColor & fowPlayer) const
+{
+	std::lock_guard lock(pathfinderAccessibilityMutex);
+
+	auto & [accessibility, revision] = pathfinderAccessibility[std::make_pair(player, fowPlayer)];
+
+	if(!accessibility)
+		accessibility = std::make_shared<PathfinderAccessibility>(this, player, fowPlayer);
+	else if(revision != appliedPacks)
+	{
+		// layer may still be used by searches started before last change of game state, do not modify it under them
+		// copy shares tile data with original, update copies only columns of map that actually change
+		if(accessibility.use_count() > 1)
+			accessibility = std::make_shared<PathfinderAccessibility>(*accessibility);
+
+		accessibility->update(this);
+	}
+
+	revision = appliedPacks;
+	return accessibility;
+}
+
+std::shared_ptr<const PathfinderAccessibility> CGameState::getPathfinderAccessibility(const PlayerColor & player) const
+{
+	return getPathfinderAccessibility(player, player);
+}
+
 /**
  * Tells if the tile is guarded by a monster as well as the position
  * of the monster that will attack on it.
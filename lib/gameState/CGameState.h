@@ -38,6 +38,7 @@ class TavernHeroesPool;
 struct SThievesGuildInfo;
 class CRandomGenerator;
 class GameSettings;
+class PathfinderAccessibility;
 
 struct UpgradeInfo
 {
@@ -106,6 +107,11 @@ public:
 	bool checkForVisitableDir(const int3 & src, const int3 & dst) const; //check if src tile is visitable from dst tile
 	void calculatePaths(const CGHeroInstance *hero, CPathsInfo &out) override; //calculates possible paths for hero, by default uses current hero position and movement left; returns pointer to newly allocated CPath or nullptr if path does not exists
 	void calculatePaths(const std::shared_ptr<PathfinderConfig> & config) override;
+	void calculatePaths(const std::vector<CPathsInfo *> & paths) override;
+	void calculatePaths(const std::vector<std::shared_ptr<PathfinderConfig>> & configs) override;
+	/// Returns up to date accessibility of map tiles for heroes of player, as known to fowPlayer
+	std::shared_ptr<const PathfinderAccessibility> getPathfinderAccessibility(const PlayerColor & player, const PlayerColor & fowPlayer) const;
+	std::shared_ptr<const PathfinderAccessibility> getPathfinderAccessibility(const PlayerColor & player) const;
 	int3 guardingCreaturePosition (int3 pos) const override;
 	std::vector<CGObjectInstance*> guardingCreatures (int3 pos) const;
 
@@ -222,6 +228,13 @@ private:
 	/// Pointer to campaign state manager. Nullptr for single scenarios
 	std::unique_ptr<CGameStateCampaign> campaign;
 
+	/// Number of packs applied to game state, nothing that affects pathfinding can change in between
+	size_t appliedPacks = 0;
+
+	/// Accessibility layers shared by all pathfinder searches with value of appliedPacks at time of their last update
+	mutable std::map<std::pair<PlayerColor, PlayerColor>, std::pair<std::shared_ptr<PathfinderAccessibility>, size_t>> pathfinderAccessibility;
+	mutable std::mutex pathfinderAccessibilityMutex;
+
 	friend class IGameCallback;
 	friend class CMapHandler;
 	friend class CGameHandler;
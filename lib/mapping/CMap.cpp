@@ -300,6 +300,8 @@ void CMap::removeBlockVisTiles(CGObjectInstance * obj, bool total)
 
 				if(total || obj->blockingAt(int3(xVal, yVal, zVal)))
 					curt.blockingObjects -= obj;
+
+				tileChanged(int3(xVal, yVal, zVal));
 			}
 		}
 	}
@@ -322,6 +324,8 @@ void CMap::addBlockVisTiles(CGObjectInstance * obj)
 
 				if(obj->blockingAt(int3(xVal, yVal, zVal)))
 					curt.blockingObjects.push_back(obj);
+
+				tileChanged(int3(xVal, yVal, zVal));
 			}
 		}
 	}
@@ -336,12 +340,60 @@ void CMap::calculateGuardingGreaturePositions()
 		{
 			for(int y = 0; y < height; y++)
 			{
-				guardingCreaturePositions[z][x][y] = guardingCreaturePosition(int3(x, y, z));
+				int3 guardPosition = guardingCreaturePosition(int3(x, y, z));
+				if(guardingCreaturePositions[z][x][y] != guardPosition)
+				{
+					guardingCreaturePositions[z][x][y] = guardPosition;
+					tileChanged(int3(x, y, z));
+				}
 			}
 		}
 	}
 }
 
+void CMap::tileChanged(const int3 & tile)
+{
+	changedTiles.push_back(tile);
+
+	// once log is longer than the map, rebuilding derived data is cheaper than replaying the log
+	const size_t maxLogSize = width * height * levels();
+	if(changedTiles.size() > maxLogSize)
+	{
+		const size_t dropped = changedTiles.size() / 2;
+		changedTiles.erase(changedTiles.begin(), changedTiles.begin() + dropped);
+		droppedTileChanges += dropped;
+	}
+}
+
+void CMap::objectChanged(const CGObjectInstance * obj)
+{
+	const int zVal = obj->anchorPos().z;
+	for(int fx = 0; fx < obj->getWidth(); ++fx)
+	{
+		for(int fy = 0; fy < obj->getHeight(); ++fy)
+		{
+			const int3 tile(obj->anchorPos().x - fx, obj->anchorPos().y - fy, zVal);
+			if(isInTheMap(tile) && obj->visitableAt(tile))
+				tileChanged(tile);
+		}
+	}
+}
+
+size_t CMap::getTileRevision() const
+{
+	return droppedTileChanges + changedTiles.size();
+}
+
+bool CMap::forEachTileChangedSince(size_t revision, const std::function<void(const int3 &)> & handler) const
+{
+	if(revision < droppedTileChanges)
+		return false;
+
+	for(size_t i = revision - droppedTileChanges; i < changedTiles.size(); i++)
+		handler(changedTiles[i]);
+	return true;
+}
+
 CGHeroInstance * CMap::getHero(HeroTypeID heroID)
 {
 	for(auto & elem : heroesOnMap)
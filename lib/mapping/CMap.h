@@ -80,6 +80,10 @@ struct DLL_LINKAGE DisposedHero
 class DLL_LINKAGE CMap : public CMapHeader, public GameCallbackHolder
 {
 	std::unique_ptr<GameSettings> gameSettings;
+
+	std::vector<int3> changedTiles; //recent part of tile change log, not serialized
+	size_t droppedTileChanges = 0; //number of changes already removed from start of the log
+
 public:
 	explicit CMap(IGameCallback *cb);
 	~CMap();
@@ -107,6 +111,16 @@ public:
 	void removeBlockVisTiles(CGObjectInstance * obj, bool total = false);
 	void calculateGuardingGreaturePositions();
 
+	/// Records change of tile that is not visible in tile itself, e.g. tile being revealed in fog of war
+	void tileChanged(const int3 & tile);
+	/// Records change of object state that may affect how its tiles can be visited, e.g. new owner or garrison
+	void objectChanged(const CGObjectInstance * obj);
+
+	/// Number of changes of tile objects, object state, guards or visibility done so far, lets derived per-tile data be updated incrementally
+	size_t getTileRevision() const;
+	/// Calls handler for every tile changed since given revision, returns false if these changes are no longer known
+	bool forEachTileChangedSince(size_t revision, const std::function<void(const int3 &)> & handler) const;
+
 	void addNewArtifactInstance(CArtifactSet & artSet);
 	void addNewArtifactInstance(ConstTransitivePtr<CArtifactInstance> art);
 	void eraseArtifactInstance(CArtifactInstance * art);
@@ -69,7 +69,7 @@ void NetworkConnection::heartbeat()
 		if (!locked)
 			return;
 
-		locked->sendPacket({});
+		locked->sendPacket(NetworkPacketPtr());
 		locked->heartbeat();
 	});
 }
@@ -136,40 +136,66 @@ void NetworkConnection::setAsyncWritesEnabled(bool on)
 
 void NetworkConnection::sendPacket(const std::vector<std::byte> & message)
 {
+	// In async mode message must outlive this call and has to be copied. Otherwise it can be written as is
+	if (asyncWritesEnabled)
+	{
+		sendPacket(std::make_shared<const std::vector<std::byte>>(message));
+		return;
+	}
+
 	std::lock_guard lock(writeMutex);
-	std::vector<std::byte> headerVector(sizeof(uint32_t));
-	uint32_t messageSize = message.size();
-	std::memcpy(headerVector.data(), &messageSize, sizeof(uint32_t));
+	writePacketSync(message.data(), message.size());
+}
+
+void NetworkConnection::sendPacket(const NetworkPacketPtr & message)
+{
+	std::lock_guard lock(writeMutex);
+	uint32_t messageSize = message ? message->size() : 0;
 
 	// At the moment, vcmilobby *requires* async writes in order to handle multiple connections with different speeds and at optimal performance
 	// However server (and potentially - client) can not handle this mode and may shutdown either socket or entire asio service too early, before all writes are performed
 	if (asyncWritesEnabled)
 	{
+		dataToSend.push_back({messageSize, message});
 
-		bool messageQueueEmpty = dataToSend.empty();
-		dataToSend.push_back(headerVector);
-		if (!message.empty())
-			dataToSend.push_back(message);
-
-		if (messageQueueEmpty)
+		if (packetsInFlight == 0)
 			doSendData();
-		//else - data sending loop is still active and still sending previous messages
+		//else - data sending loop is still active and will pick up this message once previous write is over
 	}
 	else
 	{
-		boost::system::error_code ec;
-		boost::asio::write(*socket, boost::asio::buffer(headerVector), ec );
-		if (!message.empty())
-			boost::asio::write(*socket, boost::asio::buffer(message), ec );
+		writePacketSync(messageSize ? message->data() : nullptr, messageSize);
 	}
 }
 
+void NetworkConnection::writePacketSync(const std::byte * data, uint32_t size)
+{
+	// header and payload are written using single call to avoid separate syscall (and potentially - separate TCP segment) for header
+	std::array<boost::asio::const_buffer, 2> buffers = {
+		boost::asio::buffer(&size, sizeof(size)),
+		boost::asio::buffer(data, size)
+	};
+
+	boost::system::error_code ec;
+	boost::asio::write(*socket, buffers, ec);
+}
+
 void NetworkConnection::doSendData()
 {
 	if (dataToSend.empty())
 		throw std::runtime_error("Attempting to sent data but there is no data to send!");
 
-	boost::asio::async_write(*socket, boost::asio::buffer(dataToSend.front()), [self = shared_from_this()](const auto & error, const auto & )
+	// coalesce all pending packets into a single vectored write
+	writeBuffers.clear();
+	for (const auto & packet : dataToSend)
+	{
+		writeBuffers.push_back(boost::asio::buffer(&packet.header, sizeof(packet.header)));
+		if (packet.header != 0)
+			writeBuffers.push_back(boost::asio::buffer(*packet.payload));
+	}
+	packetsInFlight = dataToSend.size();
+
+	boost::asio::async_write(*socket, writeBuffers, [self = shared_from_this()](const auto & error, const auto & )
 	{
 		self->onDataSent(error);
 	});
@@ -178,7 +204,9 @@ void NetworkConnection::doSendData()
 void NetworkConnection::onDataSent(const boost::system::error_code & ec)
 {
 	std::lock_guard lock(writeMutex);
-	dataToSend.pop_front();
+	dataToSend.erase(dataToSend.begin(), dataToSend.begin() + packetsInFlight);
+	packetsInFlight = 0;
+
 	if (ec)
 	{
 		onError(ec.message());
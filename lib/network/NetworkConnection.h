@@ -18,7 +18,18 @@ class NetworkConnection final : public INetworkConnection, public std::enable_sh
 	static const int messageHeaderSize = sizeof(uint32_t);
 	static const int messageMaxSize = 64 * 1024 * 1024; // arbitrary size to prevent potential massive allocation if we receive garbage input
 
-	std::list<std::vector<std::byte>> dataToSend;
+	struct QueuedPacket
+	{
+		uint32_t header;
+		NetworkPacketPtr payload;
+	};
+
+	/// Packets waiting to be sent. Deque is used so addresses of headers remain valid while new packets are queued
+	std::deque<QueuedPacket> dataToSend;
+	/// Buffer sequence of write that is currently in progress, kept as member to reuse its storage
+	std::vector<boost::asio::const_buffer> writeBuffers;
+	/// Number of packets from front of dataToSend that are being written right now
+	size_t packetsInFlight = 0;
 	std::shared_ptr<NetworkSocket> socket;
 	std::shared_ptr<NetworkTimer> timer;
 	std::mutex writeMutex;
@@ -34,6 +45,7 @@ class NetworkConnection final : public INetworkConnection, public std::enable_sh
 	void onHeaderReceived(const boost::system::error_code & ec);
 	void onPacketReceived(const boost::system::error_code & ec, uint32_t expectedPacketSize);
 
+	void writePacketSync(const std::byte * data, uint32_t size);
 	void doSendData();
 	void onDataSent(const boost::system::error_code & ec);
 
@@ -43,6 +55,7 @@ public:
 	void start();
 	void close() override;
 	void sendPacket(const std::vector<std::byte> & message) override;
+	void sendPacket(const NetworkPacketPtr & message) override;
 	void setAsyncWritesEnabled(bool on) override;
 };
 
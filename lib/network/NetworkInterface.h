@@ -11,12 +11,17 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Immutable, reference-counted packet payload that can be queued for sending on multiple connections without copying
+using NetworkPacketPtr = std::shared_ptr<const std::vector<std::byte>>;
+
 /// Base class for connections with other services, either incoming or outgoing
 class DLL_LINKAGE INetworkConnection : boost::noncopyable
 {
 public:
 	virtual ~INetworkConnection() = default;
 	virtual void sendPacket(const std::vector<std::byte> & message) = 0;
+	/// Sends packet without copying its payload. Null pointer is treated as empty packet
+	virtual void sendPacket(const NetworkPacketPtr & message) = 0;
 	virtual void setAsyncWritesEnabled(bool on) = 0;
 	virtual void close() = 0;
 };
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include "../battle/Unit.h"
 #include "../json/JsonNode.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -40,6 +41,11 @@ public:
 	uint32_t id = 0;
 	int64_t healthDelta = 0;
 
+	/// new unit, used by ADD operation
+	battle::UnitInfo info;
+	/// complete unit state, used by RESET_STATE operation
+	battle::UnitStateSnapshot state;
+
 	UnitChanges() = default;
 	UnitChanges(uint32_t id_, EOperation operation_)
 		: BattleChanges(operation_)
@@ -51,8 +57,53 @@ public:
 	{
 		h & id;
 		h & healthDelta;
-		h & data;
+
+		if (h.version < Handler::Version::BINARY_UNIT_STATE)
+		{
+			JsonNode legacyData;
+			if (h.saving)
+				legacyData = toLegacyJson();
+			h & legacyData;
+			h & operation;
+			if (!h.saving)
+				fromLegacyJson(legacyData);
+			return;
+		}
+
 		h & operation;
+
+		switch(operation)
+		{
+			case EOperation::ADD:
+				h & info;
+				break;
+			case EOperation::RESET_STATE:
+				h & state;
+				break;
+			default:
+				h & data;
+				break;
+		}
+	}
+
+private:
+	JsonNode toLegacyJson()
+	{
+		JsonNode result = data;
+		if(operation == EOperation::ADD)
+			info.save(result);
+		if(operation == EOperation::RESET_STATE)
+			state.save(result);
+		return result;
+	}
+
+	void fromLegacyJson(const JsonNode & legacyData)
+	{
+		data = legacyData;
+		if(operation == EOperation::ADD)
+			info.load(id, data);
+		if(operation == EOperation::RESET_STATE)
+			state.load(data);
 	}
 };
 
@@ -990,8 +990,15 @@ void FoWChange::applyGs(CGameState *gs)
 {
 	TeamState * team = gs->getPlayerTeam(player);
 	auto & fogOfWarMap = team->fogOfWarMap;
+	const ui8 visible = mode != ETileVisibility::HIDDEN;
 	for(const int3 & t : tiles)
-		fogOfWarMap[t.z][t.x][t.y] = mode != ETileVisibility::HIDDEN;
+	{
+		if(fogOfWarMap[t.z][t.x][t.y] != visible)
+		{
+			fogOfWarMap[t.z][t.x][t.y] = visible;
+			gs->map->tileChanged(t);
+		}
+	}
 
 	if (mode == ETileVisibility::HIDDEN) //do not hide too much
 	{
@@ -1014,7 +1021,13 @@ void FoWChange::applyGs(CGameState *gs)
 			}
 		}
 		for(const int3 & t : tilesRevealed) //probably not the most optimal solution ever
-			fogOfWarMap[t.z][t.x][t.y] = 1;
+		{
+			if(!fogOfWarMap[t.z][t.x][t.y])
+			{
+				fogOfWarMap[t.z][t.x][t.y] = 1;
+				gs->map->tileChanged(t);
+			}
+		}
 	}
 }
 
@@ -1097,6 +1110,13 @@ void ChangeObjectVisitors::applyGs(CGameState *gs)
 			{
 				CGObjectInstance * objectPtr = gs->getObjInstance(object);
 				gs->getPlayerState(gs->getHero(hero)->tempOwner)->visitedObjectsGlobal.insert({objectPtr->ID, objectPtr->subID});
+
+				// border gates of this color become passable for player
+				for(const CGObjectInstance * other : gs->map->objects)
+				{
+					if(other && other->subID == objectPtr->subID && dynamic_cast<const CGKeys *>(other))
+						gs->map->objectChanged(other);
+				}
 				break;
 			}
 	}
@@ -1350,7 +1370,13 @@ void TryMoveHero::applyGs(CGameState *gs)
 
 	auto & fogOfWarMap = gs->getPlayerTeam(h->getOwner())->fogOfWarMap;
 	for(const int3 & t : fowRevealed)
-		fogOfWarMap[t.z][t.x][t.y] = 1;
+	{
+		if(!fogOfWarMap[t.z][t.x][t.y])
+		{
+			fogOfWarMap[t.z][t.x][t.y] = 1;
+			gs->map->tileChanged(t);
+		}
+	}
 }
 
 void NewStructures::applyGs(CGameState *gs)
@@ -1547,6 +1573,8 @@ void ChangeStackCount::applyGs(CGameState *gs)
 		srcObj->setStackCount(slot, count);
 	else
 		srcObj->changeStackCount(slot, count);
+
+	gs->map->objectChanged(srcObj);
 }
 
 void SetStackType::applyGs(CGameState *gs)
@@ -1565,6 +1593,7 @@ void EraseStack::applyGs(CGameState *gs)
 		throw std::runtime_error("EraseStack: invalid army object " + std::to_string(army.getNum()) + ", possible game state corruption.");
 
 	srcObj->eraseStack(slot);
+	gs->map->objectChanged(srcObj);
 }
 
 void SwapStacks::applyGs(CGameState *gs)
@@ -1582,12 +1611,18 @@ void SwapStacks::applyGs(CGameState *gs)
 
 	srcObj->putStack(srcSlot, s2);
 	dstObj->putStack(dstSlot, s1);
+
+	gs->map->objectChanged(srcObj);
+	gs->map->objectChanged(dstObj);
 }
 
 void InsertNewStack::applyGs(CGameState *gs)
 {
 	if(auto * obj = gs->getArmyInstance(army))
+	{
 		obj->putStack(slot, new CStackInstance(type, count));
+		gs->map->objectChanged(obj);
+	}
 	else
 		throw std::runtime_error("InsertNewStack: invalid army object " + std::to_string(army.getNum()) + ", possible game state corruption.");
 }
@@ -1695,7 +1730,11 @@ void RebalanceStacks::applyGs(CGameState *gs)
 		}
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	src.army->nodeHasChanged();
+	dst.army->nodeHasChanged();
+
+	gs->map->objectChanged(srcObj);
+	gs->map->objectChanged(dstObj);
 }
 
 void BulkRebalanceStacks::applyGs(CGameState *gs)
@@ -2007,6 +2046,9 @@ void SetObjectProperty::applyGs(CGameState *gs)
 	{
 		obj->setProperty(what, identifier);
 	}
+
+	// owner, quest state and similar properties decide who can pass through object
+	gs->map->objectChanged(obj);
 }
 
 void HeroLevelUp::applyGs(CGameState *gs)
@@ -2072,7 +2114,10 @@ void BattleTriggerEffect::applyGs(CGameState *gs)
 		auto b = st->getLocalBonus(Selector::source(BonusSource::SPELL_EFFECT, SpellID(SpellID::POISON))
 				.And(Selector::type()(BonusType::STACK_HEALTH)));
 		if (b)
+		{
 			b->val = val;
+			st->nodeHasChanged();
+		}
 		break;
 	}
 	case BonusType::ENCHANTER:
@@ -2089,7 +2134,7 @@ void BattleTriggerEffect::applyGs(CGameState *gs)
 void BattleUpdateGateState::applyGs(CGameState *gs)
 {
 	if(gs->getBattle(battleID))
-		gs->getBattle(battleID)->si.gateState = state;
+		gs->getBattle(battleID)->setGateState(state);
 }
 
 void BattleCancelled::applyGs(CGameState *gs)
@@ -2137,7 +2182,6 @@ void BattleResultAccepted::applyGs(CGameState *gs)
 			heroResult[BattleSide::ATTACKER].army->giveStackExp(heroResult[BattleSide::ATTACKER].exp);
 		if(heroResult[BattleSide::DEFENDER].army)
 			heroResult[BattleSide::DEFENDER].army->giveStackExp(heroResult[BattleSide::DEFENDER].exp);
-		CBonusSystemNode::treeHasChanged();
 	}
 
 	auto currentBattle = boost::range::find_if(gs->currentBattles, [&](const auto & battle)
@@ -2176,7 +2220,7 @@ void BattleStackAttacked::applyGs(CGameState *gs)
 
 void BattleStackAttacked::applyBattle(IBattleState * battleState)
 {
-	battleState->setUnitState(newState.id, newState.data, newState.healthDelta);
+	battleState->setUnitState(newState.id, newState.state, newState.healthDelta);
 }
 
 void BattleAttack::applyGs(CGameState *gs)
@@ -2292,13 +2336,13 @@ void BattleUnitsChanged::applyBattle(IBattleState * battleState)
 		switch(elem.operation)
 		{
 		case BattleChanges::EOperation::RESET_STATE:
-			battleState->setUnitState(elem.id, elem.data, elem.healthDelta);
+			battleState->setUnitState(elem.id, elem.state, elem.healthDelta);
 			break;
 		case BattleChanges::EOperation::REMOVE:
 			battleState->removeUnit(elem.id);
 			break;
 		case BattleChanges::EOperation::ADD:
-			battleState->addUnit(elem.id, elem.data);
+			battleState->addUnit(elem.id, elem.info);
 			break;
 		case BattleChanges::EOperation::UPDATE:
 			battleState->updateUnit(elem.id, elem.data);
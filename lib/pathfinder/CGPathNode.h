@@ -11,8 +11,7 @@
 
 #include "../GameConstants.h"
 #include "../int3.h"
-
-#include <boost/heap/fibonacci_heap.hpp>
+#include "PathfinderQueue.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -57,13 +56,12 @@ enum class EPathNodeAction : ui8
 	TELEPORT_BATTLE
 };
 
+/// Nodes are allocated for every tile and layer of the map, so fields are ordered to avoid any padding
 struct DLL_LINKAGE CGPathNode
 {
-	using TFibHeap = boost::heap::fibonacci_heap<CGPathNode *, boost::heap::compare<NodeComparer<CGPathNode>>>;
 	using ELayer = EPathfindingLayer;
 
-	TFibHeap::handle_type pqHandle;
-	TFibHeap * pq;
+	IPathfinderQueue * pq;
 	CGPathNode * theNodeBefore;
 
 	int3 coord; //coordinates
@@ -71,6 +69,7 @@ struct DLL_LINKAGE CGPathNode
 
 	float cost; //total cost of the path to this tile measured in turns with fractions
 	int moveRemains; //remaining movement points after hero reaches the tile
+	uint32_t pqIndex; //position of node in queue, meaning depends on queue type
 	ui8 turns; //how many turns we have to wait before reaching the tile - 0 means current turn
 	EPathAccessibility accessible;
 	EPathNodeAction action;
@@ -79,7 +78,7 @@ struct DLL_LINKAGE CGPathNode
 	CGPathNode()
 		: coord(-1),
 		layer(ELayer::WRONG),
-		pqHandle(nullptr)
+		pqIndex(0)
 	{
 		reset();
 	}
@@ -119,16 +118,7 @@ struct DLL_LINKAGE CGPathNode
 		cost = value;
 		// If the node is in the heap, update the heap.
 		if(inPQ())
-		{
-			if(getUpNode)
-			{
-				pq->increase(this->pqHandle);
-			}
-			else
-			{
-				pq->decrease(this->pqHandle);
-			}
-		}
+			pq->update(this, getUpNode);
 	}
 
 	STRONG_INLINE
@@ -166,6 +156,8 @@ struct DLL_LINKAGE CGPathNode
 	}
 };
 
+static_assert(sizeof(void *) != 8 || sizeof(CGPathNode) == 48, "Unexpected padding in CGPathNode");
+
 struct DLL_LINKAGE CGPath
 {
 	std::vector<CGPathNode> nodes; //just get node by node
@@ -185,10 +177,36 @@ struct DLL_LINKAGE CPathsInfo
 {
 	using ELayer = EPathfindingLayer;
 
+	/// State of hero for which paths were calculated from scratch or repaired
+	/// If hero only made single step since then, nodes can be repaired instead of full recalculation
+	struct SearchState
+	{
+		ObjectInstanceID heroId;
+		int3 heroPos;
+		int64_t heroBonusVersion;
+		si32 mana;
+		size_t spellsCount;
+		ui32 day;
+		size_t accessibilityRevision; //see PathfinderAccessibility::getRevision
+	};
+
+	/// Accessibility and layers nodes were initialized with
+	/// Nodes that are not in reachedNodes keep reset state, so next search only resets reached nodes and tiles that changed since
+	struct NodesState
+	{
+		PlayerColor player;
+		bool useFlying;
+		bool useWaterWalking;
+		size_t accessibilityRevision; //see PathfinderAccessibility::getRevision
+	};
+
 	const CGHeroInstance * hero;
 	int3 hpos;
 	int3 sizes;
 	boost::multi_array<CGPathNode, 4> nodes; //[layer][level][w][h]
+	std::optional<SearchState> lastSearch; //set only if nodes contain results of finished search
+	std::optional<NodesState> nodesState; //set once all nodes were initialized
+	std::vector<CGPathNode *> reachedNodes; //nodes modified by search since nodes were reset, repair only visits these and tiles that changed
 
 	CPathsInfo(const int3 & Sizes, const CGHeroInstance * hero_);
 	~CPathsInfo();
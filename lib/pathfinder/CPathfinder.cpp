@@ -74,7 +74,8 @@ void CPathfinderHelper::calculateNeighbourTiles(NeighbourTilesVector & result, c
 
 CPathfinder::CPathfinder(CGameState * _gs, std::shared_ptr<PathfinderConfig> config): 
 	gamestate(_gs),
-	config(std::move(config))
+	config(std::move(config)),
+	pq(IPathfinderQueue::create(this->config->options.queueType))
 {
 	initializeGraph();
 }
@@ -83,20 +84,12 @@ CPathfinder::CPathfinder(CGameState * _gs, std::shared_ptr<PathfinderConfig> con
 void CPathfinder::push(CGPathNode * node)
 {
 	if(node && !node->inPQ())
-	{
-		node->pq = &this->pq;
-		auto handle = pq.push(node);
-		node->pqHandle = handle;
-	}
+		pq->push(node);
 }
 
 CGPathNode * CPathfinder::topAndPop()
 {
-	auto * node = pq.top();
-
-	pq.pop();
-	node->pq = nullptr;
-	return node;
+	return pq->topAndPop();
 }
 
 void CPathfinder::calculatePaths()
@@ -121,12 +114,15 @@ void CPathfinder::calculatePaths()
 		if(hlp->isHeroPatrolLocked())
 			continue;
 
-		pq.push(initialNode);
+		push(initialNode);
 	}
 
 	std::vector<CGPathNode *> neighbourNodes;
 
-	while(!pq.empty())
+	// when repairing previous search, nodes locked by it may still find better way
+	const bool repairing = config->nodeStorage->isRepairing();
+
+	while(!pq->empty())
 	{
 		counter++;
 		auto * node = topAndPop();
@@ -164,7 +160,7 @@ void CPathfinder::calculatePaths()
 
 			for(CGPathNode * neighbour : neighbourNodes)
 			{
-				if(neighbour->locked)
+				if(neighbour->locked && !repairing)
 					continue;
 
 				destination.setNode(gamestate, neighbour);
@@ -208,7 +204,7 @@ void CPathfinder::calculatePaths()
 		auto teleportationNodes = config->nodeStorage->calculateTeleportations(source, config.get(), hlp);
 		for(CGPathNode * teleportNode : teleportationNodes)
 		{
-			if(teleportNode->locked)
+			if(teleportNode->locked && !repairing)
 				continue;
 			/// TODO: We may consider use invisible exits on FoW border in future
 			/// Useful for AI when at least one tile around exit is visible and passable
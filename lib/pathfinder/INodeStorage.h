@@ -46,6 +46,13 @@ public:
 	virtual void commit(CDestinationNodeInfo & destination, const PathNodeInfo & source) = 0;
 
 	virtual void initialize(const PathfinderOptions & options, const CGameState * gs) = 0;
+
+	/// True if storage kept results of previous search and only repairs them
+	/// In this case nodes locked by previous search can still be improved
+	virtual bool isRepairing() const
+	{
+		return false;
+	}
 };
 
 VCMI_LIB_NAMESPACE_END
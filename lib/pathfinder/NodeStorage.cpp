@@ -11,24 +11,42 @@
 #include "NodeStorage.h"
 
 #include "CPathfinder.h"
-#include "PathfinderUtil.h"
+#include "PathfinderAccessibility.h"
 #include "PathfinderOptions.h"
 
 #include "../CPlayerState.h"
+#include "../gameState/CGameState.h"
 #include "../mapObjects/CGHeroInstance.h"
 #include "../mapObjects/MiscObjects.h"
 #include "../mapping/CMap.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-void NodeStorage::initialize(const PathfinderOptions & options, const CGameState * gs)
+template<typename Handler>
+void NodeStorage::forTileLayers(const int3 & pos, bool useFlying, bool useWaterWalking, const CGameState * gs, const PathfinderAccessibility & accessibility, const Handler & handler)
 {
-	//TODO: fix this code duplication with AINodeStorage::initialize, problem is to keep `resetTile` inline
+	const TerrainTile & tile = gs->map->getTile(pos);
+	if(tile.isWater())
+	{
+		handler(pos, ELayer::SAIL, accessibility.get(pos, ELayer::SAIL));
+		if(useFlying)
+			handler(pos, ELayer::AIR, accessibility.get(pos, ELayer::AIR));
+		if(useWaterWalking)
+			handler(pos, ELayer::WATER, accessibility.get(pos, ELayer::WATER));
+	}
+	if(tile.isLand())
+	{
+		handler(pos, ELayer::LAND, accessibility.get(pos, ELayer::LAND));
+		if(useFlying)
+			handler(pos, ELayer::AIR, accessibility.get(pos, ELayer::AIR));
+	}
+}
 
+template<typename Handler>
+void NodeStorage::forEachTileLayer(const PathfinderOptions & options, const CGameState * gs, const PathfinderAccessibility & accessibility, const Handler & handler)
+{
 	int3 pos;
-	const PlayerColor player = out.hero->tempOwner;
 	const int3 sizes = gs->getMapSize();
-	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(player)->fogOfWarMap;
 
 	//make 200% sure that these are loop invariants (also a bit shorter code), let compiler do the rest(loop unswitching)
 	const bool useFlying = options.useFlying;
@@ -40,24 +58,254 @@ void NodeStorage::initialize(const PathfinderOptions & options, const CGameState
 		{
 			for(pos.y=0; pos.y < sizes.y; ++pos.y)
 			{
-				const TerrainTile & tile = gs->map->getTile(pos);
-				if(tile.isWater())
-				{
-					resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
-					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-					if(useWaterWalking)
-						resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
-				}
-				if(tile.isLand())
+				forTileLayers(pos, useFlying, useWaterWalking, gs, accessibility, handler);
+			}
+		}
+	}
+}
+
+void NodeStorage::initialize(const PathfinderOptions & options, const CGameState * gs)
+{
+	//TODO: fix this code duplication with AINodeStorage::initialize, problem is to keep `resetTile` inline
+
+	repairSeeds.clear();
+
+	auto previousSearch = out.lastSearch;
+	out.lastSearch.reset();
+
+	auto previousNodes = out.nodesState;
+	out.nodesState.reset();
+
+	const auto accessibilityLayer = gs->getPathfinderAccessibility(out.hero->tempOwner);
+	const PathfinderAccessibility & accessibility = *accessibilityLayer;
+	const CPathsInfo::NodesState nodesState{out.hero->tempOwner, options.useFlying, options.useWaterWalking, accessibility.getRevision()};
+
+	// nodes of layers that were not used by previous search are not initialized
+	const bool sameLayers = previousNodes
+		&& previousNodes->player == nodesState.player
+		&& previousNodes->useFlying == nodesState.useFlying
+		&& previousNodes->useWaterWalking == nodesState.useWaterWalking;
+
+	if(sameLayers && previousSearch && tryRepair(options, gs, accessibility, *previousSearch))
+	{
+		out.nodesState = nodesState;
+		return;
+	}
+
+	if(sameLayers && tryResetReachedNodes(options, gs, accessibility, *previousNodes))
+	{
+		out.nodesState = nodesState;
+		return;
+	}
+
+	out.reachedNodes.clear();
+
+	forEachTileLayer(options, gs, accessibility, [this](const int3 & pos, ELayer layer, EPathAccessibility tileAccessibility)
+	{
+		resetTile(pos, layer, tileAccessibility);
+	});
+
+	out.nodesState = nodesState;
+}
+
+bool NodeStorage::tryResetReachedNodes(const PathfinderOptions & options, const CGameState * gs, const PathfinderAccessibility & accessibility, const CPathsInfo::NodesState & previous)
+{
+	// only nodes modified by previous searches and nodes on tiles with changed accessibility differ from freshly initialized ones
+	std::vector<int3> changedTiles;
+
+	if(!accessibility.forEachTileChangedSince(previous.accessibilityRevision, [&changedTiles](const int3 & pos){ changedTiles.push_back(pos); }))
+		return false;
+
+	for(CGPathNode * node : out.reachedNodes)
+	{
+		auto nodeAccessibility = node->accessible;
+		node->reset();
+		node->accessible = nodeAccessibility;
+	}
+
+	out.reachedNodes.clear();
+
+	vstd::removeDuplicates(changedTiles);
+
+	for(const auto & pos : changedTiles)
+	{
+		forTileLayers(pos, options.useFlying, options.useWaterWalking, gs, accessibility, [this](const int3 & tile, ELayer layer, EPathAccessibility tileAccessibility)
+		{
+			resetTile(tile, layer, tileAccessibility);
+		});
+	}
+
+	return true;
+}
+
+bool NodeStorage::tryRepair(const PathfinderOptions & options, const CGameState * gs, const PathfinderAccessibility & accessibility, const CPathsInfo::SearchState & previous)
+{
+	// Only single step of hero along path of previous search is supported:
+	// nodes reached through new hero position keep their values relative to it,
+	// everything else (and everything behind tiles that changed since) is searched again.
+	// Only nodes reached by previous search and nodes on tiles with changed accessibility are visited.
+	const CGHeroInstance * hero = out.hero;
+	const int3 heroPos = hero->visitablePos();
+
+	if(previous.heroId != hero->id
+		|| previous.heroBonusVersion != hero->getTreeVersion()
+		|| previous.mana != hero->mana
+		|| previous.spellsCount != hero->getSpellsInSpellbook().size()
+		|| previous.day != gs->day)
+		return false;
+
+	if(hero->boat || hero->patrol.patrolling || options.lightweightFlyingMode || previous.heroPos == heroPos || out.sizes != gs->getMapSize())
+		return false;
+
+	CGPathNode * oldRoot = getNode(previous.heroPos, ELayer::LAND);
+	CGPathNode * root = getNode(heroPos, ELayer::LAND);
+
+	if(root->theNodeBefore != oldRoot
+		|| root->turns != 0
+		|| root->action != EPathNodeAction::NORMAL
+		|| root->moveRemains != hero->movementPointsRemaining())
+		return false;
+
+	// hero standing on object or in guarded zone is allowed to move differently than hero passing through
+	if(gs->map->getTile(heroPos).visitableObjects.size() != 1 || gs->guardingCreaturePosition(heroPos).valid())
+		return false;
+
+	// tiles where accessibility changed since previous search invalidate all paths through them
+	std::vector<int3> dirtyTiles = {previous.heroPos};
+
+	if(!accessibility.forEachTileChangedSince(previous.accessibilityRevision, [&dirtyTiles](const int3 & pos){ dirtyTiles.push_back(pos); }))
+		return false;
+
+	vstd::removeDuplicates(dirtyTiles);
+	const std::unordered_set<int3> dirtyTilesSet(dirtyTiles.begin(), dirtyTiles.end());
+
+	for(const auto & pos : dirtyTiles)
+	{
+		forTileLayers(pos, options.useFlying, options.useWaterWalking, gs, accessibility, [this](const int3 & tile, ELayer layer, EPathAccessibility tileAccessibility)
+		{
+			CGPathNode * node = getNode(tile, layer);
+
+			if(node->layer == ELayer::WRONG || node->accessible != tileAccessibility)
+				node->update(tile, layer, tileAccessibility);
+		});
+	}
+
+	enum ENodeState : uint8_t
+	{
+		UNKNOWN,
+		RETAINED,
+		OUTDATED
+	};
+
+	std::unordered_map<const CGPathNode *, ENodeState> nodeStates;
+	nodeStates.reserve(out.reachedNodes.size());
+	std::vector<CGPathNode *> chain;
+
+	auto stateOf = [&nodeStates](const CGPathNode * node)
+	{
+		auto it = nodeStates.find(node);
+		return it == nodeStates.end() ? UNKNOWN : it->second;
+	};
+
+	nodeStates[root] = RETAINED;
+
+	for(CGPathNode * reachedNode : out.reachedNodes)
+	{
+		CGPathNode * node = reachedNode;
+
+		while(stateOf(node) == UNKNOWN)
+		{
+			if(!node->reachable() || !node->theNodeBefore || dirtyTilesSet.count(node->coord))
+			{
+				nodeStates[node] = OUTDATED;
+				break;
+			}
+			chain.push_back(node);
+			node = node->theNodeBefore;
+		}
+
+		const ENodeState state = stateOf(node);
+		for(auto * chainNode : chain)
+			nodeStates[chainNode] = state;
+		chain.clear();
+	}
+
+	// retained nodes next to nodes that need to be searched again are starting points of repair
+	// nodes that were not reachable before can only become reachable through changed tiles
+	std::vector<int3> searchedTiles = dirtyTiles;
+	for(const CGPathNode * node : out.reachedNodes)
+	{
+		if(stateOf(node) == OUTDATED)
+			searchedTiles.push_back(node->coord);
+	}
+
+	std::unordered_set<const CGPathNode *> seeds;
+	auto addSeed = [&](CGPathNode * node)
+	{
+		if(seeds.insert(node).second)
+			repairSeeds.push_back(node);
+	};
+
+	addSeed(root);
+
+	for(const auto & tile : searchedTiles)
+	{
+		for(int dx = -1; dx <= 1; dx++)
+		{
+			for(int dy = -1; dy <= 1; dy++)
+			{
+				int3 pos = tile + int3(dx, dy, 0);
+				if(!gs->isInTheMap(pos))
+					continue;
+
+				for(ELayer layer = ELayer::LAND; layer < ELayer::NUM_LAYERS; layer.advance(1))
 				{
-					resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
-					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+					CGPathNode * node = getNode(pos, layer);
+					if(node->layer != ELayer::WRONG && stateOf(node) == RETAINED)
+						addSeed(node);
 				}
 			}
 		}
 	}
+
+	std::vector<CGPathNode *> retainedNodes;
+	const float rootCost = root->getCost();
+
+	for(CGPathNode * node : out.reachedNodes)
+	{
+		if(stateOf(node) == RETAINED)
+		{
+			// teleports and other objects may lead to distant tiles
+			if(gs->map->getTile(node->coord).visitable())
+				addSeed(node);
+
+			node->cost = std::max(0.0f, node->cost - rootCost);
+			node->locked = true;
+			retainedNodes.push_back(node);
+		}
+		else
+		{
+			auto nodeAccessibility = node->accessible;
+			node->reset();
+			node->accessible = nodeAccessibility;
+		}
+	}
+
+	out.reachedNodes = std::move(retainedNodes);
+
+	for(auto * seed : repairSeeds)
+		seed->locked = false;
+
+	root->cost = 0;
+	root->theNodeBefore = nullptr;
+	root->action = EPathNodeAction::UNKNOWN;
+
+	return true;
+}
+
+bool NodeStorage::isRepairing() const
+{
+	return !repairSeeds.empty();
 }
 
 void NodeStorage::calculateNeighbours(
@@ -126,8 +374,14 @@ void NodeStorage::resetTile(const int3 & tile, const EPathfindingLayer & layer,
 
 std::vector<CGPathNode *> NodeStorage::getInitialNodes()
 {
+	if(isRepairing())
+		return repairSeeds;
+
 	auto * initialNode = getNode(out.hpos, out.hero->boat ? out.hero->boat->layer : EPathfindingLayer::LAND);
 
+	if(!initialNode->reachable())
+		out.reachedNodes.push_back(initialNode);
+
 	initialNode->turns = 0;
 	initialNode->moveRemains = out.hero->movementPointsRemaining();
 	initialNode->setCost(0.0);
@@ -143,6 +397,8 @@ std::vector<CGPathNode *> NodeStorage::getInitialNodes()
 void NodeStorage::commit(CDestinationNodeInfo & destination, const PathNodeInfo & source)
 {
 	assert(destination.node != source.node->theNodeBefore); //two tiles can't point to each other
+	if(!destination.node->reachable())
+		out.reachedNodes.push_back(destination.node);
 	destination.node->setCost(destination.cost);
 	destination.node->moveRemains = destination.movementLeft;
 	destination.node->turns = destination.turn;
@@ -14,14 +14,26 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+class PathfinderAccessibility;
+
 class DLL_LINKAGE NodeStorage : public INodeStorage
 {
 private:
 	CPathsInfo & out;
+	std::vector<CGPathNode *> repairSeeds; //initial nodes of repaired search, empty if paths are calculated from scratch
 
 	STRONG_INLINE
 	void resetTile(const int3 & tile, const EPathfindingLayer & layer, EPathAccessibility accessibility);
 
+	template<typename Handler>
+	void forTileLayers(const int3 & pos, bool useFlying, bool useWaterWalking, const CGameState * gs, const PathfinderAccessibility & accessibility, const Handler & handler);
+
+	template<typename Handler>
+	void forEachTileLayer(const PathfinderOptions & options, const CGameState * gs, const PathfinderAccessibility & accessibility, const Handler & handler);
+
+	bool tryRepair(const PathfinderOptions & options, const CGameState * gs, const PathfinderAccessibility & accessibility, const CPathsInfo::SearchState & previous);
+	bool tryResetReachedNodes(const PathfinderOptions & options, const CGameState * gs, const PathfinderAccessibility & accessibility, const CPathsInfo::NodesState & previous);
+
 public:
 	NodeStorage(CPathsInfo & pathsInfo, const CGHeroInstance * hero);
 
@@ -32,6 +44,7 @@ public:
 	}
 
 	void initialize(const PathfinderOptions & options, const CGameState * gs) override;
+	bool isRepairing() const override;
 	virtual ~NodeStorage() = default;
 
 	std::vector<CGPathNode *> getInitialNodes() override;
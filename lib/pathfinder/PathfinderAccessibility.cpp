@@ -0,0 +1,170 @@
+/*
+ * PathfinderAccessibility.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "PathfinderAccessibility.h"
+
+#include "PathfinderUtil.h"
+
+#include "../CPlayerState.h"
+#include "../mapping/CMap.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+PathfinderAccessibility::PathfinderAccessibility(const CGameState * gs, const PlayerColor & player, const PlayerColor & fowPlayer)
+	: player(player)
+	, fowPlayer(fowPlayer)
+	, mapRevision(0)
+	, droppedChanges(0)
+	, loggedChanges(0)
+{
+	evaluateAll(gs);
+}
+
+bool PathfinderAccessibility::evaluateTile(const int3 & pos, const TerrainTile & tile, const boost::multi_array<ui8, 3> & fow, const CGameState * gs)
+{
+	using ELayer = EPathfindingLayer;
+
+	std::array<EPathAccessibility, ELayer::NUM_LAYERS> values;
+	values.fill(EPathAccessibility::NOT_SET);
+
+	if(tile.isWater())
+	{
+		values[ELayer::SAIL] = PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs);
+		values[ELayer::WATER] = PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs);
+	}
+	if(tile.isLand())
+	{
+		values[ELayer::LAND] = PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs);
+	}
+	values[ELayer::AIR] = PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs);
+
+	auto & column = columns[pos.z * sizes.x + pos.x];
+	const auto first = column->begin() + pos.y * ELayer::NUM_LAYERS;
+
+	if(std::equal(values.begin(), values.end(), first))
+		return false;
+
+	// column may still be used by searches through copy of this layer, do not modify it under them
+	if(column.use_count() > 1)
+		column = std::make_shared<Column>(*column);
+
+	std::copy(values.begin(), values.end(), column->begin() + pos.y * ELayer::NUM_LAYERS);
+	return true;
+}
+
+void PathfinderAccessibility::logChanges(std::shared_ptr<const ChangesPart> part)
+{
+	if(part->empty())
+		return;
+
+	loggedChanges += part->size();
+	changes.push_back(std::move(part));
+
+	// once log is longer than the map, searching from scratch is cheaper than replaying the log
+	// number of parts is limited as well, since every copy of layer copies list of parts
+	const size_t maxLogSize = sizes.x * sizes.y * sizes.z;
+	const size_t maxParts = 64;
+
+	while(loggedChanges > maxLogSize || changes.size() > maxParts)
+	{
+		droppedChanges += changes.front()->size();
+		loggedChanges -= changes.front()->size();
+		changes.erase(changes.begin());
+	}
+}
+
+void PathfinderAccessibility::evaluateAll(const CGameState * gs)
+{
+	int3 pos;
+	sizes = gs->getMapSize();
+
+	columns.resize(sizes.z * sizes.x);
+	for(auto & column : columns)
+		column = std::make_shared<Column>(sizes.y * EPathfindingLayer::NUM_LAYERS, EPathAccessibility::NOT_SET);
+
+	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(fowPlayer)->fogOfWarMap;
+	mapRevision = gs->map->getTileRevision();
+
+	// every tile is evaluated again, changes from any earlier revision are no longer known
+	droppedChanges += loggedChanges + 1;
+	loggedChanges = 0;
+	changes.clear();
+
+	for(pos.z=0; pos.z < sizes.z; ++pos.z)
+	{
+		for(pos.x=0; pos.x < sizes.x; ++pos.x)
+		{
+			for(pos.y=0; pos.y < sizes.y; ++pos.y)
+			{
+				evaluateTile(pos, gs->map->getTile(pos), fow, gs);
+			}
+		}
+	}
+}
+
+void PathfinderAccessibility::update(const CGameState * gs)
+{
+	if(sizes != gs->getMapSize())
+	{
+		evaluateAll(gs);
+		return;
+	}
+
+	// map log covers objects on tiles, state of these objects, guards and fog of war
+	std::vector<int3> dirtyTiles;
+
+	if(!gs->map->forEachTileChangedSince(mapRevision, [&dirtyTiles](const int3 & pos){ dirtyTiles.push_back(pos); }))
+	{
+		evaluateAll(gs);
+		return;
+	}
+
+	vstd::removeDuplicates(dirtyTiles);
+
+	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(fowPlayer)->fogOfWarMap;
+	auto changedTiles = std::make_shared<ChangesPart>();
+
+	for(const int3 & pos : dirtyTiles)
+	{
+		if(evaluateTile(pos, gs->map->getTile(pos), fow, gs))
+			changedTiles->push_back(pos);
+	}
+
+	logChanges(std::move(changedTiles));
+	mapRevision = gs->map->getTileRevision();
+}
+
+size_t PathfinderAccessibility::getRevision() const
+{
+	return droppedChanges + loggedChanges;
+}
+
+bool PathfinderAccessibility::forEachTileChangedSince(size_t revision, const std::function<void(const int3 &)> & handler) const
+{
+	if(revision < droppedChanges)
+		return false;
+
+	size_t skipped = revision - droppedChanges;
+	for(const auto & part : changes)
+	{
+		if(skipped >= part->size())
+		{
+			skipped -= part->size();
+			continue;
+		}
+
+		for(size_t i = skipped; i < part->size(); i++)
+			handler((*part)[i]);
+		skipped = 0;
+	}
+	return true;
+}
+
+VCMI_LIB_NAMESPACE_END
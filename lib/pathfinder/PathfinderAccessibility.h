@@ -0,0 +1,62 @@
+/*
+ * PathfinderAccessibility.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "CGPathNode.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class CGameState;
+struct TerrainTile;
+
+/// Accessibility of every tile and layer of the map for heroes of one player
+/// Does not depend on hero, so it is shared by all searches of that player, see CGameState::getPathfinderAccessibility
+/// Copies share all data with original, only parts modified by update() are copied
+class DLL_LINKAGE PathfinderAccessibility
+{
+	/// Accessibility of all layers of tiles in one column of the map, [y][layer], NOT_SET for layers that do not exist on tile
+	using Column = std::vector<EPathAccessibility>;
+	using ChangesPart = std::vector<int3>;
+
+	PlayerColor player;
+	PlayerColor fowPlayer; //player whose knowledge of map is used
+
+	int3 sizes;
+	std::vector<std::shared_ptr<Column>> columns; // [z][x], shared with copies of this layer until modified
+	size_t mapRevision; //revision of map tile log this layer is up to date with
+
+	std::vector<std::shared_ptr<const ChangesPart>> changes; //recent part of log of tiles whose accessibility changed, one part per update
+	size_t droppedChanges; //number of changes already removed from start of the log
+	size_t loggedChanges; //number of changes in the log
+
+	/// Returns true if accessibility of any layer changed
+	bool evaluateTile(const int3 & pos, const TerrainTile & tile, const boost::multi_array<ui8, 3> & fow, const CGameState * gs);
+	void evaluateAll(const CGameState * gs);
+	void logChanges(std::shared_ptr<const ChangesPart> part);
+
+public:
+	PathfinderAccessibility(const CGameState * gs, const PlayerColor & player, const PlayerColor & fowPlayer);
+
+	/// Re-evaluates tiles recorded in map tile log since last update, which includes changes of visibility and object state
+	void update(const CGameState * gs);
+
+	/// Number of accessibility changes done so far, lets search results be repaired instead of recalculated
+	size_t getRevision() const;
+	/// Calls handler for every tile with accessibility changed since given revision, returns false if these changes are no longer known
+	bool forEachTileChangedSince(size_t revision, const std::function<void(const int3 &)> & handler) const;
+
+	STRONG_INLINE
+	EPathAccessibility get(const int3 & pos, const EPathfindingLayer & layer) const
+	{
+		return (*columns[pos.z * sizes.x + pos.x])[pos.y * EPathfindingLayer::NUM_LAYERS + layer.getNum()];
+	}
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -36,6 +36,7 @@ PathfinderOptions::PathfinderOptions(const CGameInfoCallback * cb)
 	, canUseCast(false)
 	, allowLayerTransitioningAfterBattle(false)
 	, forceUseTeleportWhirlpool(false)
+	, queueType(EPathfinderQueue::FIBONACCI_HEAP)
 {
 }
 
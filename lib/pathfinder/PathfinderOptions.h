@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include "PathfinderQueue.h"
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 class INodeStorage;
@@ -85,6 +87,9 @@ struct DLL_LINKAGE PathfinderOptions
 	/// </summary>
 	bool allowLayerTransitioningAfterBattle;
 
+	/// Priority queue implementation used by pathfinder, all of them produce paths of same cost
+	EPathfinderQueue queueType;
+
 	PathfinderOptions(const CGameInfoCallback * callback);
 };
 
@@ -0,0 +1,271 @@
+/*
+ * PathfinderQueue.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "PathfinderQueue.h"
+
+#include "CGPathNode.h"
+
+#include <boost/heap/fibonacci_heap.hpp>
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class FibonacciPathfinderQueue : public IPathfinderQueue
+{
+	using TFibHeap = boost::heap::fibonacci_heap<CGPathNode *, boost::heap::compare<NodeComparer<CGPathNode>>>;
+
+	TFibHeap heap;
+	std::vector<TFibHeap::handle_type> handles; // indexed by CGPathNode::pqIndex
+	std::vector<uint32_t> freeHandles;
+
+public:
+	void push(CGPathNode * node) override
+	{
+		if(freeHandles.empty())
+		{
+			node->pqIndex = handles.size();
+			handles.emplace_back();
+		}
+		else
+		{
+			node->pqIndex = freeHandles.back();
+			freeHandles.pop_back();
+		}
+
+		node->pq = this;
+		handles[node->pqIndex] = heap.push(node);
+	}
+
+	CGPathNode * topAndPop() override
+	{
+		auto * node = heap.top();
+
+		heap.pop();
+		freeHandles.push_back(node->pqIndex);
+		node->pq = nullptr;
+		return node;
+	}
+
+	bool empty() const override
+	{
+		return heap.empty();
+	}
+
+	void update(CGPathNode * node, bool costDecreased) override
+	{
+		if(costDecreased)
+			heap.increase(handles[node->pqIndex]);
+		else
+			heap.decrease(handles[node->pqIndex]);
+	}
+};
+
+class QuaternaryHeapPathfinderQueue : public IPathfinderQueue
+{
+	static constexpr size_t ARITY = 4;
+
+	std::vector<CGPathNode *> heap; // CGPathNode::pqIndex is position of node in this array
+
+	void place(CGPathNode * node, size_t index)
+	{
+		heap[index] = node;
+		node->pqIndex = index;
+	}
+
+	void siftUp(size_t index)
+	{
+		CGPathNode * node = heap[index];
+
+		while(index > 0)
+		{
+			size_t parent = (index - 1) / ARITY;
+
+			if(heap[parent]->getCost() <= node->getCost())
+				break;
+
+			place(heap[parent], index);
+			index = parent;
+		}
+		place(node, index);
+	}
+
+	void siftDown(size_t index)
+	{
+		CGPathNode * node = heap[index];
+
+		for(;;)
+		{
+			size_t firstChild = index * ARITY + 1;
+			if(firstChild >= heap.size())
+				break;
+
+			size_t lastChild = std::min(firstChild + ARITY, heap.size());
+			size_t best = firstChild;
+			for(size_t child = firstChild + 1; child < lastChild; child++)
+			{
+				if(heap[child]->getCost() < heap[best]->getCost())
+					best = child;
+			}
+
+			if(node->getCost() <= heap[best]->getCost())
+				break;
+
+			place(heap[best], index);
+			index = best;
+		}
+		place(node, index);
+	}
+
+public:
+	void push(CGPathNode * node) override
+	{
+		node->pq = this;
+		heap.push_back(node);
+		siftUp(heap.size() - 1);
+	}
+
+	CGPathNode * topAndPop() override
+	{
+		CGPathNode * node = heap.front();
+
+		heap.front() = heap.back();
+		heap.pop_back();
+		if(!heap.empty())
+			siftDown(0);
+
+		node->pq = nullptr;
+		return node;
+	}
+
+	bool empty() const override
+	{
+		return heap.empty();
+	}
+
+	void update(CGPathNode * node, bool costDecreased) override
+	{
+		if(costDecreased)
+			siftUp(node->pqIndex);
+		else
+			siftDown(node->pqIndex);
+	}
+};
+
+/// Dial-like queue: costs of popped nodes do not decrease during search, so nodes are distributed into
+/// buckets of fixed cost range and only lowest non-empty bucket is searched for exact minimum.
+/// Updated nodes are pushed again and outdated entries are skipped when met.
+/// Every insertion gets new stamp stored in entry and in CGPathNode::pqIndex, so only latest entry of node is valid
+/// even if node returns to cost of older entry or is popped and pushed again.
+class BucketPathfinderQueue : public IPathfinderQueue
+{
+	static constexpr float BUCKETS_PER_TURN = 64;
+
+	struct Entry
+	{
+		CGPathNode * node;
+		float cost;
+		uint32_t stamp;
+	};
+
+	std::vector<std::vector<Entry>> buckets;
+	size_t currentBucket = 0;
+	size_t queuedNodes = 0;
+	uint32_t lastStamp = 0;
+
+	size_t bucketIndex(float cost) const
+	{
+		return static_cast<size_t>(std::max(0.0f, cost) * BUCKETS_PER_TURN);
+	}
+
+	void insert(CGPathNode * node)
+	{
+		size_t index = bucketIndex(node->getCost());
+		if(index >= buckets.size())
+			buckets.resize(index + 1);
+
+		// should not happen as long as movement costs are not negative
+		vstd::amin(currentBucket, index);
+
+		node->pqIndex = ++lastStamp;
+		buckets[index].push_back({node, node->getCost(), node->pqIndex});
+	}
+
+	static bool isOutdated(const Entry & entry)
+	{
+		return !entry.node->inPQ() || entry.stamp != entry.node->pqIndex;
+	}
+
+public:
+	void push(CGPathNode * node) override
+	{
+		if(queuedNodes == 0)
+		{
+			// drop outdated entries left from previous search
+			for(auto & bucket : buckets)
+				bucket.clear();
+			currentBucket = 0;
+		}
+
+		node->pq = this;
+		queuedNodes++;
+		insert(node);
+	}
+
+	CGPathNode * topAndPop() override
+	{
+		for(;; currentBucket++)
+		{
+			auto & bucket = buckets[currentBucket];
+
+			vstd::erase_if(bucket, isOutdated);
+			if(bucket.empty())
+				continue;
+
+			auto best = bucket.begin();
+			for(auto it = bucket.begin() + 1; it != bucket.end(); ++it)
+			{
+				if(it->cost < best->cost)
+					best = it;
+			}
+
+			CGPathNode * node = best->node;
+			*best = bucket.back();
+			bucket.pop_back();
+
+			queuedNodes--;
+			node->pq = nullptr;
+			return node;
+		}
+	}
+
+	bool empty() const override
+	{
+		return queuedNodes == 0;
+	}
+
+	void update(CGPathNode * node, bool costDecreased) override
+	{
+		insert(node);
+	}
+};
+
+std::unique_ptr<IPathfinderQueue> IPathfinderQueue::create(EPathfinderQueue type)
+{
+	switch(type)
+	{
+	case EPathfinderQueue::FIBONACCI_HEAP:
+		return std::make_unique<FibonacciPathfinderQueue>();
+	case EPathfinderQueue::BUCKET_QUEUE:
+		return std::make_unique<BucketPathfinderQueue>();
+	default:
+		return std::make_unique<QuaternaryHeapPathfinderQueue>();
+	}
+}
+
+VCMI_LIB_NAMESPACE_END
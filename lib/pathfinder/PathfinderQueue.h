@@ -0,0 +1,40 @@
+/*
+ * PathfinderQueue.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+struct CGPathNode;
+
+enum class EPathfinderQueue : ui8
+{
+	FIBONACCI_HEAP, // boost::heap::fibonacci_heap, one allocation per pushed node
+	QUATERNARY_HEAP, // indexed 4-ary heap stored in single array
+	BUCKET_QUEUE // nodes bucketed by quantized cost, exact minimum is searched only within lowest bucket
+};
+
+/// Priority queue of path nodes, node with lowest cost is popped first
+/// Node keeps pointer to queue it is in, so queue is notified when cost of queued node changes
+class DLL_LINKAGE IPathfinderQueue
+{
+public:
+	virtual ~IPathfinderQueue() = default;
+
+	virtual void push(CGPathNode * node) = 0;
+	virtual CGPathNode * topAndPop() = 0;
+	virtual bool empty() const = 0;
+
+	/// Called by node when its cost has changed while being in queue
+	virtual void update(CGPathNode * node, bool costDecreased) = 0;
+
+	static std::unique_ptr<IPathfinderQueue> create(EPathfinderQueue type);
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -29,7 +29,7 @@
 #include "Zone.h"
 #include "Functions.h"
 #include "RmgMap.h"
-#include "threadpool/ThreadPool.h"
+#include "threadpool/ModificatorScheduler.h"
 #include "modificators/ObjectManager.h"
 #include "modificators/TreasurePlacer.h"
 #include "modificators/RoadPlacer.h"
@@ -94,6 +94,23 @@ const CMapGenerator::Config & CMapGenerator::getConfig() const
 	return config;
 }
 
+void CMapGenerator::setSingleThread(bool value)
+{
+	config.singleThread = value;
+}
+
+const CMapGenerator::PhaseTimings & CMapGenerator::getPhaseTimings() const
+{
+	return phaseTimings;
+}
+
+void CMapGenerator::measurePhase(const std::string & phase, const std::function<void()> & function)
+{
+	auto start = std::chrono::steady_clock::now();
+	function();
+	phaseTimings.emplace_back(phase, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+}
+
 //must be instantiated in .cpp file for access to complete types of all member fields
 CMapGenerator::~CMapGenerator() = default;
 
@@ -118,18 +135,31 @@ std::unique_ptr<CMap> CMapGenerator::generate()
 {
 	Load::Progress::reset();
 	Load::Progress::setupStepsTill(5, 30);
+	phaseTimings.clear();
 	try
 	{
-		addHeaderInfo();
-		map->initTiles(*this, *rand);
-		Load::Progress::step();
-		initQuestArtsRemaining();
-		genZones();
+		measurePhase("initialization", [this]()
+		{
+			addHeaderInfo();
+			map->initTiles(*this, *rand);
+			Load::Progress::step();
+			initQuestArtsRemaining();
+		});
+		measurePhase("zonePlacement", [this]()
+		{
+			genZones();
+		});
 		Load::Progress::step();
-		map->getMap(this).calculateGuardingGreaturePositions(); //clear map so that all tiles are unguarded
-		map->addModificators();
+		measurePhase("modificatorsSetup", [this]()
+		{
+			map->getMap(this).calculateGuardingGreaturePositions(); //clear map so that all tiles are unguarded
+			map->addModificators();
+		});
 		Load::Progress::step(3);
-		fillZones();
+		measurePhase("fillZones", [this]()
+		{
+			fillZones();
+		});
 		//updated guarded tiles will be calculated in CGameState::initMapObjects()
 		map->getZones().clear();
 
@@ -372,66 +402,31 @@ void CMapGenerator::fillZones()
 
 	Load::Progress::setupStepsTill(allJobs.size(), 240);
 
-	if (config.singleThread) //No thread pool, just queue with deterministic order
+	ModificatorScheduler scheduler(allJobs, [this]()
 	{
-		while (!allJobs.empty())
-		{
-			for (auto it = allJobs.begin(); it != allJobs.end();)
-			{
-				if ((*it)->isReady())
-				{
-					auto jobCopy = *it;
-					jobCopy->run();
-					Progress::Progress::step(); //Update progress bar
-					allJobs.erase(it);
-					break; //Restart from the first job
-				}
-				else
-				{
-					++it;
-				}
-			}
-		}
+		Progress::Progress::step(); //Update progress bar
+	});
+
+	if (config.singleThread) //No thread pool, deterministic order
+	{
+		scheduler.runSequential();
 	}
 	else
 	{
-		ThreadPool pool;
-		std::vector<boost::future<void>> futures;
 		//At most one Modificator can run for every zone
-		pool.init(std::min<int>(boost::thread::hardware_concurrency(), numZones));
-
-		while (!allJobs.empty())
-		{
-			for (auto it = allJobs.begin(); it != allJobs.end();)
-			{
-				if ((*it)->isFinished())
-				{
-					it = allJobs.erase(it);
-					Progress::Progress::step();
-				}
-				else if ((*it)->isReady())
-				{
-					auto jobCopy = *it;
-					futures.emplace_back(pool.async([this, jobCopy]() -> void
-						{
-							jobCopy->run();
-							Progress::Progress::step(); //Update progress bar
-						}
-					));
-					it = allJobs.erase(it);
-				}
-				else
-				{
-					++it;
-				}
-			}
-		}
+		scheduler.runParallel(std::min<size_t>(boost::thread::hardware_concurrency(), numZones));
+	}
 
-		//Wait for all the tasks
-		for (auto& fut : futures)
+	for (const auto & modificator : allJobs)
+	{
+		auto it = boost::find_if(phaseTimings, [&modificator](const auto & phase)
 		{
-			fut.get();
-		}
+			return phase.first == modificator->getName();
+		});
+		if (it == phaseTimings.end())
+			phaseTimings.emplace_back(modificator->getName(), modificator->getProcessTime());
+		else
+			it->second += modificator->getProcessTime();
 	}
 
 	for (const auto& it : map->getZones())
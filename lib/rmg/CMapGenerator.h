@@ -53,11 +53,17 @@ public:
 		std::vector<int> questRewardValues;
 		bool singleThread;
 	};
+
+	/// Wall time of generation phases, time of each modificator type is summed over all zones
+	using PhaseTimings = std::vector<std::pair<std::string, std::chrono::microseconds>>;
 	
 	explicit CMapGenerator(CMapGenOptions& mapGenOptions, IGameCallback * cb, int RandomSeed);
 	~CMapGenerator(); // required due to std::unique_ptr
 	
 	const Config & getConfig() const;
+	/// Run all modificators on calling thread, so generated map depends only on options and seed
+	void setSingleThread(bool value);
+	const PhaseTimings & getPhaseTimings() const;
 	
 	const CMapGenOptions& getMapGenOptions() const;
 	
@@ -87,6 +93,7 @@ private:
 	
 	int monolithIndex;
 	std::vector<ArtifactID> questArtifacts;
+	PhaseTimings phaseTimings;
 
 	/// Generation methods
 	void loadConfig();
@@ -99,6 +106,7 @@ private:
 	void addHeaderInfo();
 	void genZones();
 	void fillZones();
+	void measurePhase(const std::string & phase, const std::function<void()> & function);
 };
 
 VCMI_LIB_NAMESPACE_END
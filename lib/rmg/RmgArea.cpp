@@ -32,55 +32,217 @@ void toRelative(Tileset & tiles, const int3 & position)
 	toAbsolute(tiles, -position);
 }
 
-Area::Area(const Area & area): dTiles(area.dTiles), dTotalShiftCache(area.dTotalShiftCache)
+namespace
 {
+	constexpr int WORD_BITS = 64;
+
+	int floorDiv(int value, int divisor)
+	{
+		return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+	}
+
+	int countTrailingZeros(uint64_t word)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
 }
 
-Area::Area(Area && area) noexcept: dTiles(std::move(area.dTiles)), dTotalShiftCache(area.dTotalShiftCache)
+Area::Area(const Area & area)
+	: dOrigin(area.dOrigin)
+	, dSize(area.dSize)
+	, dRowWords(area.dRowWords)
+	, dBits(area.dBits)
 {
 }
 
+Area::Area(Area && area) noexcept
+	: dOrigin(area.dOrigin)
+	, dSize(area.dSize)
+	, dRowWords(area.dRowWords)
+	, dBits(std::move(area.dBits))
+{
+	area.clear();
+}
+
 Area & Area::operator=(const Area & area)
 {
-	clear();
-	dTiles = area.dTiles;
-	dTotalShiftCache = area.dTotalShiftCache;
+	if(this == &area)
+		return *this;
+
+	invalidate();
+	dOrigin = area.dOrigin;
+	dSize = area.dSize;
+	dRowWords = area.dRowWords;
+	dBits = area.dBits;
 	return *this;
 }
 
-Area::Area(Tileset tiles): dTiles(std::move(tiles))
+Area::Area(Tileset tiles)
 {
+	assign(tiles);
 }
 
-Area::Area(Tileset relative, const int3 & position): dTiles(std::move(relative)), dTotalShiftCache(position)
+Area::Area(Tileset relative, const int3 & position)
 {
+	toAbsolute(relative, position);
+	assign(relative);
 }
 
 void Area::invalidate()
 {
-	getTiles();
+	dTilesCache.clear();
 	dTilesVectorCache.clear();
 	dBorderCache.clear();
 	dBorderOutsideCache.clear();
 }
 
+void Area::reserve(const int3 & min, const int3 & max, bool withSlack)
+{
+	const int3 oldMax = dOrigin + dSize - int3(1, 1, 1);
+
+	if(!dBits.empty() && min.x >= dOrigin.x && min.y >= dOrigin.y && min.z >= dOrigin.z
+		&& max.x <= oldMax.x && max.y <= oldMax.y && max.z <= oldMax.z)
+		return;
+
+	int3 newMin = min;
+	int3 newMax = max;
+
+	if(!dBits.empty())
+	{
+		newMin = int3(std::min(min.x, dOrigin.x), std::min(min.y, dOrigin.y), std::min(min.z, dOrigin.z));
+		newMax = int3(std::max(max.x, oldMax.x), std::max(max.y, oldMax.y), std::max(max.z, oldMax.z));
+
+		if(withSlack)
+		{
+			// area that grows tile by tile should not be copied on every step
+			const int slackX = std::max(8, dSize.x / 2);
+			const int slackY = std::max(8, dSize.y / 2);
+			if(newMin.x < dOrigin.x)
+				newMin.x -= slackX;
+			if(newMax.x > oldMax.x)
+				newMax.x += slackX;
+			if(newMin.y < dOrigin.y)
+				newMin.y -= slackY;
+			if(newMax.y > oldMax.y)
+				newMax.y += slackY;
+		}
+	}
+
+	Area old(std::move(*this));
+
+	dOrigin = newMin;
+	dSize = newMax - newMin + int3(1, 1, 1);
+	dRowWords = (dSize.x + WORD_BITS - 1) / WORD_BITS;
+	dBits.assign(static_cast<size_t>(dRowWords) * dSize.y * dSize.z, 0);
+
+	if(old.dBits.empty())
+		return;
+
+	for(int z = old.dOrigin.z; z < old.dOrigin.z + old.dSize.z; z++)
+	{
+		for(int y = old.dOrigin.y; y < old.dOrigin.y + old.dSize.y; y++)
+		{
+			for(int w = 0; w < dRowWords; w++)
+				word(w, y, z) = old.getWord(dOrigin.x + w * WORD_BITS, y, z);
+		}
+	}
+
+	// bits past right end of bounding box must stay empty, copied row may be longer
+	const int tailBits = dSize.x % WORD_BITS;
+	if(tailBits)
+	{
+		const uint64_t tailMask = (uint64_t(1) << tailBits) - 1;
+		for(size_t i = dRowWords - 1; i < dBits.size(); i += dRowWords)
+			dBits[i] &= tailMask;
+	}
+}
+
+uint64_t & Area::word(int wordIndex, int y, int z)
+{
+	return dBits[(static_cast<size_t>(z - dOrigin.z) * dSize.y + (y - dOrigin.y)) * dRowWords + wordIndex];
+}
+
+const uint64_t & Area::word(int wordIndex, int y, int z) const
+{
+	return dBits[(static_cast<size_t>(z - dOrigin.z) * dSize.y + (y - dOrigin.y)) * dRowWords + wordIndex];
+}
+
+bool Area::testBit(const int3 & tile) const
+{
+	const int3 rel = tile - dOrigin;
+	if(dBits.empty() || rel.x < 0 || rel.y < 0 || rel.z < 0 || rel.x >= dSize.x || rel.y >= dSize.y || rel.z >= dSize.z)
+		return false;
+
+	return (word(rel.x / WORD_BITS, tile.y, tile.z) >> (rel.x % WORD_BITS)) & 1;
+}
+
+uint64_t Area::getWord(int x, int y, int z) const
+{
+	if(dBits.empty() || y < dOrigin.y || y >= dOrigin.y + dSize.y || z < dOrigin.z || z >= dOrigin.z + dSize.z)
+		return 0;
+
+	const int relX = x - dOrigin.x;
+	const int wordIndex = floorDiv(relX, WORD_BITS);
+	const int shift = relX - wordIndex * WORD_BITS;
+
+	uint64_t result = 0;
+	if(wordIndex >= 0 && wordIndex < dRowWords)
+		result = word(wordIndex, y, z) >> shift;
+	if(shift && wordIndex + 1 >= 0 && wordIndex + 1 < dRowWords)
+		result |= word(wordIndex + 1, y, z) << (WORD_BITS - shift);
+	return result;
+}
+
+template<typename Handler>
+void Area::forEachTile(const Handler & handler) const
+{
+	if(dBits.empty())
+		return;
+
+	for(int z = dOrigin.z; z < dOrigin.z + dSize.z; z++)
+	{
+		for(int y = dOrigin.y; y < dOrigin.y + dSize.y; y++)
+		{
+			for(int w = 0; w < dRowWords; w++)
+			{
+				uint64_t bits = word(w, y, z);
+				while(bits)
+				{
+					handler(int3(dOrigin.x + w * WORD_BITS + countTrailingZeros(bits), y, z));
+					bits &= bits - 1;
+				}
+			}
+		}
+	}
+}
+
 bool Area::connected(bool noDiagonals) const
 {
-	std::list<int3> queue({*dTiles.begin()});
-	Tileset connected = dTiles; //use invalidated cache - ok
+	if(empty())
+		return true;
+
+	Area remaining(*this);
+	std::vector<int3> queue({getTilesVector().front()});
+	remaining.erase(queue.front());
 
 	while(!queue.empty())
 	{
-		auto t = queue.front();
-		connected.erase(t);
-		queue.pop_front();
+		auto t = queue.back();
+		queue.pop_back();
 		
 		if (noDiagonals)
 		{
 			for (auto& i : dirs4)
 			{
-				if (connected.count(t + i))
+				if (remaining.testBit(t + i))
 				{
+					remaining.erase(t + i);
 					queue.push_back(t + i);
 				}
 			}
@@ -89,15 +251,16 @@ bool Area::connected(bool noDiagonals) const
 		{
 			for (auto& i : int3::getDirs())
 			{
-				if (connected.count(t + i))
+				if (remaining.testBit(t + i))
 				{
+					remaining.erase(t + i);
 					queue.push_back(t + i);
 				}
 			}
 		}
 	}
 	
-	return connected.empty();
+	return remaining.empty();
 }
 
 std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections)
@@ -108,68 +271,83 @@ std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnection
 		dirs.assign(rmg::dirs4.begin(), rmg::dirs4.end());
 	
 	std::list<Area> result;
-	Tileset connected = area.getTiles();
-	while(!connected.empty())
+	Area remaining(area);
+	for(const auto & start : area.getTilesVector())
 	{
+		if(!remaining.testBit(start))
+			continue;
+
 		result.emplace_back();
-		std::list<int3> queue({*connected.begin()});
-		std::set<int3> queueSet({*connected.begin()});
+		Tileset component;
+		std::vector<int3> queue({start});
+		remaining.erase(start);
 		while(!queue.empty())
 		{
-			auto t = queue.front();
-			connected.erase(t);
-			result.back().add(t);
-			queue.pop_front();
+			auto t = queue.back();
+			queue.pop_back();
+			component.insert(t);
 			
 			for(auto & i : dirs)
 			{
 				auto tile = t + i;
-				if(!queueSet.count(tile) && connected.count(tile) && !result.back().contains(tile))
+				if(remaining.testBit(tile))
 				{
-					queueSet.insert(tile);
+					remaining.erase(tile);
 					queue.push_back(tile);
 				}
 			}
 		}
+		result.back().assign(component);
 	}
 	return result;
 }
 
 const Tileset & Area::getTiles() const
 {
-	if(dTotalShiftCache != int3())
+	if(dTilesCache.empty())
 	{
-		toAbsolute(dTiles, dTotalShiftCache);
-		dTotalShiftCache = int3();
+		const auto & tiles = getTilesVector();
+		dTilesCache.reserve(tiles.size());
+		dTilesCache.insert(tiles.begin(), tiles.end());
 	}
-	return dTiles;
+	return dTilesCache;
 }
 
 const std::vector<int3> & Area::getTilesVector() const
 {
 	if(dTilesVectorCache.empty())
 	{
-		getTiles();
-		dTilesVectorCache.assign(dTiles.begin(), dTiles.end());
+		forEachTile([this](const int3 & tile)
+		{
+			dTilesVectorCache.push_back(tile);
+		});
 	}
 	return dTilesVectorCache;
 }
 
 const Tileset & Area::getBorder() const
 {
-	if(!dBorderCache.empty())
+	if(!dBorderCache.empty() || dBits.empty())
 		return dBorderCache;
 	
-	//compute border cache
-	dBorderCache.reserve(dTiles.bucket_count());
-	for(const auto & t : dTiles)
+	//tiles that are missing at least one neighbour
+	for(int z = dOrigin.z; z < dOrigin.z + dSize.z; z++)
 	{
-		for(auto & i : int3::getDirs())
+		for(int y = dOrigin.y; y < dOrigin.y + dSize.y; y++)
 		{
-			if(!dTiles.count(t + i))
+			for(int w = 0; w < dRowWords; w++)
 			{
-				dBorderCache.insert(t + dTotalShiftCache);
-				break;
+				const int x = dOrigin.x + w * WORD_BITS;
+				uint64_t surrounded = word(w, y, z);
+				for(auto & i : int3::getDirs())
+					surrounded &= getWord(x + i.x, y + i.y, z);
+
+				uint64_t border = word(w, y, z) & ~surrounded;
+				while(border)
+				{
+					dBorderCache.insert(int3(x + countTrailingZeros(border), y, z));
+					border &= border - 1;
+				}
 			}
 		}
 	}
@@ -179,17 +357,29 @@ const Tileset & Area::getBorder() const
 
 const Tileset & Area::getBorderOutside() const
 {
-	if(!dBorderOutsideCache.empty())
+	if(!dBorderOutsideCache.empty() || dBits.empty())
 		return dBorderOutsideCache;
 	
-	//compute outside border cache
-	dBorderOutsideCache.reserve(dBorderCache.bucket_count() * 2);
-	for(const auto & t : dTiles)
+	//tiles outside of area with at least one neighbour in area
+	const int rowWords = (dSize.x + 2 + WORD_BITS - 1) / WORD_BITS;
+	for(int z = dOrigin.z; z < dOrigin.z + dSize.z; z++)
 	{
-		for(auto & i : int3::getDirs())
+		for(int y = dOrigin.y - 1; y <= dOrigin.y + dSize.y; y++)
 		{
-			if(!dTiles.count(t + i))
-				dBorderOutsideCache.insert(t + i + dTotalShiftCache);
+			for(int w = 0; w < rowWords; w++)
+			{
+				const int x = dOrigin.x - 1 + w * WORD_BITS;
+				uint64_t neighbours = 0;
+				for(auto & i : int3::getDirs())
+					neighbours |= getWord(x + i.x, y + i.y, z);
+
+				uint64_t border = neighbours & ~getWord(x, y, z);
+				while(border)
+				{
+					dBorderOutsideCache.insert(int3(x + countTrailingZeros(border), y, z));
+					border &= border - 1;
+				}
+			}
 		}
 	}
 	
@@ -200,27 +390,62 @@ DistanceMap Area::computeDistanceMap(std::map<int, Tileset> & reverseDistanceMap
 {
 	reverseDistanceMap.clear();
 	DistanceMap result;
-	auto area = *this;
-	int distance = 0;
+	if(dBits.empty())
+		return result;
 	
-	while(!area.empty())
+	//multi-source BFS from border tiles, gives same layers as repeated removal of area border
+	std::vector<int> distances(static_cast<size_t>(dSize.x) * dSize.y * dSize.z, -1);
+	auto distanceAt = [this, &distances](const int3 & tile) -> int &
 	{
-		for(const auto & tile : area.getBorder())
-			result[tile] = distance;
-		reverseDistanceMap[distance++] = area.getBorder();
-		area.subtract(area.getBorder());
+		return distances[(static_cast<size_t>(tile.z - dOrigin.z) * dSize.y + (tile.y - dOrigin.y)) * dSize.x + (tile.x - dOrigin.x)];
+	};
+
+	std::vector<int3> queue;
+	forEachTile([this, &queue, &distanceAt](const int3 & tile)
+	{
+		for(auto & i : int3::getDirs())
+		{
+			if(!testBit(tile + i))
+			{
+				distanceAt(tile) = 0;
+				queue.push_back(tile);
+				break;
+			}
+		}
+	});
+
+	for(size_t head = 0; head < queue.size(); head++)
+	{
+		const int3 tile = queue[head];
+		const int distance = distanceAt(tile);
+		result[tile] = distance;
+		reverseDistanceMap[distance].insert(tile);
+
+		for(auto & i : int3::getDirs())
+		{
+			if(testBit(tile + i) && distanceAt(tile + i) < 0)
+			{
+				distanceAt(tile + i) = distance + 1;
+				queue.push_back(tile + i);
+			}
+		}
 	}
 	return result;
 }
 
 bool Area::empty() const
 {
-	return dTiles.empty();
+	for(const auto & bits : dBits)
+	{
+		if(bits)
+			return false;
+	}
+	return true;
 }
 
 bool Area::contains(const int3 & tile) const
 {
-	return dTiles.count(tile - dTotalShiftCache);
+	return testBit(tile);
 }
 
 bool Area::contains(const std::vector<int3> & tiles) const
@@ -235,12 +460,22 @@ bool Area::contains(const std::vector<int3> & tiles) const
 
 bool Area::contains(const Area & area) const
 {
-	return contains(area.getTilesVector());
+	for(int z = area.dOrigin.z; z < area.dOrigin.z + area.dSize.z; z++)
+	{
+		for(int y = area.dOrigin.y; y < area.dOrigin.y + area.dSize.y; y++)
+		{
+			for(int w = 0; w < area.dRowWords; w++)
+			{
+				if(area.word(w, y, z) & ~getWord(area.dOrigin.x + w * WORD_BITS, y, z))
+					return false;
+			}
+		}
+	}
+	return true;
 }
 
 bool Area::overlap(const std::vector<int3> & tiles) const
 {
-	// Important: Make sure that tiles.size < area.size
 	for(const auto & t : tiles)
 	{
 		if(contains(t))
@@ -251,7 +486,26 @@ bool Area::overlap(const std::vector<int3> & tiles) const
 
 bool Area::overlap(const Area & area) const
 {
-	return overlap(area.getTilesVector());
+	if(dBits.empty() || area.dBits.empty())
+		return false;
+
+	const int minZ = std::max(dOrigin.z, area.dOrigin.z);
+	const int maxZ = std::min(dOrigin.z + dSize.z, area.dOrigin.z + area.dSize.z);
+	const int minY = std::max(dOrigin.y, area.dOrigin.y);
+	const int maxY = std::min(dOrigin.y + dSize.y, area.dOrigin.y + area.dSize.y);
+
+	for(int z = minZ; z < maxZ; z++)
+	{
+		for(int y = minY; y < maxY; y++)
+		{
+			for(int w = 0; w < dRowWords; w++)
+			{
+				if(word(w, y, z) & area.getWord(dOrigin.x + w * WORD_BITS, y, z))
+					return true;
+			}
+		}
+	}
+	return false;
 }
 
 int Area::distance(const int3 & tile) const
@@ -301,81 +555,138 @@ int3 Area::nearest(const Area & area) const
 	return nearTile;
 }
 
+std::pair<int3, int3> Area::getBoundingBox() const
+{
+	return std::make_pair(dOrigin, dOrigin + dSize - int3(1, 1, 1));
+}
+
 Area Area::getSubarea(const std::function<bool(const int3 &)> & filter) const
 {
 	Area subset;
-	subset.dTiles.reserve(getTilesVector().size());
-	vstd::copy_if(getTilesVector(), vstd::set_inserter(subset.dTiles), filter);
+	if(dBits.empty())
+		return subset;
+
+	subset.reserve(dOrigin, dOrigin + dSize - int3(1, 1, 1), false);
+	forEachTile([&subset, &filter](const int3 & tile)
+	{
+		if(filter(tile))
+			subset.add(tile);
+	});
 	return subset;
 }
 
 void Area::clear()
 {
-	dTiles.clear();
-	dTilesVectorCache.clear();
-	dTotalShiftCache = int3();
 	invalidate();
+	dOrigin = int3();
+	dSize = int3();
+	dRowWords = 0;
+	dBits.clear();
 }
 
 void Area::assign(const Tileset tiles)
 {
 	clear();
-	dTiles = tiles;
+	if(tiles.empty())
+		return;
+
+	int3 min = *tiles.begin();
+	int3 max = min;
+	for(const auto & t : tiles)
+	{
+		min = int3(std::min(min.x, t.x), std::min(min.y, t.y), std::min(min.z, t.z));
+		max = int3(std::max(max.x, t.x), std::max(max.y, t.y), std::max(max.z, t.z));
+	}
+
+	reserve(min, max, false);
+	for(const auto & t : tiles)
+	{
+		const int relX = t.x - dOrigin.x;
+		word(relX / WORD_BITS, t.y, t.z) |= uint64_t(1) << (relX % WORD_BITS);
+	}
 }
 
 void Area::add(const int3 & tile)
 {
 	invalidate();
-	dTiles.insert(tile);
+	reserve(tile, tile, true);
+
+	const int relX = tile.x - dOrigin.x;
+	word(relX / WORD_BITS, tile.y, tile.z) |= uint64_t(1) << (relX % WORD_BITS);
 }
 
 void Area::erase(const int3 & tile)
 {
+	if(!testBit(tile))
+		return;
+
 	invalidate();
-	dTiles.erase(tile);
+	const int relX = tile.x - dOrigin.x;
+	word(relX / WORD_BITS, tile.y, tile.z) &= ~(uint64_t(1) << (relX % WORD_BITS));
 }
+
 void Area::unite(const Area & area)
 {
+	if(area.dBits.empty())
+		return;
+
 	invalidate();
-	const auto & vec = area.getTilesVector();
-	dTiles.reserve(dTiles.size() + vec.size());
-	dTiles.insert(vec.begin(), vec.end());
+	reserve(area.dOrigin, area.dOrigin + area.dSize - int3(1, 1, 1), false);
+
+	const int firstWord = (area.dOrigin.x - dOrigin.x) / WORD_BITS;
+	const int lastWord = (area.dOrigin.x + area.dSize.x - 1 - dOrigin.x) / WORD_BITS;
+
+	for(int z = area.dOrigin.z; z < area.dOrigin.z + area.dSize.z; z++)
+	{
+		for(int y = area.dOrigin.y; y < area.dOrigin.y + area.dSize.y; y++)
+		{
+			for(int w = firstWord; w <= lastWord; w++)
+				word(w, y, z) |= area.getWord(dOrigin.x + w * WORD_BITS, y, z);
+		}
+	}
 }
 
 void Area::intersect(const Area & area)
 {
 	invalidate();
-	Tileset result;
-	result.reserve(std::max(dTiles.size(), area.getTilesVector().size()));
-	for(const auto & t : area.getTilesVector())
+	for(int z = dOrigin.z; z < dOrigin.z + dSize.z; z++)
 	{
-		if(dTiles.count(t))
-			result.insert(t);
+		for(int y = dOrigin.y; y < dOrigin.y + dSize.y; y++)
+		{
+			for(int w = 0; w < dRowWords; w++)
+				word(w, y, z) &= area.getWord(dOrigin.x + w * WORD_BITS, y, z);
+		}
 	}
-	dTiles = result;
 }
 
 void Area::subtract(const Area & area)
 {
+	if(area.dBits.empty() || dBits.empty())
+		return;
+
 	invalidate();
-	for(const auto & t : area.getTilesVector())
+	const int minZ = std::max(dOrigin.z, area.dOrigin.z);
+	const int maxZ = std::min(dOrigin.z + dSize.z, area.dOrigin.z + area.dSize.z);
+	const int minY = std::max(dOrigin.y, area.dOrigin.y);
+	const int maxY = std::min(dOrigin.y + dSize.y, area.dOrigin.y + area.dSize.y);
+
+	for(int z = minZ; z < maxZ; z++)
 	{
-		dTiles.erase(t);
+		for(int y = minY; y < maxY; y++)
+		{
+			for(int w = 0; w < dRowWords; w++)
+				word(w, y, z) &= ~area.getWord(dOrigin.x + w * WORD_BITS, y, z);
+		}
 	}
 }
 
 void Area::translate(const int3 & shift)
 {
+	dTilesCache.clear();
 	dBorderCache.clear();
 	dBorderOutsideCache.clear();
 
-	if(dTilesVectorCache.empty())
-	{
-		getTilesVector();
-	}
-	
-	//avoid recomputation within std::set, use vector instead
-	dTotalShiftCache += shift;
+	dOrigin += shift;
 	
 	for(auto & t : dTilesVectorCache)
 	{
@@ -385,8 +696,11 @@ void Area::translate(const int3 & shift)
 
 void Area::erase_if(std::function<bool(const int3&)> predicate)
 {
-	invalidate();
-	vstd::erase_if(dTiles, predicate);
+	for(const auto & tile : std::vector<int3>(getTilesVector()))
+	{
+		if(predicate(tile))
+			erase(tile);
+	}
 }
 
 Area operator- (const Area & l, const int3 & r)
@@ -405,12 +719,8 @@ Area operator+ (const Area & l, const int3 & r)
 
 Area operator+ (const Area & l, const Area & r)
 {
-	Area result;
-	const auto & lTiles = l.getTilesVector();
-	const auto & rTiles = r.getTilesVector();
-	result.dTiles.reserve(lTiles.size() + rTiles.size());
-	result.dTiles.insert(lTiles.begin(), lTiles.end());
-	result.dTiles.insert(rTiles.begin(), rTiles.end());
+	Area result(l);
+	result.unite(r);
 	return result;
 }
 
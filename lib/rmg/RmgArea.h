@@ -56,6 +56,7 @@ namespace rmg
 		int distanceSqr(const Area & area) const;
 		int3 nearest(const int3 & tile) const;
 		int3 nearest(const Area & area) const;
+		std::pair<int3, int3> getBoundingBox() const; //corners of box containing all tiles, box may be larger than area
 		
 		void clear();
 		void assign(const Tileset tiles); //do not use reference to allow assignment of cached data
@@ -78,15 +79,34 @@ namespace rmg
 	private:
 		
 		void invalidate();
-		void computeBorderCache();
-		void computeBorderOutsideCache();
+		void reserve(const int3 & min, const int3 & max, bool withSlack);
+		bool testBit(const int3 & tile) const;
+		/// 64 tiles of row y, z starting at absolute coordinate x, tiles outside of bounding box are empty
+		uint64_t getWord(int x, int y, int z) const;
+		uint64_t & word(int wordIndex, int y, int z);
+		const uint64_t & word(int wordIndex, int y, int z) const;
+		template<typename Handler>
+		void forEachTile(const Handler & handler) const;
 		
-		mutable Tileset dTiles;
+		/// Tiles are stored as bitmap covering bounding box of area, one row of 64-bit words for each y and z
+		int3 dOrigin; //absolute position of first bit
+		int3 dSize; //size of bounding box, bounding box may contain empty tiles
+		int dRowWords = 0;
+		std::vector<uint64_t> dBits;
+		
+		mutable Tileset dTilesCache;
 		mutable std::vector<int3> dTilesVectorCache;
 		mutable Tileset dBorderCache;
 		mutable Tileset dBorderOutsideCache;
-		mutable int3 dTotalShiftCache;
 	};
+
+	DLL_LINKAGE Area operator+ (const Area & l, const int3 & r);
+	DLL_LINKAGE Area operator- (const Area & l, const int3 & r);
+	DLL_LINKAGE Area operator+ (const Area & l, const Area & r);
+	DLL_LINKAGE Area operator* (const Area & l, const Area & r);
+	DLL_LINKAGE Area operator- (const Area & l, const Area & r);
+	DLL_LINKAGE bool operator== (const Area & l, const Area & r);
+	DLL_LINKAGE std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections);
 }
 
 VCMI_LIB_NAMESPACE_END
@@ -0,0 +1,191 @@
+/*
+ * RmgDistanceField.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "RmgDistanceField.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace rmg
+{
+
+DistanceField::DistanceField(const int3 & origin, int width, int height)
+	: origin(origin)
+	, width(width)
+	, height(height)
+	, distances(static_cast<size_t>(width) * height, INFINITE_DISTANCE)
+	, rowMaxima(height, INFINITE_DISTANCE)
+{
+}
+
+size_t DistanceField::index(int x, int y) const
+{
+	return static_cast<size_t>(y - origin.y) * width + (x - origin.x);
+}
+
+bool DistanceField::empty() const
+{
+	return distances.empty();
+}
+
+bool DistanceField::contains(const int3 & tile) const
+{
+	return tile.z == origin.z && tile.x >= origin.x && tile.y >= origin.y && tile.x < origin.x + width && tile.y < origin.y + height;
+}
+
+ui32 DistanceField::get(const int3 & tile) const
+{
+	if(!contains(tile))
+		return INFINITE_DISTANCE;
+
+	return distances[index(tile.x, tile.y)];
+}
+
+void DistanceField::addSources(const std::vector<int3> & sources, const std::function<void(const int3 &, ui32)> & onChanged)
+{
+	if(distances.empty())
+		return;
+
+	for(const auto & source : sources)
+	{
+		// tile can only get closer to source if it is within farthest distance of its row
+		// so every row is scanned only across span of that radius around source, each scanned tile is compared directly
+		for(int row = 0; row < height; row++)
+		{
+			const int y = origin.y + row;
+			const int64_t dy = y - source.y;
+			const int64_t rowRadiusSq = static_cast<int64_t>(rowMaxima[row]) - dy * dy;
+			if(rowRadiusSq <= 0)
+				continue;
+
+			const auto radius = static_cast<int64_t>(std::sqrt(static_cast<double>(rowRadiusSq))) + 1;
+			const int minX = static_cast<int>(std::max<int64_t>(origin.x, source.x - radius));
+			const int maxX = static_cast<int>(std::min<int64_t>(origin.x + width - 1, source.x + radius));
+
+			bool rowChanged = false;
+			for(int x = minX; x <= maxX; x++)
+			{
+				const int3 tile(x, y, origin.z);
+				auto & current = distances[index(x, y)];
+				const auto distance = static_cast<ui32>(tile.dist2dSQ(source));
+				if(distance >= current)
+					continue;
+
+				current = distance;
+				rowChanged = true;
+				if(onChanged)
+					onChanged(tile, distance);
+			}
+
+			if(rowChanged)
+			{
+				const auto rowBegin = distances.begin() + index(origin.x, y);
+				rowMaxima[row] = *std::max_element(rowBegin, rowBegin + width);
+			}
+		}
+	}
+}
+
+bool TilesByDistance::FarthestFirst::operator()(const TEntry & lhs, const TEntry & rhs) const
+{
+	if(lhs.first != rhs.first)
+		return lhs.first > rhs.first;
+
+	return lhs.second < rhs.second;
+}
+
+void TilesByDistance::clear()
+{
+	order.clear();
+	distances.clear();
+	tiles.clear();
+}
+
+bool TilesByDistance::empty() const
+{
+	return order.empty();
+}
+
+size_t TilesByDistance::size() const
+{
+	return order.size();
+}
+
+bool TilesByDistance::contains(const int3 & tile) const
+{
+	return tiles.contains(tile);
+}
+
+float TilesByDistance::get(const int3 & tile) const
+{
+	return distances.at(tile);
+}
+
+const Area & TilesByDistance::getArea() const
+{
+	return tiles;
+}
+
+void TilesByDistance::set(const int3 & tile, float distance)
+{
+	auto it = distances.find(tile);
+	if(it == distances.end())
+	{
+		distances.emplace(tile, distance);
+		tiles.add(tile);
+	}
+	else
+	{
+		if(it->second == distance)
+			return;
+
+		order.erase(std::make_pair(it->second, tile));
+		it->second = distance;
+	}
+	order.emplace(distance, tile);
+}
+
+void TilesByDistance::erase(const int3 & tile)
+{
+	auto it = distances.find(tile);
+	if(it == distances.end())
+		return;
+
+	order.erase(std::make_pair(it->second, tile));
+	distances.erase(it);
+	tiles.erase(tile);
+}
+
+void TilesByDistance::assignArea(const Area & area, const std::function<float(const int3 &)> & distanceOf)
+{
+	// set differences are computed on bitmaps, only differing tiles are touched
+	const auto removed = tiles - area;
+	const auto added = area - tiles;
+
+	for(const auto & tile : removed.getTilesVector())
+		erase(tile);
+
+	for(const auto & tile : added.getTilesVector())
+		set(tile, distanceOf(tile));
+}
+
+TilesByDistance::TOrder::const_iterator TilesByDistance::begin() const
+{
+	return order.begin();
+}
+
+TilesByDistance::TOrder::const_iterator TilesByDistance::end() const
+{
+	return order.end();
+}
+
+}
+
+VCMI_LIB_NAMESPACE_END
@@ -0,0 +1,84 @@
+/*
+ * RmgDistanceField.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "RmgArea.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace rmg
+{
+/// Exact squared distance (as int3::dist2dSQ) from every tile of rectangle on single map level to nearest source tile
+/// Values are kept in flat grid and lowered incrementally: new source only scans tiles of each row that are within farthest distance of that row
+class DLL_LINKAGE DistanceField
+{
+public:
+	static constexpr ui32 INFINITE_DISTANCE = std::numeric_limits<ui32>::max();
+
+	DistanceField() = default;
+	DistanceField(const int3 & origin, int width, int height);
+
+	bool empty() const;
+	bool contains(const int3 & tile) const;
+	ui32 get(const int3 & tile) const;
+
+	/// Sources may lie outside of the field, onChanged is called for every field tile with decreased distance
+	void addSources(const std::vector<int3> & sources, const std::function<void(const int3 &, ui32)> & onChanged = nullptr);
+
+private:
+	size_t index(int x, int y) const;
+
+	int3 origin;
+	int width = 0;
+	int height = 0;
+	std::vector<ui32> distances;
+	std::vector<ui32> rowMaxima; //largest distance in every row, bounds span of row that new source can lower
+};
+
+/// Tiles ordered from farthest to nearest object, ties are ordered by position
+/// Distance of single tile can be changed in place, tiles are added or removed only where set differs from given area
+class DLL_LINKAGE TilesByDistance
+{
+public:
+	using TEntry = std::pair<float, int3>;
+
+	struct FarthestFirst
+	{
+		bool operator()(const TEntry & lhs, const TEntry & rhs) const;
+	};
+
+	using TOrder = std::set<TEntry, FarthestFirst>;
+
+	void clear();
+	bool empty() const;
+	size_t size() const;
+	bool contains(const int3 & tile) const;
+	float get(const int3 & tile) const;
+	const Area & getArea() const;
+
+	/// Adds tile or moves it to new distance
+	void set(const int3 & tile, float distance);
+	void erase(const int3 & tile);
+
+	/// Removes tiles not in area and adds missing ones with distance given by callback, other tiles are not visited
+	void assignArea(const Area & area, const std::function<float(const int3 &)> & distanceOf);
+
+	TOrder::const_iterator begin() const;
+	TOrder::const_iterator end() const;
+
+private:
+	TOrder order;
+	std::unordered_map<int3, float> distances;
+	Area tiles;
+};
+}
+
+VCMI_LIB_NAMESPACE_END
@@ -10,32 +10,11 @@
 
 #include "StdInc.h"
 #include "RmgPath.h"
-#include <boost/heap/priority_queue.hpp> //A*
 
 VCMI_LIB_NAMESPACE_BEGIN
 
 using namespace rmg;
 
-const std::function<float(const int3 &, const int3 &)> Path::DEFAULT_MOVEMENT_FUNCTION =
-[](const int3 & src, const int3 & dst)
-{	
-	return 1.f;
-};
-
-//A* priority queue
-using TDistance = std::pair<int3, float>;
-struct NodeComparer
-{
-	bool operator()(const TDistance & lhs, const TDistance & rhs) const
-	{
-		return (rhs.second < lhs.second);
-	}
-};
-boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>> createPriorityQueue()
-{
-	return boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>>();
-}
-
 Path::Path(const Area & area): dArea(&area)
 {
 }
@@ -62,106 +41,79 @@ Path Path::invalid()
 	return Path({});
 }
 
-Path Path::search(const Tileset & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
+Path::SearchScratch & Path::getScratch()
 {
-	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
-	if(!dArea)
-		return Path::invalid();
-	
-	if(dst.empty()) // Skip construction of same area
-		return Path(*dArea);
-
-	auto resultArea = *dArea + dst;
-	Path result(resultArea);
-
-	int3 src = rmg::Area(dst).nearest(dPath);
-	result.connect(src);
-	
-	Tileset closed;    // The set of nodes already evaluated.
-	auto open = createPriorityQueue(); // The set of tentative nodes to be evaluated, initially containing the start node
-	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
-	std::map<int3, float> distances;
-	
-	cameFrom[src] = int3(-1, -1, -1); //first node points to finish condition
-	distances[src] = 0;
-	open.push(std::make_pair(src, 0.f));
-	// Cost from start along best known path.
-	
-	while(!open.empty())
-	{
-		auto node = open.top();
-		open.pop();
-		int3 currentNode = node.first;
-		
-		closed.insert(currentNode);
-		
-		if(dPath.contains(currentNode)) //we reached connection, stop
-		{
-			// Trace the path using the saved parent information and return path
-			int3 backTracking = currentNode;
-			while (cameFrom[backTracking].valid())
-			{
-				result.dPath.add(backTracking);
-				backTracking = cameFrom[backTracking];
-			}
-			return result;
-		}
-		else
-		{
-			auto computeTileScore = [&open, &closed, &cameFrom, &currentNode, &distances, &moveCostFunction, &result](const int3& pos) -> void
-			{
-				if(closed.count(pos))
-					return;
-				
-				if(!result.dArea->contains(pos))
-					return;
-				
-				float movementCost = moveCostFunction(currentNode, pos) + currentNode.dist2d(pos);
-				
-				float distance = distances[currentNode] + movementCost; //we prefer to use already free paths
-				int bestDistanceSoFar = std::numeric_limits<int>::max();
-				auto it = distances.find(pos);
-				if(it != distances.end())
-					bestDistanceSoFar = static_cast<int>(it->second);
-				
-				if(distance < bestDistanceSoFar)
-				{
-					cameFrom[pos] = currentNode;
-					open.push(std::make_pair(pos, distance));
-					distances[pos] = distance;
-				}
-			};
-			
-			auto dirs = int3::getDirs();
-			std::vector<int3> neighbors(dirs.begin(), dirs.end());
-			if(straight)
-				neighbors.assign(rmg::dirs4.begin(), rmg::dirs4.end());
-			for(auto & i : neighbors)
-			{
-				computeTileScore(currentNode + i);
-			}
-		}
-		
-	}
-	
-	result.dPath.clear();
-	return result;
+	thread_local SearchScratch scratch;
+	return scratch;
 }
 
-Path Path::search(const int3 & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
+void Path::SearchScratch::reset(const int3 & min, const int3 & max)
 {
-	return search(Tileset{dst}, straight, std::move(moveCostFunction));
+	origin = min;
+	size = max - min + int3(1, 1, 1);
+	open.clear();
+
+	const size_t tilesCount = static_cast<size_t>(std::max(0, size.x)) * std::max(0, size.y) * std::max(0, size.z);
+	if(reachedStamps.size() < tilesCount)
+	{
+		reachedStamps.resize(tilesCount, 0);
+		closedStamps.resize(tilesCount, 0);
+		distances.resize(tilesCount);
+		cameFrom.resize(tilesCount);
+		destinationStamps.resize(tilesCount, 0);
+	}
+
+	if(++generation == 0)
+	{
+		// stamps left from previous generations would become valid again
+		std::fill(reachedStamps.begin(), reachedStamps.end(), 0);
+		std::fill(closedStamps.begin(), closedStamps.end(), 0);
+		std::fill(destinationStamps.begin(), destinationStamps.end(), 0);
+		generation = 1;
+	}
 }
 
-Path Path::search(const Area & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
+void Path::SearchScratch::setDestinations(const Area & area)
 {
-	return search(dst.getTiles(), straight, std::move(moveCostFunction));
+	auto tileOrder = [](const int3 & lhs, const int3 & rhs)
+	{
+		return std::tie(lhs.z, lhs.y, lhs.x) < std::tie(rhs.z, rhs.y, rhs.x);
+	};
+
+	if(!std::is_sorted(destinations.begin(), destinations.end(), tileOrder))
+		std::sort(destinations.begin(), destinations.end(), tileOrder);
+
+	auto bounds = area.empty() ? std::make_pair(destinations.front(), destinations.front()) : area.getBoundingBox();
+	for(const auto & tile : destinations)
+	{
+		vstd::amin(bounds.first.x, tile.x);
+		vstd::amin(bounds.first.y, tile.y);
+		vstd::amin(bounds.first.z, tile.z);
+		vstd::amax(bounds.second.x, tile.x);
+		vstd::amax(bounds.second.y, tile.y);
+		vstd::amax(bounds.second.z, tile.z);
+	}
+
+	reset(bounds.first, bounds.second);
+
+	for(const auto & tile : destinations)
+		destinationStamps[index(tile)] = generation;
 }
 
-Path Path::search(const Path & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
+int3 Path::SearchScratch::nearestDestination(const Area & area) const
 {
-	assert(dst.dArea == dArea);
-	return search(dst.dPath, straight, std::move(moveCostFunction));
+	ui32 dist = std::numeric_limits<ui32>::max();
+	int3 nearTile = destinations.front();
+	int3 otherNearTile = area.nearest(nearTile);
+
+	while(dist != otherNearTile.dist2dSQ(nearTile))
+	{
+		dist = otherNearTile.dist2dSQ(nearTile);
+		nearTile = findClosestTile(destinations, otherNearTile);
+		otherNearTile = area.nearest(nearTile);
+	}
+
+	return nearTile;
 }
 
 void Path::connect(const int3 & path)
@@ -18,10 +18,17 @@ VCMI_LIB_NAMESPACE_BEGIN
 
 namespace rmg
 {
-class Path
+class DLL_LINKAGE Path
 {
 public:
-	const static std::function<float(const int3 &, const int3 &)> DEFAULT_MOVEMENT_FUNCTION;
+	/// Only length of path is considered
+	struct DefaultMovementCost
+	{
+		float operator()(const int3 & src, const int3 & dst) const
+		{
+			return 1.f;
+		}
+	};
 	
 	Path(const Area & area);
 	Path(const Area & area, const int3 & src);
@@ -29,10 +36,28 @@ public:
 	Path & operator= (const Path & path);
 	bool valid() const;
 	
-	Path search(const Tileset & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	Path search(const int3 & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	Path search(const Area & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	Path search(const Path & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
+	/// Movement cost functor is called as float(const int3 & src, const int3 & dst) and should not run another search
+	template<typename MoveCost = DefaultMovementCost>
+	Path search(const Tileset & dst, bool straight, const MoveCost & moveCostFunction = {}) const
+	{
+		return searchTiles(dst, straight, moveCostFunction);
+	}
+	template<typename MoveCost = DefaultMovementCost>
+	Path search(const int3 & dst, bool straight, const MoveCost & moveCostFunction = {}) const
+	{
+		return searchTiles(std::array<int3, 1>{dst}, straight, moveCostFunction);
+	}
+	template<typename MoveCost = DefaultMovementCost>
+	Path search(const Area & dst, bool straight, const MoveCost & moveCostFunction = {}) const
+	{
+		return searchTiles(dst.getTilesVector(), straight, moveCostFunction);
+	}
+	template<typename MoveCost = DefaultMovementCost>
+	Path search(const Path & dst, bool straight, const MoveCost & moveCostFunction = {}) const
+	{
+		assert(dst.dArea == dArea);
+		return searchTiles(dst.dPath.getTilesVector(), straight, moveCostFunction);
+	}
 	
 	void connect(const Path & path);
 	void connect(const int3 & path); //TODO: force connection?
@@ -44,10 +69,142 @@ public:
 	static Path invalid();
 	
 private:
+	/// A* buffers indexed by tile of searched box, reused by all searches of the same thread
+	/// Tile data is valid only if its stamp matches generation of current search, so no clearing is needed between searches
+	struct SearchScratch
+	{
+		int3 origin;
+		int3 size;
+		ui32 generation = 0;
+		std::vector<ui32> reachedStamps;
+		std::vector<ui32> closedStamps;
+		std::vector<float> distances;
+		std::vector<int> cameFrom; //index of previous tile, -1 for start of path
+		std::vector<std::pair<float, int>> open; //binary heap, tile with lowest distance on top
+		std::vector<ui32> destinationStamps;
+		std::vector<int3> destinations; //ordered as tiles of rmg::Area
+
+		void reset(const int3 & min, const int3 & max);
+		/// Sorts destinations and marks them in box covering them and given area
+		void setDestinations(const Area & area);
+		/// Same tile as rmg::Area::nearest(const Area &) called on area of destinations
+		int3 nearestDestination(const Area & area) const;
+
+		bool isDestination(const int3 & tile) const
+		{
+			const int3 offset = tile - origin;
+			if(offset.x < 0 || offset.y < 0 || offset.z < 0 || offset.x >= size.x || offset.y >= size.y || offset.z >= size.z)
+				return false;
+			return destinationStamps[index(tile)] == generation;
+		}
+
+		int index(const int3 & tile) const
+		{
+			return ((tile.z - origin.z) * size.y + (tile.y - origin.y)) * size.x + (tile.x - origin.x);
+		}
+
+		int3 tile(int index) const
+		{
+			return origin + int3(index % size.x, index / size.x % size.y, index / size.x / size.y);
+		}
+
+		static bool compare(const std::pair<float, int> & lhs, const std::pair<float, int> & rhs)
+		{
+			return rhs.first < lhs.first;
+		}
+	};
+	static SearchScratch & getScratch();
+
+	template<typename Tiles, typename MoveCost>
+	Path searchTiles(const Tiles & dst, bool straight, const MoveCost & moveCostFunction) const;
 	
 	const Area * dArea = nullptr;
 	Area dPath;
 };
+
+template<typename Tiles, typename MoveCost>
+Path Path::searchTiles(const Tiles & dst, bool straight, const MoveCost & moveCostFunction) const
+{
+	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
+	if(!dArea)
+		return Path::invalid();
+	
+	if(dst.empty()) // Skip construction of same area
+		return Path(*dArea);
+
+	Path result(*dArea);
+
+	// search area is union of path area and destination, it is never built, both are tested separately
+	auto & scratch = getScratch();
+	scratch.destinations.assign(dst.begin(), dst.end());
+	scratch.setDestinations(*dArea);
+
+	int3 src = scratch.nearestDestination(dPath);
+	result.connect(src);
+
+	// Cost from start along best known path.
+	const int srcIndex = scratch.index(src);
+	scratch.reachedStamps[srcIndex] = scratch.generation;
+	scratch.distances[srcIndex] = 0;
+	scratch.cameFrom[srcIndex] = -1; //first node points to finish condition
+	scratch.open.emplace_back(0.f, srcIndex);
+
+	const auto allDirs = int3::getDirs();
+	const int3 * dirs = straight ? rmg::dirs4.data() : allDirs.data();
+	const size_t dirsCount = straight ? rmg::dirs4.size() : allDirs.size();
+	
+	while(!scratch.open.empty())
+	{
+		std::pop_heap(scratch.open.begin(), scratch.open.end(), SearchScratch::compare);
+		const int current = scratch.open.back().second;
+		scratch.open.pop_back();
+
+		if(scratch.closedStamps[current] == scratch.generation)
+			continue; //outdated entry, tile was already reached with lower distance
+
+		scratch.closedStamps[current] = scratch.generation;
+		const int3 currentNode = scratch.tile(current);
+		
+		if(dPath.contains(currentNode)) //we reached connection, stop
+		{
+			// Trace the path using the saved parent information and return path
+			for(int backTracking = current; scratch.cameFrom[backTracking] >= 0; backTracking = scratch.cameFrom[backTracking])
+				result.dPath.add(scratch.tile(backTracking));
+
+			return result;
+		}
+
+		for(size_t i = 0; i < dirsCount; i++)
+		{
+			const int3 pos = currentNode + dirs[i];
+			if(!dArea->contains(pos) && !scratch.isDestination(pos))
+				continue;
+
+			const int posIndex = scratch.index(pos);
+			if(scratch.closedStamps[posIndex] == scratch.generation)
+				continue;
+			
+			float movementCost = moveCostFunction(currentNode, pos) + currentNode.dist2d(pos);
+			
+			float distance = scratch.distances[current] + movementCost; //we prefer to use already free paths
+			int bestDistanceSoFar = std::numeric_limits<int>::max();
+			if(scratch.reachedStamps[posIndex] == scratch.generation)
+				bestDistanceSoFar = static_cast<int>(scratch.distances[posIndex]);
+			
+			if(distance < bestDistanceSoFar)
+			{
+				scratch.reachedStamps[posIndex] = scratch.generation;
+				scratch.distances[posIndex] = distance;
+				scratch.cameFrom[posIndex] = current;
+				scratch.open.emplace_back(distance, posIndex);
+				std::push_heap(scratch.open.begin(), scratch.open.end(), SearchScratch::compare);
+			}
+		}
+	}
+	
+	result.dPath.clear();
+	return result;
+}
 }
 
 VCMI_LIB_NAMESPACE_END
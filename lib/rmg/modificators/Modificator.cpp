@@ -13,7 +13,6 @@
 #include "../Functions.h"
 #include "../CMapGenerator.h"
 #include "../RmgMap.h"
-#include "../../CStopWatch.h"
 #include "../../mapping/CMap.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -33,32 +32,9 @@ const std::string & Modificator::getName() const
 	return name;
 }
 
-bool Modificator::isReady()
+std::chrono::microseconds Modificator::getProcessTime() const
 {
-	Lock lock(mx, boost::try_to_lock);
-	if (!lock.owns_lock())
-	{
-		return false;
-	}
-	else
-	{
-		//Check prerequisites
-		for (auto it = preceeders.begin(); it != preceeders.end();)
-		{
-			if ((*it)->isFinished()) //OK
-			{
-				//This preceeder won't be checked in the future
-				it = preceeders.erase(it);
-			}
-			else
-			{
-				return false;
-			}
-		}
-
-		//If a job is finished, it should be already erased from a queue
-		return !finished;
-	}
+	return processTime;
 }
 
 bool Modificator::isFinished()
@@ -81,7 +57,7 @@ void Modificator::run()
 	if(!finished)
 	{
 		logGlobal->trace("Modificator zone %d - %s - started", zone.getId(), getName());
-		CStopWatch processTime;
+		auto start = std::chrono::steady_clock::now();
 		try
 		{
 			process();
@@ -93,8 +69,9 @@ void Modificator::run()
 #ifdef RMG_DUMP
 		dump();
 #endif
+		processTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
 		finished = true;
-		logGlobal->trace("Modificator zone %d - %s - done (%d ms)", zone.getId(), getName(), processTime.getDiff());
+		logGlobal->trace("Modificator zone %d - %s - done (%d ms)", zone.getId(), getName(), processTime.count() / 1000);
 	}
 }
 
@@ -117,6 +94,11 @@ void Modificator::postfunction(Modificator * modificator)
 	}
 }
 
+const std::list<Modificator*> & Modificator::getDependencies() const
+{
+	return preceeders;
+}
+
 void Modificator::dump()
 {
 	// TODO: Refactor to lock zone area only once
@@ -46,13 +46,14 @@ public:
 
 	void setName(const std::string & n);
 	const std::string & getName() const;
+	std::chrono::microseconds getProcessTime() const; //wall time spent in process()
 
-	bool isReady();
 	bool isFinished();
 	
 	void run();
 	void dependency(Modificator * modificator);
 	void postfunction(Modificator * modificator);
+	const std::list<Modificator*> & getDependencies() const;
 
 protected:
 	RmgMap & map;
@@ -70,6 +71,7 @@ private:
 	virtual void process() = 0;
 
 	std::string name;
+	std::chrono::microseconds processTime{0};
 
 	std::list<Modificator*> preceeders; //must be ordered container
 
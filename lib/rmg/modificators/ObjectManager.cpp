@@ -80,7 +80,7 @@ void ObjectManager::createDistancesPriorityQueue()
 	tilesByDistance.clear();
 	for(const auto & tile : tiles)
 	{
-		tilesByDistance.push(std::make_pair(tile, map.getNearestObjectDistance(tile)));
+		tilesByDistance.set(tile, map.getNearestObjectDistance(tile));
 	}
 }
 
@@ -104,21 +104,15 @@ void ObjectManager::addNearbyObject(const RequiredObjectInfo & info)
 
 void ObjectManager::updateDistances(const rmg::Object & obj)
 {
-	updateDistances([obj](const int3& tile) -> ui32
-	{
-		return obj.getArea().distanceSqr(tile); //optimization, only relative distance is interesting
-	});
+	updateDistances(obj.getArea().getTilesVector());
 }
 
 void ObjectManager::updateDistances(const int3 & pos)
 {
-	updateDistances([pos](const int3& tile) -> ui32
-	{
-		return pos.dist2dSQ(tile); //optimization, only relative distance is interesting
-	});
+	updateDistances(std::vector<int3>{pos});
 }
 
-void ObjectManager::updateDistances(std::function<ui32(const int3 & tile)> distanceFunction)
+void ObjectManager::updateDistances(const std::vector<int3> & sources)
 {
 	// Workaround to avoid deadlock when accessed from other zone
 	RecursiveLock lock(zone.areaMutex, boost::try_to_lock);
@@ -128,15 +122,64 @@ void ObjectManager::updateDistances(std::function<ui32(const int3 & tile)> dista
 		return;
 	}
 
-	const auto tiles = zone.areaPossible()->getTilesVector();
+	if(sources.empty())
+		return;
+
+	const auto & possibleArea = *zone.areaPossible();
+
+	if(objectDistances.empty() && !zone.area()->empty())
+	{
+		// field covers bounding box of zone level, tiles outside of it are evaluated directly
+		const auto & zoneTiles = zone.area()->getTilesVector();
+		int3 min = zoneTiles.front();
+		int3 max = zoneTiles.front();
+		for(const auto & tile : zoneTiles)
+		{
+			if(tile.z != min.z)
+				continue;
+			vstd::amin(min.x, tile.x);
+			vstd::amin(min.y, tile.y);
+			vstd::amax(max.x, tile.x);
+			vstd::amax(max.y, tile.y);
+		}
+		objectDistances = rmg::DistanceField(min, max.x - min.x + 1, max.y - min.y + 1);
+
+		for(const auto & tile : zoneTiles)
+		{
+			if(!objectDistances.contains(tile))
+				tilesOutsideDistances.push_back(tile);
+		}
+	}
+
 	//RecursiveLock lock(externalAccessMutex);
-	tilesByDistance.clear();
+	// drop tiles which are no longer possible, only tiles which changed since last update are visited
+	// distance of not possible tiles is not kept in map, so tile which becomes possible again takes it from field
+	tilesByDistance.assignArea(possibleArea, [this](const int3 & tile)
+	{
+		const float distance = std::min(static_cast<float>(objectDistances.get(tile)), map.getNearestObjectDistance(tile));
+		map.setNearestObjectDistance(tile, distance);
+		return map.getNearestObjectDistance(tile);
+	});
+
+	auto lowerDistance = [this, &possibleArea](const int3 & tile, ui32 d)
+	{
+		if(!possibleArea.contains(tile))
+			return;
+
+		const float distance = std::min(static_cast<float>(d), map.getNearestObjectDistance(tile));
+		map.setNearestObjectDistance(tile, distance);
+		tilesByDistance.set(tile, map.getNearestObjectDistance(tile));
+	};
+
+	// lowerDistance is called only for tiles which got closer to new sources
+	objectDistances.addSources(sources, lowerDistance);
 
-	for (const auto & tile : tiles) //don't need to mark distance for not possible tiles
+	for(const auto & tile : tilesOutsideDistances)
 	{
-		ui32 d = distanceFunction(tile);
-		map.setNearestObjectDistance(tile, std::min(static_cast<float>(d), map.getNearestObjectDistance(tile)));
-		tilesByDistance.push(std::make_pair(tile, map.getNearestObjectDistance(tile)));
+		ui32 d = std::numeric_limits<ui32>::max();
+		for(const auto & source : sources)
+			vstd::amin(d, static_cast<ui32>(source.dist2dSQ(tile)));
+		lowerDistance(tile, d);
 	}
 }
 
@@ -184,13 +227,11 @@ int3 ObjectManager::findPlaceForObject(const rmg::Area & searchArea, rmg::Object
 	{
 		// Do not add or remove tiles while we iterate on them
 		//RecursiveLock lock(externalAccessMutex);
-		auto open = tilesByDistance;
+		const std::vector<rmg::TilesByDistance::TEntry> open(tilesByDistance.begin(), tilesByDistance.end());
 
-		while(!open.empty())
+		for(const auto & node : open)
 		{
-			auto node = open.top();
-			open.pop();
-			int3 tile = node.first;
+			int3 tile = node.second;
 			
 			if(!searchArea.contains(tile))
 				continue;
@@ -12,7 +12,7 @@
 
 #include "../Zone.h"
 #include "../RmgObject.h"
-#include <boost/heap/priority_queue.hpp> //A*
+#include "../RmgDistanceField.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -20,15 +20,6 @@ class CGObjectInstance;
 class ObjectTemplate;
 class CGCreature;
 
-using TDistance = std::pair<int3, float>;
-struct DistanceMaximizeFunctor
-{
-	bool operator()(const TDistance & lhs, const TDistance & rhs) const
-	{
-		return (rhs.second > lhs.second);
-	}
-};
-
 struct RequiredObjectInfo
 {
 	RequiredObjectInfo();
@@ -77,7 +68,7 @@ public:
 
 	void updateDistances(const rmg::Object & obj);
 	void updateDistances(const int3& pos);
-	void updateDistances(std::function<ui32(const int3 & tile)> distanceFunction);
+	void updateDistances(const std::vector<int3> & sources);
 	void createDistancesPriorityQueue();
 
 	const rmg::Area & getVisitableArea() const;
@@ -93,7 +84,9 @@ protected:
 	std::vector<CGObjectInstance*> objects;
 	rmg::Area objectsVisitableArea;
 	
-	boost::heap::priority_queue<TDistance, boost::heap::compare<DistanceMaximizeFunctor>> tilesByDistance;
+	rmg::TilesByDistance tilesByDistance; //possible tiles of zone, farthest from objects first
+	rmg::DistanceField objectDistances; //distances to all objects placed by updateDistances
+	std::vector<int3> tilesOutsideDistances; //zone tiles not covered by objectDistances, evaluated directly
 	
 };
 
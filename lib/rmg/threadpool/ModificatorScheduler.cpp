@@ -0,0 +1,129 @@
+/*
+ * ModificatorScheduler.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "ModificatorScheduler.h"
+
+#include "../modificators/Modificator.h"
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+ModificatorScheduler::ModificatorScheduler(const TModificators & modificators, JobCallback onJobFinished)
+	: dependents(modificators.size())
+	, dependencies(modificators.size(), 0)
+	, onJobFinished(std::move(onJobFinished))
+{
+	const std::vector<std::shared_ptr<Modificator>> scheduled(modificators.begin(), modificators.end());
+
+	std::map<const Modificator *, size_t> indices;
+	for(size_t i = 0; i < scheduled.size(); i++)
+	{
+		indices[scheduled[i].get()] = i;
+		jobs.emplace_back([modificator = scheduled[i]](){ modificator->run(); });
+	}
+
+	for(size_t i = 0; i < scheduled.size(); i++)
+	{
+		for(const auto * dependency : scheduled[i]->getDependencies())
+		{
+			auto it = indices.find(dependency);
+
+			// modificator that is not scheduled can't block anyone
+			if(it == indices.end() || scheduled[it->second]->isFinished())
+				continue;
+
+			addDependency(i, it->second);
+		}
+	}
+}
+
+ModificatorScheduler::ModificatorScheduler(std::vector<Job> jobs, const std::vector<std::vector<size_t>> & jobDependencies, JobCallback onJobFinished)
+	: jobs(std::move(jobs))
+	, dependents(this->jobs.size())
+	, dependencies(this->jobs.size(), 0)
+	, onJobFinished(std::move(onJobFinished))
+{
+	assert(jobDependencies.size() == this->jobs.size());
+
+	for(size_t i = 0; i < jobDependencies.size(); i++)
+		for(size_t dependency : jobDependencies[i])
+			addDependency(i, dependency);
+}
+
+void ModificatorScheduler::addDependency(size_t job, size_t dependency)
+{
+	assert(dependency < jobs.size());
+	dependents[dependency].push_back(job);
+	dependencies[job]++;
+}
+
+void ModificatorScheduler::runSequential()
+{
+	std::vector<size_t> remaining = dependencies;
+	std::priority_queue<size_t, std::vector<size_t>, std::greater<>> ready;
+
+	for(size_t i = 0; i < jobs.size(); i++)
+	{
+		if(remaining[i] == 0)
+			ready.push(i);
+	}
+
+	while(!ready.empty())
+	{
+		size_t current = ready.top();
+		ready.pop();
+
+		jobs[current]();
+		onJobFinished();
+
+		for(size_t dependent : dependents[current])
+		{
+			if(--remaining[dependent] == 0)
+				ready.push(dependent);
+		}
+	}
+}
+
+void ModificatorScheduler::runParallel(size_t maxThreads)
+{
+	std::vector<std::atomic<size_t>> remaining(jobs.size());
+	for(size_t i = 0; i < jobs.size(); i++)
+		remaining[i] = dependencies[i];
+
+	tbb::task_arena arena(static_cast<int>(std::max<size_t>(maxThreads, 1)));
+	tbb::task_group group;
+
+	std::function<void(size_t)> runJob = [&](size_t current)
+	{
+		jobs[current]();
+		onJobFinished();
+
+		for(size_t dependent : dependents[current])
+		{
+			if(--remaining[dependent] == 0)
+				group.run([&runJob, dependent](){ runJob(dependent); });
+		}
+	};
+
+	arena.execute([&]()
+	{
+		for(size_t i = 0; i < jobs.size(); i++)
+		{
+			if(remaining[i] == 0)
+				group.run([&runJob, i](){ runJob(i); });
+		}
+		group.wait();
+	});
+}
+
+VCMI_LIB_NAMESPACE_END
@@ -0,0 +1,46 @@
+/*
+ * ModificatorScheduler.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../Zone.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Runs modificators of all zones, each one as soon as all modificators it depends on are finished
+/// Dependency graph is built once, finished modificator directly releases its dependents
+class DLL_LINKAGE ModificatorScheduler
+{
+public:
+	using Job = std::function<void()>;
+	using JobCallback = std::function<void()>;
+
+	ModificatorScheduler(const TModificators & modificators, JobCallback onJobFinished);
+	/// Schedules plain jobs, dependencies of job are indices of jobs that must be finished before it starts
+	ModificatorScheduler(std::vector<Job> jobs, const std::vector<std::vector<size_t>> & jobDependencies, JobCallback onJobFinished);
+
+	/// Runs modificators one by one, always picking first ready one in original order
+	/// Produces same order as polling the list of modificators and so same map for same seed
+	void runSequential();
+
+	/// Runs independent modificators concurrently on work-stealing thread pool
+	void runParallel(size_t maxThreads);
+
+private:
+	void addDependency(size_t job, size_t dependency);
+
+	std::vector<Job> jobs;
+	std::vector<std::vector<size_t>> dependents; //indices of jobs waiting for job of given index
+	std::vector<size_t> dependencies; //number of dependencies of job of given index
+
+	JobCallback onJobFinished;
+};
+
+VCMI_LIB_NAMESPACE_END
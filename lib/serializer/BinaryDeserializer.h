@@ -98,8 +98,9 @@ public:
 	Version version;
 
 	std::vector<std::string> loadedStrings;
-	std::map<uint32_t, Serializeable*> loadedPointers;
-	std::map<const Serializeable*, std::shared_ptr<Serializeable>> loadedSharedPointers;
+	/// Loaded pointers, indexed by pointer id. Ids are assigned sequentially on saving, so dense vector is sufficient
+	std::vector<Serializeable*> loadedPointers;
+	std::unordered_map<const Serializeable*, std::shared_ptr<Serializeable>> loadedSharedPointers;
 	IGameCallback * cb = nullptr;
 	static constexpr bool trackSerializedPointers = true;
 	static constexpr bool saving = false;
@@ -263,13 +264,12 @@ public:
 		if(trackSerializedPointers)
 		{
 			load( pid ); //get the id
-			auto i = loadedPointers.find(pid); //lookup
 
-			if(i != loadedPointers.end())
+			if(pid < loadedPointers.size() && loadedPointers[pid] != nullptr)
 			{
 				// We already got this pointer
 				// Cast it in case we are loading it to a non-first base pointer
-				data = dynamic_cast<T>(i->second);
+				data = dynamic_cast<T>(loadedPointers[pid]);
 				return;
 			}
 		}
@@ -305,7 +305,14 @@ public:
 	void ptrAllocated(T *ptr, uint32_t pid)
 	{
 		if(trackSerializedPointers && pid != 0xffffffff)
-			loadedPointers[pid] = const_cast<Serializeable*>(dynamic_cast<const Serializeable*>(ptr)); //add loaded pointer to our lookup map; cast is to avoid errors with const T* pt
+		{
+			// ids are assigned sequentially, so new pointer always receives next free id - anything else is corrupted data
+			if(pid > loadedPointers.size())
+				throw std::runtime_error("Invalid pointer id " + std::to_string(pid) + " encountered during deserialization!");
+			if(pid == loadedPointers.size())
+				loadedPointers.push_back(nullptr);
+			loadedPointers[pid] = const_cast<Serializeable*>(dynamic_cast<const Serializeable*>(ptr)); //add loaded pointer to our lookup table; cast is to avoid errors with const T* pt
+		}
 	}
 
 	template <typename T>
@@ -319,8 +326,8 @@ public:
 
 		if(internalPtr)
 		{
-			auto itr = loadedSharedPointers.find(internalPtrDerived);
-			if(itr != loadedSharedPointers.end())
+			auto [itr, inserted] = loadedSharedPointers.try_emplace(internalPtrDerived);
+			if(!inserted)
 			{
 				// This pointers is already loaded. The "data" needs to be pointed to it,
 				// so their shared state is actually shared.
@@ -330,7 +337,7 @@ public:
 			{
 				auto hlp = std::shared_ptr<NonConstT>(internalPtr);
 				data = hlp;
-				loadedSharedPointers[internalPtrDerived] = std::static_pointer_cast<Serializeable>(hlp);
+				itr->second = std::static_pointer_cast<Serializeable>(hlp);
 			}
 		}
 		else
@@ -84,8 +84,8 @@ class BinarySerializer : public CSaverBase
 public:
 	using Version = ESerializationVersion;
 
-	std::map<std::string, uint32_t> savedStrings;
-	std::map<const Serializeable*, uint32_t> savedPointers;
+	std::unordered_map<std::string, uint32_t> savedStrings;
+	std::unordered_map<const Serializeable*, uint32_t> savedPointers;
 
 	Version version = Version::CURRENT;
 	static constexpr bool trackSerializedPointers = true;
@@ -214,18 +214,11 @@ public:
 			// We might have an object that has multiple inheritance and store it via the non-first base pointer.
 			// Therefore, all pointers need to be normalized to the actual object address.
 			const auto * actualPointer = static_cast<const Serializeable*>(data);
-			auto i = savedPointers.find(actualPointer);
-			if(i != savedPointers.end())
-			{
-				//this pointer has been already serialized - write only it's id
-				save(i->second);
-				return;
-			}
-
-			//give id to this pointer
-			uint32_t pid = savedPointers.size();
-			savedPointers[actualPointer] = pid;
-			save(pid);
+			//give id to this pointer, unless it has been already serialized
+			auto [it, inserted] = savedPointers.try_emplace(actualPointer, savedPointers.size());
+			save(it->second);
+			if(!inserted)
+				return; //this pointer has been already serialized - write only it's id
 		}
 
 		//write type identifier
@@ -10,6 +10,10 @@
 #include "StdInc.h"
 #include "CLoadFile.h"
 
+#include "../filesystem/CCompressedStream.h"
+#include "../filesystem/CMemoryStream.h"
+#include "../vcmi_endian.h"
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 CLoadFile::CLoadFile(const boost::filesystem::path & fname, ESerializationVersion minimalVersion)
@@ -23,12 +27,83 @@ CLoadFile::~CLoadFile() = default;
 
 int CLoadFile::read(std::byte * data, unsigned size)
 {
-	sfile->read(reinterpret_cast<char *>(data), size);
+	if(!chunkedFormat)
+	{
+		sfile->read(reinterpret_cast<char *>(data), size);
+		return size;
+	}
+
+	unsigned bytesRead = 0;
+	while(bytesRead < size)
+	{
+		if(chunkPosition == currentChunk.size())
+			loadNextChunk();
+
+		size_t bytesToCopy = std::min<size_t>(size - bytesRead, currentChunk.size() - chunkPosition);
+		std::copy_n(currentChunk.data() + chunkPosition, bytesToCopy, data + bytesRead);
+		chunkPosition += bytesToCopy;
+		bytesRead += bytesToCopy;
+	}
 	return size;
 }
 
+static std::vector<std::byte> decompressChunk(const std::vector<ui8> & compressedData, uint32_t uncompressedSize)
+{
+	CCompressedStream stream(std::make_unique<CMemoryStream>(compressedData.data(), compressedData.size()), false, uncompressedSize);
+
+	std::vector<std::byte> result(uncompressedSize);
+	stream.read(reinterpret_cast<ui8 *>(result.data()), uncompressedSize);
+	if(stream.tell() != uncompressedSize)
+		throw DecompressionException("Save file chunk is shorter than expected!");
+	return result;
+}
+
+void CLoadFile::startLoadingNextChunk()
+{
+	// arbitrary limit to avoid massive allocation on corrupted file
+	constexpr uint32_t maxChunkSize = 64 * 1024 * 1024;
+
+	uint32_t uncompressedSize;
+	uint32_t compressedSize;
+	sfile->read(reinterpret_cast<char *>(&uncompressedSize), sizeof(uncompressedSize));
+	sfile->read(reinterpret_cast<char *>(&compressedSize), sizeof(compressedSize));
+
+	if(serializer.reverseEndianness)
+	{
+		boost::endian::endian_reverse_inplace(uncompressedSize);
+		boost::endian::endian_reverse_inplace(compressedSize);
+	}
+
+	if(uncompressedSize == 0)
+		return; // end of file - no more chunks
+
+	if(uncompressedSize > maxChunkSize || compressedSize > maxChunkSize)
+		THROW_FORMAT("Error: invalid chunk in save file %s!", fName);
+
+	std::vector<ui8> compressedData(compressedSize);
+	sfile->read(reinterpret_cast<char *>(compressedData.data()), compressedSize);
+
+	nextChunk = std::async(std::launch::async, [compressedData = std::move(compressedData), uncompressedSize]()
+	{
+		return decompressChunk(compressedData, uncompressedSize);
+	});
+}
+
+void CLoadFile::loadNextChunk()
+{
+	if(!nextChunk.valid())
+		THROW_FORMAT("Error: unexpected end of save file %s!", fName);
+
+	currentChunk = nextChunk.get();
+	chunkPosition = 0;
+
+	// read and decompress following chunk while this one is being deserialized
+	startLoadingNextChunk();
+}
+
 void CLoadFile::openNextFile(const boost::filesystem::path & fname, ESerializationVersion minimalVersion)
 {
+	clear();
 	serializer.loadingGamestate = true;
 	assert(!serializer.reverseEndianness);
 	assert(minimalVersion <= ESerializationVersion::CURRENT);
@@ -68,6 +143,12 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, ESerializati
 			else
 				THROW_FORMAT("Error: too new file format (%s)!", fName);
 		}
+
+		if(serializer.version >= ESerializationVersion::COMPRESSED_SAVES)
+		{
+			chunkedFormat = true;
+			startLoadingNextChunk();
+		}
 	}
 	catch(...)
 	{
@@ -85,6 +166,10 @@ void CLoadFile::reportState(vstd::CLoggerBase * out)
 
 void CLoadFile::clear()
 {
+	nextChunk = {};
+	chunkedFormat = false;
+	currentChunk.clear();
+	chunkPosition = 0;
 	sfile = nullptr;
 	fName.clear();
 	serializer.version = ESerializationVersion::NONE;
@@ -11,10 +11,23 @@
 
 #include "BinaryDeserializer.h"
 
+#include <future>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 class DLL_LINKAGE CLoadFile : public IBinaryReader
 {
+	/// True if file consists from compressed chunks (format since COMPRESSED_SAVES)
+	bool chunkedFormat = false;
+	/// decompressed data of chunk that is being read right now
+	std::vector<std::byte> currentChunk;
+	size_t chunkPosition = 0;
+	/// chunk that is being read and decompressed in background while current chunk is deserialized
+	std::future<std::vector<std::byte>> nextChunk;
+
+	void startLoadingNextChunk();
+	void loadNextChunk();
+
 public:
 	BinaryDeserializer serializer;
 
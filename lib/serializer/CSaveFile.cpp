@@ -10,12 +10,20 @@
 #include "StdInc.h"
 #include "CSaveFile.h"
 
+#include "../CThreadHelper.h"
+
+#include <tbb/parallel_for.h>
+#include <zlib.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 CSaveFile::CSaveFile(const boost::filesystem::path &fname)
 	: serializer(this)
+	, fName(fname)
 {
-	openNextFile(fname);
+	putMagicBytes("VCMI"); //write magic identifier
+	serializer & ESerializationVersion::CURRENT; //write format version
+	headerSize = buffer.size();
 }
 
 //must be instantiated in .cpp file for access to complete types of all member fields
@@ -23,28 +31,70 @@ CSaveFile::~CSaveFile() = default;
 
 int CSaveFile::write(const std::byte * data, unsigned size)
 {
-	sfile->write(reinterpret_cast<const char *>(data), size);
+	buffer.insert(buffer.end(), data, data + size);
 	return size;
 }
 
-void CSaveFile::openNextFile(const boost::filesystem::path &fname)
+void CSaveFile::flush()
 {
-	fName = fname;
+	// write into temporary file first, so save with this name remains valid until new one is fully written
+	boost::filesystem::path tempName = fName;
+	tempName += ".tmp";
+
 	try
 	{
-		sfile = std::make_unique<std::fstream>(fname.c_str(), std::ios::out | std::ios::binary);
-		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
+		std::fstream sfile(tempName.c_str(), std::ios::out | std::ios::binary);
+		sfile.exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
+
+		if(!sfile)
+			THROW_FORMAT("Error: cannot open to write %s!", tempName);
+
+		// header is not compressed, so version of save can be determined before reading any chunks
+		sfile.write(reinterpret_cast<const char *>(buffer.data()), headerSize);
+
+		// all chunks are compressed independently from each other, in parallel
+		size_t chunksCount = (buffer.size() - headerSize + chunkSize - 1) / chunkSize;
+		std::vector<std::vector<Bytef>> compressedChunks(chunksCount);
+
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, chunksCount), [this, &compressedChunks](const tbb::blocked_range<size_t> & r)
+		{
+			for(size_t i = r.begin(); i != r.end(); ++i)
+			{
+				size_t chunkStart = headerSize + i * chunkSize;
+				size_t uncompressedSize = std::min(chunkSize, buffer.size() - chunkStart);
+				uLongf compressedSize = compressBound(uncompressedSize);
+
+				compressedChunks[i].resize(compressedSize);
+				if(compress2(compressedChunks[i].data(), &compressedSize, reinterpret_cast<const Bytef *>(buffer.data() + chunkStart), uncompressedSize, Z_DEFAULT_COMPRESSION) != Z_OK)
+					throw std::runtime_error("Failed to compress save file!");
+				compressedChunks[i].resize(compressedSize);
+			}
+		});
 
-		if(!(*sfile))
-			THROW_FORMAT("Error: cannot open to write %s!", fname);
+		const auto writeChunkHeader = [&sfile](uint32_t uncompressedSize, uint32_t compressedSize)
+		{
+			sfile.write(reinterpret_cast<const char *>(&uncompressedSize), sizeof(uncompressedSize));
+			sfile.write(reinterpret_cast<const char *>(&compressedSize), sizeof(compressedSize));
+		};
 
-		sfile->write("VCMI",4); //write magic identifier
-		serializer & ESerializationVersion::CURRENT; //write format version
+		// every chunk is prefixed with its uncompressed and compressed size
+		for(size_t i = 0; i < chunksCount; ++i)
+		{
+			writeChunkHeader(std::min(chunkSize, buffer.size() - headerSize - i * chunkSize), compressedChunks[i].size());
+			sfile.write(reinterpret_cast<const char *>(compressedChunks[i].data()), compressedChunks[i].size());
+		}
+
+		// chunk with zero size marks end of file
+		writeChunkHeader(0, 0);
+		sfile.close();
+
+		boost::filesystem::rename(tempName, fName);
 	}
 	catch(...)
 	{
-		logGlobal->error("Failed to save to %s", fname.string());
-		clear();
+		logGlobal->error("Failed to save to %s", fName.string());
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempName, ec);
 		throw;
 	}
 }
@@ -52,21 +102,65 @@ void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 void CSaveFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CSaveFile");
-	if(sfile.get() && *sfile)
+	out->debug("\tSaving to %s \tPosition: %d", fName, buffer.size());
+}
+
+void CSaveFile::putMagicBytes(const std::string &text)
+{
+	write(reinterpret_cast<const std::byte*>(text.c_str()), text.length());
+}
+
+SaveFileWriter::~SaveFileWriter()
+{
+	onFinished = nullptr;
+	if(thread.joinable())
+		thread.join();
+}
+
+void SaveFileWriter::write(std::shared_ptr<CSaveFile> save, Callback callback)
+{
+	// only one save may be written at the time, otherwise same file might be written concurrently
+	waitForPendingSave();
+
+	written = false;
+	onFinished = std::move(callback);
+	thread = boost::thread([this, save]()
 	{
-		out->debug("\tOpened %s \tPosition: %d", fName, sfile->tellp());
-	}
+		setThreadName("saveWriter");
+		try
+		{
+			save->flush();
+			succeeded = true;
+		}
+		catch(std::exception & e)
+		{
+			logGlobal->error("Failed to save game: %s", e.what());
+			succeeded = false;
+		}
+		written = true;
+	});
 }
 
-void CSaveFile::clear()
+void SaveFileWriter::poll()
 {
-	fName.clear();
-	sfile = nullptr;
+	if(thread.joinable() && written)
+		finish();
 }
 
-void CSaveFile::putMagicBytes(const std::string &text)
+void SaveFileWriter::waitForPendingSave()
 {
-	write(reinterpret_cast<const std::byte*>(text.c_str()), text.length());
+	if(thread.joinable())
+		finish();
+}
+
+void SaveFileWriter::finish()
+{
+	thread.join();
+
+	auto callback = std::move(onFinished);
+	onFinished = nullptr;
+	if(callback)
+		callback(succeeded);
 }
 
 VCMI_LIB_NAMESPACE_END
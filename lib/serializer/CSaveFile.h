@@ -13,20 +13,29 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Serializes data into memory buffer, which is written to disk on flush()
+/// Since flush() does not access serialized objects, it can be called from another thread while game continues
 class DLL_LINKAGE CSaveFile : public IBinaryWriter
 {
+	std::vector<std::byte> buffer;
+
+	/// size of uncompressed file header - magic identifier and format version
+	size_t headerSize;
+
 public:
+	/// Size of uncompressed data in every chunk except for last one
+	static constexpr size_t chunkSize = 1024 * 1024;
+
 	BinarySerializer serializer;
 
 	boost::filesystem::path fName;
-	std::unique_ptr<std::fstream> sfile;
 
-	CSaveFile(const boost::filesystem::path &fname); //throws!
+	CSaveFile(const boost::filesystem::path &fname);
 	~CSaveFile();
 	int write(const std::byte * data, unsigned size) override;
 
-	void openNextFile(const boost::filesystem::path &fname); //throws!
-	void clear();
+	/// Compresses all serialized data and writes it to file. Throws on failure
+	void flush();
 	void reportState(vstd::CLoggerBase * out) override;
 
 	void putMagicBytes(const std::string &text);
@@ -39,4 +48,32 @@ public:
 	}
 };
 
+/// Writes saves to disk on background thread, one at the time
+/// Result is reported by callback called from thread that polls or waits for the writer
+class DLL_LINKAGE SaveFileWriter : boost::noncopyable
+{
+public:
+	using Callback = std::function<void(bool success)>;
+
+	/// Waits for pending write, its callback is not called
+	~SaveFileWriter();
+
+	/// Starts writing given save, previous write is finished first
+	void write(std::shared_ptr<CSaveFile> save, Callback onFinished);
+
+	/// Calls callback of pending write if it is already written
+	void poll();
+
+	/// Blocks until pending write is finished and calls its callback
+	void waitForPendingSave();
+
+private:
+	boost::thread thread;
+	std::atomic<bool> written = false;
+	bool succeeded = false;
+	Callback onFinished;
+
+	void finish();
+};
+
 VCMI_LIB_NAMESPACE_END
@@ -13,10 +13,13 @@
 #include "BinaryDeserializer.h"
 #include "BinarySerializer.h"
 
+#include "../filesystem/CCompressedStream.h"
 #include "../gameState/CGameState.h"
 #include "../networkPacks/NetPacksBase.h"
 #include "../network/NetworkInterface.h"
 
+#include <zlib.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 class DLL_LINKAGE ConnectionPackWriter final : public IBinaryWriter
@@ -36,6 +39,134 @@ public:
 	int read(std::byte * data, unsigned size) final;
 };
 
+/// First byte of every serialized pack is 'isNull' flag of pack pointer, which is always false for valid packs
+/// Compressed packs are marked by different first byte, so uncompressed packs retain their format
+static constexpr std::byte compressedPackMarker{1};
+
+/// Packs smaller than this size are always sent uncompressed - gain would be negligible
+static constexpr size_t compressionThreshold = 4096;
+
+/// Streaming deflate compressor that is shared by all packs sent via connection
+/// Each pack is flushed separately, but data of previous packs remains in compression window and serves as dictionary for following packs
+class ConnectionPackCompressor final : boost::noncopyable
+{
+	z_stream deflateState;
+
+public:
+	ConnectionPackCompressor();
+	~ConnectionPackCompressor();
+
+	/// Appends compressed data to output buffer
+	void compress(const std::vector<std::byte> & input, std::vector<std::byte> & output);
+};
+
+/// Counterpart of ConnectionPackCompressor. Must receive all compressed packs in the same order as they were compressed
+class ConnectionPackDecompressor final : boost::noncopyable
+{
+	z_stream inflateState;
+
+public:
+	ConnectionPackDecompressor();
+	~ConnectionPackDecompressor();
+
+	/// decompressed data of last received pack
+	std::vector<std::byte> buffer;
+
+	void decompress(const std::byte * data, size_t size);
+};
+
+ConnectionPackCompressor::ConnectionPackCompressor()
+{
+	deflateState.zalloc = Z_NULL;
+	deflateState.zfree = Z_NULL;
+	deflateState.opaque = Z_NULL;
+
+	if (deflateInit(&deflateState, Z_DEFAULT_COMPRESSION) != Z_OK)
+		throw std::runtime_error("Failed to initialize deflate!");
+}
+
+ConnectionPackCompressor::~ConnectionPackCompressor()
+{
+	deflateEnd(&deflateState);
+}
+
+void ConnectionPackCompressor::compress(const std::vector<std::byte> & input, std::vector<std::byte> & output)
+{
+	deflateState.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(input.data()));
+	deflateState.avail_in = static_cast<uInt>(input.size());
+
+	size_t outputPosition = output.size();
+	output.resize(outputPosition + deflateBound(&deflateState, input.size()));
+
+	do
+	{
+		if (outputPosition == output.size())
+			output.resize(output.size() * 2);
+
+		deflateState.next_out = reinterpret_cast<Bytef *>(output.data() + outputPosition);
+		deflateState.avail_out = static_cast<uInt>(output.size() - outputPosition);
+
+		// sync flush - all data of this pack must be decompressable on receiving side without waiting for any further packs
+		int ret = deflate(&deflateState, Z_SYNC_FLUSH);
+		if (ret != Z_OK && ret != Z_BUF_ERROR)
+			throw std::runtime_error("Failed to compress network pack!");
+
+		outputPosition = output.size() - deflateState.avail_out;
+	}
+	while (deflateState.avail_out == 0);
+
+	output.resize(outputPosition);
+}
+
+ConnectionPackDecompressor::ConnectionPackDecompressor()
+{
+	inflateState.zalloc = Z_NULL;
+	inflateState.zfree = Z_NULL;
+	inflateState.opaque = Z_NULL;
+	inflateState.avail_in = 0;
+	inflateState.next_in = Z_NULL;
+
+	if (inflateInit(&inflateState) != Z_OK)
+		throw std::runtime_error("Failed to initialize inflate!");
+}
+
+ConnectionPackDecompressor::~ConnectionPackDecompressor()
+{
+	inflateEnd(&inflateState);
+}
+
+void ConnectionPackDecompressor::decompress(const std::byte * data, size_t size)
+{
+	inflateState.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(data));
+	inflateState.avail_in = static_cast<uInt>(size);
+
+	buffer.resize(std::max<size_t>(buffer.capacity(), size * 4));
+	size_t outputPosition = 0;
+
+	do
+	{
+		if (outputPosition == buffer.size())
+			buffer.resize(buffer.size() * 2);
+
+		inflateState.next_out = reinterpret_cast<Bytef *>(buffer.data() + outputPosition);
+		inflateState.avail_out = static_cast<uInt>(buffer.size() - outputPosition);
+
+		int ret = inflate(&inflateState, Z_SYNC_FLUSH);
+		if (ret != Z_OK && ret != Z_BUF_ERROR)
+		{
+			if (inflateState.msg == nullptr)
+				throw DecompressionException("Failed to decompress network pack! Error code " + std::to_string(ret));
+			else
+				throw DecompressionException(std::string("Failed to decompress network pack! ") + inflateState.msg);
+		}
+
+		outputPosition = buffer.size() - inflateState.avail_out;
+	}
+	while (inflateState.avail_in != 0 || inflateState.avail_out == 0);
+
+	buffer.resize(outputPosition);
+}
+
 int ConnectionPackWriter::write(const std::byte * data, unsigned size)
 {
 	buffer.insert(buffer.end(), data, data + size);
@@ -58,6 +189,8 @@ CConnection::CConnection(std::weak_ptr<INetworkConnection> networkConnection)
 	, packWriter(std::make_unique<ConnectionPackWriter>())
 	, deserializer(std::make_unique<BinaryDeserializer>(packReader.get()))
 	, serializer(std::make_unique<BinarySerializer>(packWriter.get()))
+	, compressor(std::make_unique<ConnectionPackCompressor>())
+	, decompressor(std::make_unique<ConnectionPackDecompressor>())
 	, connectionID(-1)
 {
 	assert(networkConnection.lock() != nullptr);
@@ -68,30 +201,104 @@ CConnection::CConnection(std::weak_ptr<INetworkConnection> networkConnection)
 
 CConnection::~CConnection() = default;
 
-void CConnection::sendPack(const CPack & pack)
+void CConnection::serializeToBuffer(const CPack & pack)
 {
-	boost::mutex::scoped_lock lock(writeMutex);
+	packWriter->buffer.clear();
+	(*serializer) & (&pack);
+	serializer->savedPointers.clear();
 
+	// each pack has its own table of strings, otherwise serialized pack would depend on all packs previously sent via this connection
+	if (serializer->version >= ESerializationVersion::PACK_LOCAL_STRINGS)
+		serializer->savedStrings.clear();
+}
+
+void CConnection::sendBuffer(const std::vector<std::byte> & data)
+{
 	auto connectionPtr = networkConnection.lock();
 
 	if (!connectionPtr)
 		throw std::runtime_error("Attempt to send packet on a closed connection!");
 
-	packWriter->buffer.clear();
-	(*serializer) & (&pack);
+	connectionPtr->sendPacket(data);
+}
+
+bool CConnection::shouldCompress(const std::vector<std::byte> & data) const
+{
+	return packCompressionEnabled && data.size() >= compressionThreshold;
+}
+
+void CConnection::sendPack(const CPack & pack)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	serializeToBuffer(pack);
 
 	logNetwork->trace("Sending a pack of type %s", typeid(pack).name());
 
-	connectionPtr->sendPacket(packWriter->buffer);
+	if (shouldCompress(packWriter->buffer))
+	{
+		std::vector<std::byte> compressed = { compressedPackMarker };
+		compressor->compress(packWriter->buffer, compressed);
+		sendBuffer(compressed);
+	}
+	else
+		sendBuffer(packWriter->buffer);
+
 	packWriter->buffer.clear();
-	serializer->savedPointers.clear();
+}
+
+NetworkPacketPtr CConnection::serializePack(const CPack & pack)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	serializeToBuffer(pack);
+
+	auto result = std::make_shared<std::vector<std::byte>>();
+	std::swap(*result, packWriter->buffer);
+	return result;
+}
+
+void CConnection::sendSerializedPack(const NetworkPacketPtr & data)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	auto connectionPtr = networkConnection.lock();
+
+	if (!connectionPtr)
+		throw std::runtime_error("Attempt to send packet on a closed connection!");
+
+	// compressor state is specific to this connection, so compressed data can not be shared with other connections
+	if (shouldCompress(*data))
+	{
+		auto compressed = std::make_shared<std::vector<std::byte>>(1, compressedPackMarker);
+		compressor->compress(*data, *compressed);
+		connectionPtr->sendPacket(compressed);
+	}
+	else
+		connectionPtr->sendPacket(data);
+}
+
+bool CConnection::isSerializationCompatible(const CConnection & other) const
+{
+	// NOTE: vectorized types are not compared - all connections in gameplay mode are registered using same game state
+	return serializer->version == other.serializer->version
+		&& serializer->version >= ESerializationVersion::PACK_LOCAL_STRINGS
+		&& packWriter->sendStackInstanceByIds == other.packWriter->sendStackInstanceByIds
+		&& packWriter->smartVectorMembersSerialization == other.packWriter->smartVectorMembersSerialization;
 }
 
 std::unique_ptr<CPack> CConnection::retrievePack(const std::vector<std::byte> & data)
 {
 	std::unique_ptr<CPack> result;
 
-	packReader->buffer = &data;
+	if (!data.empty() && data.front() == compressedPackMarker)
+	{
+		decompressor->decompress(data.data() + 1, data.size() - 1);
+		packReader->buffer = &decompressor->buffer;
+	}
+	else
+		packReader->buffer = &data;
+
 	packReader->position = 0;
 
 	*deserializer & result;
@@ -99,12 +306,14 @@ std::unique_ptr<CPack> CConnection::retrievePack(const std::vector<std::byte> &
 	if (result == nullptr)
 		throw std::runtime_error("Failed to retrieve pack!");
 
-	if (packReader->position != data.size())
+	if (packReader->position != packReader->buffer->size())
 		throw std::runtime_error("Failed to retrieve pack! Not all data has been read!");
 
 	logNetwork->trace("Received CPack of type %s", typeid(result.get()).name());
 	deserializer->loadedPointers.clear();
 	deserializer->loadedSharedPointers.clear();
+	if (deserializer->version >= ESerializationVersion::PACK_LOCAL_STRINGS)
+		deserializer->loadedStrings.clear();
 	return result;
 }
 
@@ -167,6 +376,7 @@ void CConnection::setSerializationVersion(ESerializationVersion version)
 {
 	deserializer->version = version;
 	serializer->version = version;
+	packCompressionEnabled = version >= ESerializationVersion::PACK_COMPRESSION;
 }
 
 VCMI_LIB_NAMESPACE_END
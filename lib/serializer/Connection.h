@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include "../network/NetworkInterface.h"
+
 enum class ESerializationVersion : int32_t;
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -16,9 +18,10 @@ VCMI_LIB_NAMESPACE_BEGIN
 class BinaryDeserializer;
 class BinarySerializer;
 struct CPack;
-class INetworkConnection;
 class ConnectionPackReader;
 class ConnectionPackWriter;
+class ConnectionPackCompressor;
+class ConnectionPackDecompressor;
 class CGameState;
 class IGameCallback;
 
@@ -33,6 +36,11 @@ class DLL_LINKAGE CConnection : boost::noncopyable
 	std::unique_ptr<ConnectionPackWriter> packWriter;
 	std::unique_ptr<BinaryDeserializer> deserializer;
 	std::unique_ptr<BinarySerializer> serializer;
+	std::unique_ptr<ConnectionPackCompressor> compressor;
+	std::unique_ptr<ConnectionPackDecompressor> decompressor;
+
+	/// True if both sides of connection have agreed on version that supports compressed packs
+	bool packCompressionEnabled = false;
 
 	boost::mutex writeMutex;
 
@@ -40,6 +48,9 @@ class DLL_LINKAGE CConnection : boost::noncopyable
 	void enableStackSendingByID();
 	void disableSmartVectorMemberSerialization();
 	void enableSmartVectorMemberSerializatoin(CGameState * gs);
+	void serializeToBuffer(const CPack & pack);
+	void sendBuffer(const std::vector<std::byte> & data);
+	bool shouldCompress(const std::vector<std::byte> & data) const;
 
 public:
 	bool isMyConnection(const std::shared_ptr<INetworkConnection> & otherConnection) const;
@@ -52,6 +63,13 @@ public:
 	~CConnection();
 
 	void sendPack(const CPack & pack);
+
+	/// Serializes pack without sending it, so same data can be sent to multiple connections via sendSerializedPack
+	NetworkPacketPtr serializePack(const CPack & pack);
+	void sendSerializedPack(const NetworkPacketPtr & data);
+	/// Returns true if pack serialized by this connection can be sent as is to other connection
+	bool isSerializationCompatible(const CConnection & other) const;
+
 	std::unique_ptr<CPack> retrievePack(const std::vector<std::byte> & data);
 
 	void enterLobbyConnectionMode();
@@ -69,6 +69,10 @@ enum class ESerializationVersion : int32_t
 	FOLDER_NAME_REWORK, // 870 - rework foldername
 	REWARDABLE_GUARDS, // 871 - fix missing serialization of guards in rewardable objects
 	MARKET_TRANSLATION_FIX, // 872 - remove serialization of markets translateable strings
-	
-	CURRENT = MARKET_TRANSLATION_FIX
+	PACK_LOCAL_STRINGS, // 873 - network packs no longer share table of compacted strings with previously sent packs
+	PACK_COMPRESSION, // 874 - large network packs may be sent compressed
+	COMPRESSED_SAVES, // 875 - saved games are stored as sequence of independently compressed chunks
+	BINARY_UNIT_STATE, // 876 - battle unit changes carry binary unit state instead of json
+
+	CURRENT = BINARY_UNIT_STATE
 };
@@ -135,10 +135,9 @@ protected:
 		if(!m->isMagicalEffect()) //Always pass on non-magical
 			return true;
 
-		std::stringstream cachingStr;
-		cachingStr << "type_" << vstd::to_underlying(BonusType::LEVEL_SPELL_IMMUNITY) << "addInfo_1";
+		static const auto cachingKey = BonusCacheKey::typeInfo(BonusType::LEVEL_SPELL_IMMUNITY, 1);
 
-		TConstBonusListPtr levelImmunities = target->getBonuses(Selector::type()(BonusType::LEVEL_SPELL_IMMUNITY).And(Selector::info()(1)), cachingStr.str());
+		TConstBonusListPtr levelImmunities = target->getBonuses(Selector::type()(BonusType::LEVEL_SPELL_IMMUNITY).And(Selector::info()(1)), cachingKey);
 		return (levelImmunities->size() == 0 || levelImmunities->totalValue() < m->getSpellLevel() || m->getSpellLevel() <= 0);
 	}
 };
@@ -155,9 +154,8 @@ public:
 protected:
 	bool check(const Mechanics * m, const battle::Unit * target) const override
 	{
-		std::stringstream cachingStr;
-		cachingStr << "type_" << vstd::to_underlying(BonusType::SPELL_IMMUNITY) << "subtype_" << m->getSpellIndex() << "addInfo_1";
-		return !target->hasBonus(Selector::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(m->getSpellId()), 1), cachingStr.str());
+		const auto cachingKey = BonusCacheKey::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(m->getSpellId()), 1);
+		return !target->hasBonus(Selector::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(m->getSpellId()), 1), cachingKey);
 	}
 };
 
@@ -255,22 +253,19 @@ class SpellEffectCondition : public TargetConditionItemBase
 public:
 	SpellEffectCondition(const SpellID & spellID_): spellID(spellID_)
 	{
-		std::stringstream builder;
-		builder << "source_" << vstd::to_underlying(BonusSource::SPELL_EFFECT) << "id_" << spellID.num;
-		cachingString = builder.str();
-
+		cachingKey = BonusCacheKey::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID));
 		selector = Selector::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID));
 	}
 
 protected:
 	bool check(const Mechanics * m, const battle::Unit * target) const override
 	{
-		return target->hasBonus(selector, cachingString);
+		return target->hasBonus(selector, cachingKey);
 	}
 
 private:
 	CSelector selector;
-	std::string cachingString;
+	BonusCacheKey cachingKey;
 	SpellID spellID;
 };
 
@@ -279,12 +274,12 @@ class ReceptiveFeatureCondition : public TargetConditionItemBase
 protected:
 	bool check(const Mechanics * m, const battle::Unit * target) const override
 	{
-		return m->isPositiveSpell() && target->hasBonus(selector, cachingString);
+		return m->isPositiveSpell() && target->hasBonus(selector, cachingKey);
 	}
 
 private:
 	CSelector selector = Selector::type()(BonusType::RECEPTIVE);
-	std::string cachingString = "type_RECEPTIVE";
+	BonusCacheKey cachingKey = BonusCacheKey::type(BonusType::RECEPTIVE);
 };
 
 class ImmunityNegationCondition : public TargetConditionItemBase
@@ -64,7 +64,7 @@ void Clone::apply(ServerCallback * server, const Mechanics * m, const EffectTarg
 		BattleUnitsChanged pack;
 		pack.battleID = m->battle()->getBattle()->getBattleID();
 		pack.changedStacks.emplace_back(info.id, UnitChanges::EOperation::ADD);
-		info.save(pack.changedStacks.back().data);
+		pack.changedStacks.back().info = info;
 		server->apply(pack);
 
 		//TODO: use BattleUnitsChanged with UPDATE operation
@@ -83,12 +83,12 @@ void Clone::apply(ServerCallback * server, const Mechanics * m, const EffectTarg
 		auto cloneState = cloneUnit->acquireState();
 		cloneState->cloned = true;
 		cloneFlags.changedStacks.emplace_back(cloneState->unitId(), UnitChanges::EOperation::RESET_STATE);
-		cloneState->save(cloneFlags.changedStacks.back().data);
+		cloneState->save(cloneFlags.changedStacks.back().state);
 
 		auto originalState = clonedStack->acquireState();
 		originalState->cloneID = unitId;
 		cloneFlags.changedStacks.emplace_back(originalState->unitId(), UnitChanges::EOperation::RESET_STATE);
-		originalState->save(cloneFlags.changedStacks.back().data);
+		originalState->save(cloneFlags.changedStacks.back().state);
 
 		server->apply(cloneFlags);
 
@@ -91,7 +91,7 @@ void DemonSummon::apply(ServerCallback * server, const Mechanics * m, const Effe
 
 		// add newly created creature
 		pack.changedStacks.emplace_back(info.id, UnitChanges::EOperation::ADD);
-		info.save(pack.changedStacks.back().data);
+		pack.changedStacks.back().info = info;
 
 		// and remove corpse to prevent second raising or resurrection
 		pack.changedStacks.emplace_back(targetStack->unitId(), UnitChanges::EOperation::REMOVE);
@@ -144,7 +144,7 @@ void Heal::prepareHealEffect(int64_t value, BattleUnitsChanged & pack, BattleLog
 			{
 				UnitChanges info(state->unitId(), UnitChanges::EOperation::RESET_STATE);
 				info.healthDelta = unitHPgained;
-				state->save(info.data);
+				state->save(info.state);
 				pack.changedStacks.push_back(info);
 			}
 		}
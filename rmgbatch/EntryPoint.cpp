@@ -0,0 +1,241 @@
+/*
+ * EntryPoint.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/CConsoleHandler.h"
+#include "../lib/logging/CBasicLogConfigurator.h"
+#include "../lib/VCMIDirs.h"
+#include "../lib/VCMI_Lib.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapping/CMapService.h"
+#include "../lib/rmg/CMapGenOptions.h"
+#include "../lib/rmg/CMapGenerator.h"
+#include "../lib/rmg/CRmgTemplate.h"
+#include "../lib/rmg/CRmgTemplateStorage.h"
+
+#include <boost/program_options.hpp>
+
+namespace
+{
+
+struct BatchOptions
+{
+	std::string templateName;
+	const CRmgTemplate * mapTemplate = nullptr; // resolved after library is loaded
+	int width;
+	int height;
+	bool twoLevels;
+	int players; // 0 - as allowed by template
+	int firstSeed;
+	int count;
+	int threads;
+	boost::filesystem::path outputDir; // maps are not saved if empty
+	boost::filesystem::path timingsFile; // timings are printed to standard output if empty
+};
+
+struct GenerationResult
+{
+	int seed;
+	bool success;
+	CMapGenerator::PhaseTimings timings;
+};
+
+void handleCommandOptions(int argc, const char * argv[], BatchOptions & batch)
+{
+	boost::program_options::options_description opts("Allowed options");
+	opts.add_options()
+	("help,h", "display help and exit")
+	("template", boost::program_options::value<std::string>(), "name of random map template")
+	("width", boost::program_options::value<int>()->default_value(CMapHeader::MAP_SIZE_MIDDLE), "map width")
+	("height", boost::program_options::value<int>()->default_value(CMapHeader::MAP_SIZE_MIDDLE), "map height")
+	("two-levels", "generate underground level")
+	("players", boost::program_options::value<int>()->default_value(0), "number of human or computer players, random if not set")
+	("seed", boost::program_options::value<int>()->default_value(0), "random seed of first map, following maps use consecutive seeds")
+	("count", boost::program_options::value<int>()->default_value(1), "number of maps to generate")
+	("threads", boost::program_options::value<int>()->default_value(0), "number of maps generated concurrently, one per core if not set")
+	("output", boost::program_options::value<std::string>(), "directory for generated .vmap files, maps are not saved if not set")
+	("timings", boost::program_options::value<std::string>(), "CSV file for timings of generation phases, standard output if not set");
+
+	boost::program_options::variables_map options;
+	try
+	{
+		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, opts), options);
+		boost::program_options::notify(options);
+	}
+	catch(boost::program_options::error & e)
+	{
+		std::cerr << "Failure during parsing command-line options:\n" << e.what() << std::endl;
+		exit(1);
+	}
+
+	if(options.count("help") || !options.count("template"))
+	{
+		printf("%s - batch random map generator\n", GameConstants::VCMI_VERSION.c_str());
+		printf("Generates maps of single template for range of seeds and reports time spent in each generation phase\n");
+		printf("\n");
+		std::cout << opts;
+		exit(options.count("help") ? 0 : 1);
+	}
+
+	batch.templateName = options["template"].as<std::string>();
+	batch.width = options["width"].as<int>();
+	batch.height = options["height"].as<int>();
+	batch.twoLevels = options.count("two-levels");
+	batch.players = options["players"].as<int>();
+	batch.firstSeed = options["seed"].as<int>();
+	batch.count = options["count"].as<int>();
+	batch.threads = options["threads"].as<int>();
+	if(batch.threads <= 0)
+		batch.threads = std::max(1u, boost::thread::hardware_concurrency());
+	if(options.count("output"))
+		batch.outputDir = boost::filesystem::absolute(options["output"].as<std::string>());
+	if(options.count("timings"))
+		batch.timingsFile = boost::filesystem::absolute(options["timings"].as<std::string>());
+}
+
+bool resolveTemplate(BatchOptions & batch)
+{
+	batch.mapTemplate = VLC->tplh->getTemplate(batch.templateName);
+	if(!batch.mapTemplate)
+	{
+		logGlobal->error("Unknown random map template '%s'", batch.templateName);
+		return false;
+	}
+
+	// template would silently replace size that does not fit it, and all results would be labelled with wrong size
+	int3 size(batch.width, batch.height, batch.twoLevels ? 2 : 1);
+	if(!batch.mapTemplate->matchesSize(size))
+	{
+		auto sizes = batch.mapTemplate->getMapSizes();
+		logGlobal->error("Template '%s' does not allow map size %s, allowed range is from %s to %s", batch.templateName, size.toString(), sizes.first.toString(), sizes.second.toString());
+		return false;
+	}
+
+	return true;
+}
+
+GenerationResult generateMap(const BatchOptions & batch, int seed)
+{
+	GenerationResult result{seed, false, {}};
+
+	try
+	{
+		CMapGenOptions mapGenOptions;
+		mapGenOptions.setWidth(batch.width);
+		mapGenOptions.setHeight(batch.height);
+		mapGenOptions.setHasTwoLevels(batch.twoLevels);
+		mapGenOptions.setMapTemplate(batch.mapTemplate);
+		if(batch.players > 0)
+			mapGenOptions.setHumanOrCpuPlayerCount(batch.players);
+
+		// maps are generated concurrently already, single thread per map also keeps map reproducible from seed
+		CMapGenerator generator(mapGenOptions, nullptr, seed);
+		generator.setSingleThread(true);
+
+		auto map = generator.generate();
+		result.timings = generator.getPhaseTimings();
+
+		if(!batch.outputDir.empty())
+		{
+			auto start = std::chrono::steady_clock::now();
+			auto fileName = boost::str(boost::format("%s_%d.vmap") % batch.templateName % seed);
+			CMapService().saveMap(map, batch.outputDir / fileName);
+			result.timings.emplace_back("serialization", std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+		}
+		result.success = true;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->error("Generation of map with seed %d failed: %s", seed, e.what());
+	}
+
+	return result;
+}
+
+void writeTimings(std::ostream & out, const BatchOptions & batch, const std::vector<GenerationResult> & results)
+{
+	out << "template,seed,phase,microseconds\n";
+	for(const auto & result : results)
+	{
+		if(!result.success)
+		{
+			out << batch.templateName << ',' << result.seed << ",failed,0\n";
+			continue;
+		}
+
+		for(const auto & phase : result.timings)
+			out << batch.templateName << ',' << result.seed << ',' << phase.first << ',' << phase.second.count() << '\n';
+	}
+	out.flush();
+}
+
+}
+
+int main(int argc, const char * argv[])
+{
+	// Paths from command line are relative to directory in which tool was started
+	BatchOptions batch;
+	handleCommandOptions(argc, argv, batch);
+
+	// Correct working dir executable folder (not bundle folder) so we can use executable relative paths
+	boost::filesystem::current_path(boost::filesystem::system_complete(argv[0]).parent_path());
+
+	console = new CConsoleHandler();
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userLogsPath() / "VCMI_RMG_log.txt", console);
+	logConfig.configureDefault();
+	preinitDLL(console, false);
+	logConfig.configure();
+	loadDLLClasses();
+
+	if(!resolveTemplate(batch))
+	{
+		logConfig.deconfigure();
+		vstd::clear_pointer(VLC);
+		return 1;
+	}
+
+	if(!batch.outputDir.empty())
+		boost::filesystem::create_directories(batch.outputDir);
+
+	// seeds are handed out one by one, so results do not depend on number of threads
+	std::vector<GenerationResult> results(batch.count);
+	std::atomic<int> nextMap(0);
+	std::vector<boost::thread> workers;
+
+	for(int i = 0; i < std::min(batch.threads, batch.count); i++)
+	{
+		workers.emplace_back([&batch, &results, &nextMap]()
+		{
+			for(int index = nextMap++; index < batch.count; index = nextMap++)
+			{
+				results[index] = generateMap(batch, batch.firstSeed + index);
+				logGlobal->info("Map %d of %d generated", index + 1, batch.count);
+			}
+		});
+	}
+
+	for(auto & worker : workers)
+		worker.join();
+
+	if(batch.timingsFile.empty())
+	{
+		writeTimings(std::cout, batch, results);
+	}
+	else
+	{
+		std::ofstream out(batch.timingsFile.c_str());
+		writeTimings(out, batch, results);
+	}
+
+	logConfig.deconfigure();
+	vstd::clear_pointer(VLC);
+
+	return boost::range::count_if(results, [](const GenerationResult & result){ return !result.success; }) ? 1 : 0;
+}
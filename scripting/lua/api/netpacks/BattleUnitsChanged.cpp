@@ -54,6 +54,8 @@ int BattleUnitsChangedProxy::add(lua_State * L)
 	if(!S.tryGet(3, changes.data))
 		return S.retVoid();
 
+	changes.info.load(id, changes.data);
+
 	if(!S.tryGet(4, changes.healthDelta))
 		changes.healthDelta = 0;
 
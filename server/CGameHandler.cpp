@@ -377,7 +377,6 @@ void CGameHandler::giveExperience(const CGHeroInstance * hero, TExpType amountTo
 		scp.which = SetCommanderProperty::EXPERIENCE;
 		scp.amount = amountToGain;
 		sendAndApply(scp);
-		CBonusSystemNode::treeHasChanged();
 	}
 
 	expGiven(hero);
@@ -739,6 +738,7 @@ void CGameHandler::start(bool resume)
 void CGameHandler::tick(int millisecondsPassed)
 {
 	turnTimerHandler->update(millisecondsPassed);
+	saveWriter.poll();
 }
 
 void CGameHandler::giveSpells(const CGTownInstance *t, const CGHeroInstance *h)
@@ -1436,8 +1436,20 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 void CGameHandler::sendToAllClients(CPackForClient & pack)
 {
 	logNetwork->trace("\tSending to all clients: %s", typeid(pack).name());
-	for (auto c : lobby->activeConnections)
-		c->sendPack(pack);
+
+	// pack is serialized only once for every group of connections with same serialization settings - usually once for all clients
+	std::vector<std::pair<std::shared_ptr<CConnection>, NetworkPacketPtr>> serializedPacks;
+
+	for (const auto & c : lobby->activeConnections)
+	{
+		auto it = boost::find_if(serializedPacks, [&c](const auto & entry){ return entry.first->isSerializationCompatible(*c); });
+		if (it == serializedPacks.end())
+		{
+			serializedPacks.emplace_back(c, c->serializePack(pack));
+			it = std::prev(serializedPacks.end());
+		}
+		c->sendSerializedPack(it->second);
+	}
 }
 
 void CGameHandler::sendAndApply(CPackForClient & pack)
@@ -1524,7 +1536,7 @@ void CGameHandler::throwAndComplain(CPackForServer * pack, std::string txt)
 	throwNotAllowedAction(pack);
 }
 
-void CGameHandler::save(const std::string & filename)
+void CGameHandler::save(const std::string & filename, std::function<void(bool success)> onSaved)
 {
 	logGlobal->info("Saving to %s", filename);
 	const auto stem	= FileInfo::GetPathStem(filename);
@@ -1532,19 +1544,30 @@ void CGameHandler::save(const std::string & filename)
 	ResourcePath savePath(stem.to_string(), EResType::SAVEGAME);
 	CResourceHandler::get("local")->createResource(savefname);
 
+	// previous save must be on disk before its resource is overwritten
+	saveWriter.waitForPendingSave();
+
 	try
 	{
+		auto save = std::make_shared<CSaveFile>(*CResourceHandler::get("local")->getResourceName(savePath));
+		saveCommonState(*save);
+		logGlobal->info("Saving server state");
+		*save << *this;
+
+		// game state has been captured in memory, writing it to disk does not need to block the game
+		saveWriter.write(save, [onSaved](bool success)
 		{
-			CSaveFile save(*CResourceHandler::get("local")->getResourceName(savePath));
-			saveCommonState(save);
-			logGlobal->info("Saving server state");
-			save << *this;
-		}
-		logGlobal->info("Game has been successfully saved!");
+			if(success)
+				logGlobal->info("Game has been successfully saved!");
+			if(onSaved)
+				onSaved(success);
+		});
 	}
 	catch(std::exception &e)
 	{
 		logGlobal->error("Failed to save game: %s", e.what());
+		if(onSaved)
+			onSaved(false);
 	}
 }
 
@@ -16,6 +16,7 @@
 #include "../lib/ScriptHandler.h"
 #include "../lib/gameState/GameStatistics.h"
 #include "../lib/networkPacks/PacksForServer.h"
+#include "../lib/serializer/CSaveFile.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -57,6 +58,9 @@ class CGameHandler : public IGameCallback, public Environment
 {
 	CVCMIServer * lobby;
 
+	/// Writes last requested save to disk
+	SaveFileWriter saveWriter;
+
 public:
 	std::unique_ptr<HeroPoolProcessor> heroPool;
 	std::unique_ptr<BattleProcessor> battles;
@@ -226,7 +230,8 @@ public:
 	bool bulkSplitStack(SlotID src, ObjectInstanceID srcOwner, si32 howMany);
 	bool bulkMergeStacks(SlotID slotSrc, ObjectInstanceID srcOwner);
 	bool bulkSmartSplitStack(SlotID slotSrc, ObjectInstanceID srcOwner);
-	void save(const std::string &fname);
+	/// Saved game is written to disk in background, onSaved is called from tick() once file is written or write failed
+	void save(const std::string &fname, std::function<void(bool success)> onSaved = nullptr);
 	bool load(const std::string &fname);
 
 	void onPlayerTurnStarted(PlayerColor which);
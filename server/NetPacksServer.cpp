@@ -31,8 +31,12 @@
 
 void ApplyGhNetPackVisitor::visitSaveGame(SaveGame & pack)
 {
-	gh.save(pack.fname);
-	logGlobal->info("Game has been saved as %s", pack.fname);
+	const std::string fname = pack.fname;
+	gh.save(fname, [fname](bool success)
+	{
+		if(success)
+			logGlobal->info("Game has been saved as %s", fname);
+	});
 	result = true;
 }
 
@@ -1028,7 +1028,7 @@ void BattleActionProcessor::makeAttack(const CBattleInfoCallback & battle, const
 
 	{
 		UnitChanges info(attackerState->unitId(), UnitChanges::EOperation::RESET_STATE);
-		attackerState->save(info.data);
+		attackerState->save(info.state);
 		bat.attackerChanges.changedStacks.push_back(info);
 	}
 
@@ -1385,7 +1385,7 @@ void BattleActionProcessor::handleAfterAttackCasting(const CBattleInfoCallback &
 		BattleUnitsChanged addUnits;
 		addUnits.battleID = battle.getBattle()->getBattleID();
 		addUnits.changedStacks.emplace_back(resurrectInfo.id, UnitChanges::EOperation::ADD);
-		resurrectInfo.save(addUnits.changedStacks.back().data);
+		addUnits.changedStacks.back().info = resurrectInfo;
 
 		BattleUnitsChanged removeUnits;
 		removeUnits.battleID = battle.getBattle()->getBattleID();
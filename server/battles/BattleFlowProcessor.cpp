@@ -178,7 +178,7 @@ void BattleFlowProcessor::trySummonGuardians(const CBattleInfoCallback & battle,
 			BattleUnitsChanged pack;
 			pack.battleID = battle.getBattle()->getBattleID();
 			pack.changedStacks.emplace_back(info.id, UnitChanges::EOperation::ADD);
-			info.save(pack.changedStacks.back().data);
+			pack.changedStacks.back().info = info;
 			gameHandler->sendAndApply(pack);
 		}
 	}
@@ -114,8 +114,14 @@ void PlayerMessageProcessor::commandSave(PlayerColor player, const std::vector<s
 
 	if(words.size() == 2)
 	{
-		gameHandler->save("Saves/" + words[1]);
-		broadcastSystemMessage("game saved as " + words[1]);
+		const std::string name = words[1];
+		gameHandler->save("Saves/" + name, [this, name](bool success)
+		{
+			if(success)
+				broadcastSystemMessage("game saved as " + name);
+			else
+				broadcastSystemMessage("failed to save game as " + name);
+		});
 	}
 }
 
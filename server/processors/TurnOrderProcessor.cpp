@@ -18,7 +18,7 @@
 
 #include "../../lib/CPlayerState.h"
 #include "../../lib/mapping/CMap.h"
-#include "../../lib/mapObjects/CGObjectInstance.h"
+#include "../../lib/mapObjects/CGHeroInstance.h"
 #include "../../lib/gameState/CGameState.h"
 #include "../../lib/pathfinder/CPathfinder.h"
 #include "../../lib/pathfinder/PathfinderOptions.h"
@@ -121,36 +121,32 @@ bool TurnOrderProcessor::playersInContact(PlayerColor left, PlayerColor right) c
 		}
 	}
 
-	for(const auto & hero : leftInfo->getHeroes())
-	{
-		CPathsInfo out(mapSize, hero);
-		auto config = std::make_shared<SingleHeroPathfinderConfig>(out, gameHandler->gameState(), hero);
-		config->options.ignoreGuards = true;
-		config->options.turnLimit = 1;
-		CPathfinder pathfinder(gameHandler->gameState(), config);
-		pathfinder.calculatePaths();
+	std::vector<std::unique_ptr<CPathsInfo>> paths;
+	std::vector<std::shared_ptr<PathfinderConfig>> configs;
 
-		for (int z = 0; z < mapSize.z; ++z)
-			for (int y = 0; y < mapSize.y; ++y)
-				for (int x = 0; x < mapSize.x; ++x)
-					if (out.getNode({x,y,z})->reachable())
-						leftReachability[z][x][y] = true;
+	for(const auto * info : {leftInfo, rightInfo})
+	{
+		for(const auto & hero : info->getHeroes())
+		{
+			paths.push_back(std::make_unique<CPathsInfo>(mapSize, hero));
+			auto config = std::make_shared<SingleHeroPathfinderConfig>(*paths.back(), gameHandler->gameState(), hero);
+			config->options.ignoreGuards = true;
+			config->options.turnLimit = 1;
+			configs.push_back(config);
+		}
 	}
 
-	for(const auto & hero : rightInfo->getHeroes())
+	gameHandler->gameState()->calculatePaths(configs);
+
+	for(const auto & out : paths)
 	{
-		CPathsInfo out(mapSize, hero);
-		auto config = std::make_shared<SingleHeroPathfinderConfig>(out, gameHandler->gameState(), hero);
-		config->options.ignoreGuards = true;
-		config->options.turnLimit = 1;
-		CPathfinder pathfinder(gameHandler->gameState(), config);
-		pathfinder.calculatePaths();
+		auto & reachability = out->hero->tempOwner == left ? leftReachability : rightReachability;
 
 		for (int z = 0; z < mapSize.z; ++z)
 			for (int y = 0; y < mapSize.y; ++y)
 				for (int x = 0; x < mapSize.x; ++x)
-					if (out.getNode({x,y,z})->reachable())
-						rightReachability[z][x][y] = true;
+					if (out->getNode({x,y,z})->reachable())
+						reachability[z][x][y] = true;
 	}
 
 	for (int z = 0; z < mapSize.z; ++z)
@@ -0,0 +1,80 @@
+/*
+ * BattleHexMaskTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/battle/AccessibilityInfo.h"
+#include "../lib/battle/BattleHexMask.h"
+
+TEST(BattleHexMaskTest, DilationMatchesNeighbouringTiles)
+{
+	for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+	{
+		BattleHexMask expected;
+		for(auto neighbour : BattleHex(hex).neighbouringTiles())
+			expected.set(neighbour);
+
+		BattleHexMask single;
+		single.set(hex);
+
+		EXPECT_EQ(single.dilated(), expected) << "hex " << hex;
+		EXPECT_EQ(BattleHexMask::neighbours(hex), expected) << "hex " << hex;
+	}
+}
+
+TEST(BattleHexMaskTest, SetOperations)
+{
+	BattleHexMask mask;
+	EXPECT_TRUE(mask.empty());
+	EXPECT_EQ(mask.first(), BattleHex::INVALID);
+
+	mask.set(186);
+	mask.set(64);
+	mask.set(3);
+	EXPECT_EQ(mask.count(), 3);
+	EXPECT_EQ(mask.first(), 3);
+
+	std::vector<BattleHex> hexes;
+	mask.forEach([&](BattleHex hex){ hexes.push_back(hex); });
+	EXPECT_EQ(hexes, std::vector<BattleHex>({3, 64, 186}));
+
+	EXPECT_EQ((~mask).count(), GameConstants::BFIELD_SIZE - 3);
+	EXPECT_TRUE((mask & ~mask).empty());
+
+	auto shifted = mask.shifted(1);
+	EXPECT_EQ(shifted.count(), 2);
+	EXPECT_TRUE(shifted.test(4));
+	EXPECT_TRUE(shifted.test(65));
+
+	mask.reset(64);
+	EXPECT_FALSE(mask.test(64));
+	EXPECT_EQ(mask.shifted(-64).count(), 1);
+	EXPECT_TRUE(mask.shifted(-64).test(122));
+}
+
+TEST(BattleHexMaskTest, AccessibleHexesMatchAccessible)
+{
+	AccessibilityInfo accessibility;
+	accessibility.fill(EAccessibility::ACCESSIBLE);
+
+	for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex += 7)
+		accessibility[hex] = EAccessibility::OBSTACLE;
+	accessibility[BattleHex::GATE_OUTER] = EAccessibility::GATE;
+
+	for(auto side : {BattleSide::ATTACKER, BattleSide::DEFENDER})
+	{
+		for(bool doubleWide : {false, true})
+		{
+			auto mask = accessibility.accessibleHexes(doubleWide, side);
+
+			for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+				EXPECT_EQ(mask.test(hex), accessibility.accessible(hex, doubleWide, side)) << "hex " << hex;
+		}
+	}
+}
@@ -10,6 +10,7 @@
 #include "StdInc.h"
 
 #include "../../lib/battle/CBattleInfoCallback.h"
+#include "../../lib/battle/CObstacleInstance.h"
 #include "../../lib/battle/CUnitState.h"
 
 #include <vstd/RNG.h>
@@ -157,6 +158,9 @@ public:
 		{
 		}
 
+		using CBattleInfoCallback::makeBFS;
+		using CBattleInfoCallback::getStoppers;
+
 		const IBattleInfo * getBattle() const override
 		{
 			return battle;
@@ -685,3 +689,160 @@ TEST_F(BattleMatchOwnerTest, hypnotizedToHypnotizedEnemy)
 	EXPECT_TRUE(subject.battleMatchOwner(&unit1, &unit2, boost::logic::indeterminate));
 	EXPECT_FALSE(subject.battleMatchOwner(&unit1, &unit2, false));
 }
+
+class ReachabilityTest : public CBattleInfoCallbackTest
+{
+public:
+	IBattleInfo::ObstacleCList obstacles;
+
+	void addStopper(CObstacleInstance::EObstacleType type, std::vector<BattleHex> hexes)
+	{
+		auto obstacle = std::make_shared<SpellCreatedObstacle>();
+		obstacle->obstacleType = type;
+		obstacle->trap = true;
+		obstacle->customSize = hexes;
+		obstacles.push_back(obstacle);
+	}
+
+	void setDefaultExpectations()
+	{
+		EXPECT_CALL(battleMock, getAllObstacles()).WillRepeatedly(Return(obstacles));
+		EXPECT_CALL(battleMock, getDefendedTown()).WillRepeatedly(Return(nullptr));
+		startBattle();
+	}
+
+	/// Siege layout without a town behind it, gate state is expressed through gate hexes and moat under the bridge
+	AccessibilityInfo makeSiegeAccessibility(bool gateClosed)
+	{
+		AccessibilityInfo ret;
+		ret.fill(EAccessibility::ACCESSIBLE);
+
+		for(int y = 0; y < GameConstants::BFIELD_HEIGHT; y++)
+		{
+			ret[BattleHex(0, y)] = EAccessibility::SIDE_COLUMN;
+			ret[BattleHex(GameConstants::BFIELD_WIDTH - 1, y)] = EAccessibility::SIDE_COLUMN;
+		}
+
+		for(auto hex : {12, 45, 62, 112, 147, 165})
+			ret[hex] = EAccessibility::UNAVAILABLE;
+
+		for(auto hex : {29, 78, 130, 182})
+			ret[hex] = EAccessibility::DESTRUCTIBLE_WALL;
+
+		for(auto hex : {40, 41, 57, 100, 118, 119, 150})
+			ret[hex] = EAccessibility::ALIVE_STACK;
+
+		for(auto hex : {52, 53, 86, 138})
+			ret[hex] = EAccessibility::OBSTACLE;
+
+		ret[BattleHex::GATE_OUTER] = ret[BattleHex::GATE_INNER] = gateClosed ? EAccessibility::GATE : EAccessibility::ACCESSIBLE;
+
+		std::vector<BattleHex> moat = {10, 27, 44, 61, 77, 111, 129, 146, 164, 181};
+		if(gateClosed)
+			moat.push_back(BattleHex::GATE_BRIDGE);
+
+		addStopper(CObstacleInstance::MOAT, moat);
+		addStopper(CObstacleInstance::SPELL_CREATED, {22, 23, 39, 73, 74, 125});
+
+		return ret;
+	}
+
+	/// Queue based search as it was done before bitboard layers
+	ReachabilityInfo::TDistances referenceDistances(const AccessibilityInfo & accessibility, const ReachabilityInfo::Parameters & params)
+	{
+		ReachabilityInfo::TDistances ret;
+		ret.fill(ReachabilityInfo::INFINITE_DIST);
+
+		auto stoppers = subject.getStoppers(params.perspective);
+
+		auto isInObstacle = [&](BattleHex hex)
+		{
+			for(auto occupied : battle::Unit::getHexes(hex, params.doubleWide, params.side))
+			{
+				if(vstd::contains(params.knownAccessible, occupied) || !vstd::contains(stoppers, occupied))
+					continue;
+
+				if(occupied != BattleHex::GATE_BRIDGE || (subject.battleGetGateState() != EGateState::DESTROYED && params.side == BattleSide::ATTACKER))
+					return true;
+			}
+			return false;
+		};
+
+		std::queue<BattleHex> hexq;
+		hexq.push(params.startPosition);
+		ret[params.startPosition] = 0;
+
+		while(!hexq.empty())
+		{
+			BattleHex curHex = hexq.front();
+			hexq.pop();
+
+			if(isInObstacle(curHex))
+				continue;
+
+			for(auto neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
+			{
+				if(neighbour.isValid() && accessibility.accessible(neighbour, params.doubleWide, params.side) && ret[curHex.hex] + 1 < ret[neighbour.hex])
+				{
+					ret[neighbour.hex] = ret[curHex.hex] + 1;
+					hexq.push(neighbour);
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	void checkAllStartPositions(const AccessibilityInfo & accessibility)
+	{
+		for(auto side : {BattleSide::ATTACKER, BattleSide::DEFENDER})
+		{
+			for(bool doubleWide : {false, true})
+			{
+				for(si16 start = 0; start < GameConstants::BFIELD_SIZE; start++)
+				{
+					ReachabilityInfo::Parameters params;
+					params.side = side;
+					params.doubleWide = doubleWide;
+					params.startPosition = start;
+					params.knownAccessible = battle::Unit::getHexes(start, doubleWide, side);
+
+					auto startAccessibility = accessibility;
+					for(auto hex : params.knownAccessible)
+						if(hex.isValid())
+							startAccessibility[hex] = EAccessibility::ACCESSIBLE;
+
+					auto result = subject.makeBFS(startAccessibility, params);
+					auto expected = referenceDistances(startAccessibility, params);
+
+					for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+					{
+						ASSERT_EQ(result.distances[hex], expected[hex]) << "start " << start << " hex " << hex << " doubleWide " << doubleWide;
+
+						if(hex != start && result.distances[hex] != ReachabilityInfo::INFINITE_DIST)
+						{
+							BattleHex predecessor = result.predecessors[hex];
+							ASSERT_TRUE(predecessor.isValid());
+							EXPECT_EQ(result.distances[predecessor.hex] + 1, result.distances[hex]);
+							EXPECT_EQ(BattleHex::getDistance(predecessor, hex), 1);
+						}
+					}
+				}
+			}
+		}
+	}
+};
+
+TEST_F(ReachabilityTest, LayeredSearchMatchesQueueSearchWithClosedGate)
+{
+	auto accessibility = makeSiegeAccessibility(true);
+	setDefaultExpectations();
+	checkAllStartPositions(accessibility);
+}
+
+TEST_F(ReachabilityTest, LayeredSearchMatchesQueueSearchWithDestroyedGate)
+{
+	auto accessibility = makeSiegeAccessibility(false);
+	setDefaultExpectations();
+	checkAllStartPositions(accessibility);
+}
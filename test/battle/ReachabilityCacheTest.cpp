@@ -0,0 +1,80 @@
+/*
+ * ReachabilityCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/battle/ReachabilityCache.h"
+
+namespace
+{
+ReachabilityInfo makeReachability(const ReachabilityInfo::Parameters & params, uint32_t distance)
+{
+	ReachabilityInfo ret;
+	ret.params = params;
+	ret.distances.fill(distance);
+	return ret;
+}
+}
+
+TEST(ReachabilityCacheTest, StoresEntryPerParametersAndViewer)
+{
+	ReachabilityCache cache;
+
+	ReachabilityInfo::Parameters params;
+	params.side = BattleSide::ATTACKER;
+	params.startPosition = BattleHex(30);
+	params.knownAccessible = {BattleHex(30)};
+
+	cache.setReachability(BattleSide::ALL_KNOWING, params, makeReachability(params, 5), cache.getStateVersion());
+
+	auto cached = cache.getReachability(BattleSide::ALL_KNOWING, params);
+	ASSERT_TRUE(cached.has_value());
+	EXPECT_EQ(cached->distances[0], 5);
+
+	EXPECT_FALSE(cache.getReachability(BattleSide::DEFENDER, params).has_value());
+
+	auto moved = params;
+	moved.startPosition = BattleHex(31);
+	moved.knownAccessible = {BattleHex(31)};
+	EXPECT_FALSE(cache.getReachability(BattleSide::ALL_KNOWING, moved).has_value());
+}
+
+TEST(ReachabilityCacheTest, SkipsEnemyBypassQueries)
+{
+	ReachabilityCache cache;
+
+	ReachabilityInfo::Parameters params;
+	params.bypassEnemyStacks = true;
+	params.destructibleEnemyTurns[BattleHex(40)] = 1;
+
+	EXPECT_FALSE(ReachabilityCache::isCacheable(params));
+
+	cache.setReachability(BattleSide::ALL_KNOWING, params, makeReachability(params, 5), cache.getStateVersion());
+	EXPECT_FALSE(cache.getReachability(BattleSide::ALL_KNOWING, params).has_value());
+}
+
+TEST(ReachabilityCacheTest, InvalidateDropsEntriesAndStaleStores)
+{
+	ReachabilityCache cache;
+
+	AccessibilityInfo accessibility;
+	accessibility.fill(EAccessibility::ACCESSIBLE);
+
+	auto version = cache.getStateVersion();
+	cache.setAccessibility(BattleSide::ALL_KNOWING, accessibility, version);
+	EXPECT_TRUE(cache.getAccessibility(BattleSide::ALL_KNOWING).has_value());
+
+	cache.invalidate();
+	EXPECT_NE(cache.getStateVersion(), version);
+	EXPECT_FALSE(cache.getAccessibility(BattleSide::ALL_KNOWING).has_value());
+
+	// value computed before invalidation must not be stored
+	cache.setAccessibility(BattleSide::ALL_KNOWING, accessibility, version);
+	EXPECT_FALSE(cache.getAccessibility(BattleSide::ALL_KNOWING).has_value());
+}
@@ -0,0 +1,165 @@
+/*
+ * HypotheticBattleTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../AI/BattleAI/StackWithBonuses.h"
+
+#include "../mock/BattleFake.h"
+#include "../mock/mock_Environment.h"
+#include "../mock/mock_UnitEnvironment.h"
+
+namespace test
+{
+using namespace ::testing;
+
+class HypotheticBattleSubject : public battle::BattleFake
+{
+public:
+#if SCRIPTING_ENABLED
+	HypotheticBattleSubject()
+		: BattleFake(std::make_shared<scripting::PoolMock>())
+	{
+	}
+#endif
+
+	const IBattleInfo * getBattle() const override
+	{
+		return this;
+	}
+};
+
+class HypotheticBattleTest : public Test
+{
+public:
+	static constexpr uint32_t FIRST_UNIT = 1;
+	static constexpr uint32_t SECOND_UNIT = 2;
+
+	EnvironmentMock environmentMock;
+	UnitEnvironmentMock unitEnvironmentMock;
+	battle::UnitsFake unitsFake;
+	std::shared_ptr<HypotheticBattleSubject> subject;
+	std::vector<std::shared_ptr<::battle::CUnitState>> unitStates;
+
+protected:
+	void SetUp() override
+	{
+		subject = std::make_shared<HypotheticBattleSubject>();
+
+		ON_CALL(*subject, getUnitsIf(_)).WillByDefault(Invoke(&unitsFake, &battle::UnitsFake::getUnitsIf));
+		EXPECT_CALL(*subject, getActiveStackID()).WillRepeatedly(Return(-1));
+
+		addUnit(FIRST_UNIT, BattleSide::ATTACKER, BattleHex(20));
+		addUnit(SECOND_UNIT, BattleSide::DEFENDER, BattleHex(30));
+
+		unitsFake.setDefaultBonusExpectations();
+	}
+
+	void addUnit(uint32_t id, BattleSide side, BattleHex position)
+	{
+		auto & unit = unitsFake.add(side);
+
+		unit.addNewBonus(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::STACK_HEALTH, BonusSource::CREATURE_ABILITY, 10, BonusSourceID()));
+		EXPECT_CALL(unit, unitId()).WillRepeatedly(Return(id));
+		EXPECT_CALL(unit, unitBaseAmount()).WillRepeatedly(Return(5));
+		EXPECT_CALL(unit, unitType()).WillRepeatedly(Return(nullptr));
+		EXPECT_CALL(unit, unitOwner()).WillRepeatedly(Return(PlayerColor(static_cast<int>(side))));
+		EXPECT_CALL(unit, unitSlot()).WillRepeatedly(Return(SlotID(0)));
+		EXPECT_CALL(unit, getPosition()).WillRepeatedly(Return(position));
+
+		auto state = std::make_shared<::battle::CUnitStateDetached>(&unit, &unit);
+		state->localInit(&unitEnvironmentMock);
+		state->position = position;
+		unitStates.push_back(state);
+
+		EXPECT_CALL(unit, acquireState()).WillRepeatedly(Return(state));
+	}
+
+	static BattleHex positionOf(const HypotheticBattle & battle, uint32_t id)
+	{
+		return battle.battleGetUnitByID(id)->getPosition();
+	}
+};
+
+TEST_F(HypotheticBattleTest, ForkSeesChangesMadeBeforeFork)
+{
+	auto parent = std::make_shared<HypotheticBattle>(&environmentMock, subject);
+	parent->moveUnit(FIRST_UNIT, BattleHex(21));
+
+	auto child = std::make_shared<HypotheticBattle>(&environmentMock, parent);
+
+	EXPECT_EQ(positionOf(*child, FIRST_UNIT), BattleHex(21));
+	EXPECT_EQ(positionOf(*child, SECOND_UNIT), BattleHex(30));
+}
+
+TEST_F(HypotheticBattleTest, ParentAndForkChangesAreIsolated)
+{
+	auto parent = std::make_shared<HypotheticBattle>(&environmentMock, subject);
+	parent->moveUnit(FIRST_UNIT, BattleHex(21));
+	parent->moveUnit(SECOND_UNIT, BattleHex(31));
+
+	auto child = std::make_shared<HypotheticBattle>(&environmentMock, parent);
+	auto grandChild = std::make_shared<HypotheticBattle>(&environmentMock, child);
+
+	// unit state owned by parent is shared with forks at this point
+	parent->moveUnit(FIRST_UNIT, BattleHex(22));
+	child->moveUnit(SECOND_UNIT, BattleHex(32));
+	grandChild->moveUnit(FIRST_UNIT, BattleHex(23));
+
+	EXPECT_EQ(positionOf(*parent, FIRST_UNIT), BattleHex(22));
+	EXPECT_EQ(positionOf(*parent, SECOND_UNIT), BattleHex(31));
+
+	EXPECT_EQ(positionOf(*child, FIRST_UNIT), BattleHex(21));
+	EXPECT_EQ(positionOf(*child, SECOND_UNIT), BattleHex(32));
+
+	EXPECT_EQ(positionOf(*grandChild, FIRST_UNIT), BattleHex(23));
+	EXPECT_EQ(positionOf(*grandChild, SECOND_UNIT), BattleHex(31));
+
+	EXPECT_EQ(subject->battleGetUnitByID(FIRST_UNIT)->getPosition(), BattleHex(20));
+}
+
+TEST_F(HypotheticBattleTest, StateIsCopiedOnlyOnceAfterFork)
+{
+	auto parent = std::make_shared<HypotheticBattle>(&environmentMock, subject);
+	parent->moveUnit(FIRST_UNIT, BattleHex(21));
+
+	auto child = std::make_shared<HypotheticBattle>(&environmentMock, parent);
+
+	auto copied = parent->getForUpdate(FIRST_UNIT);
+	EXPECT_EQ(parent->getForUpdate(FIRST_UNIT), copied);
+
+	auto childCopy = child->getForUpdate(FIRST_UNIT);
+	EXPECT_NE(childCopy, copied);
+	EXPECT_EQ(child->getForUpdate(FIRST_UNIT), childCopy);
+}
+
+TEST_F(HypotheticBattleTest, ForkSharesReachabilityCacheUntilUnitsChange)
+{
+	auto parent = std::make_shared<HypotheticBattle>(&environmentMock, subject);
+	parent->moveUnit(FIRST_UNIT, BattleHex(21));
+
+	auto * parentCache = parent->getReachabilityCache();
+	ASSERT_NE(parentCache, nullptr);
+	EXPECT_EQ(parent->getReachabilityCache(), parentCache);
+
+	auto child = std::make_shared<HypotheticBattle>(&environmentMock, parent);
+	EXPECT_EQ(child->getReachabilityCache(), parentCache);
+
+	child->moveUnit(SECOND_UNIT, BattleHex(31));
+	auto * childCache = child->getReachabilityCache();
+	EXPECT_NE(childCache, parentCache);
+	EXPECT_EQ(parent->getReachabilityCache(), parentCache);
+
+	// state changed directly, without going through battle methods
+	child->getForUpdate(FIRST_UNIT)->position = BattleHex(22);
+	EXPECT_NE(child->getReachabilityCache(), childCache);
+	EXPECT_EQ(parent->getReachabilityCache(), parentCache);
+}
+
+}
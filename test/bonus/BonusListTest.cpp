@@ -0,0 +1,153 @@
+/*
+ * BonusListTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/BonusList.h"
+
+using namespace testing;
+
+namespace
+{
+BonusList makeBonuses()
+{
+	const std::vector<BonusValueType> valTypes = {
+		BonusValueType::ADDITIVE_VALUE,
+		BonusValueType::BASE_NUMBER,
+		BonusValueType::PERCENT_TO_ALL,
+		BonusValueType::PERCENT_TO_BASE,
+		BonusValueType::PERCENT_TO_SOURCE,
+		BonusValueType::PERCENT_TO_TARGET_TYPE,
+		BonusValueType::INDEPENDENT_MAX,
+		BonusValueType::INDEPENDENT_MIN,
+	};
+
+	BonusList bonuses;
+	for(int i = 0; i < 150; i++)
+	{
+		auto type = i % 3 ? BonusType::PRIMARY_SKILL : BonusType::LUCK;
+		auto source = i % 5 ? BonusSource::ARTIFACT : BonusSource::SPELL_EFFECT;
+		auto subtype = BonusSubtypeID(PrimarySkill(i % 4));
+		auto duration = i % 2 ? BonusDuration::PERMANENT : BonusDuration::N_TURNS;
+		auto bonus = std::make_shared<Bonus>(duration, type, source, i % 20 - 5, BonusSourceID(ArtifactID(i % 7)), subtype, valTypes[i % 11 % valTypes.size()]);
+		bonus->turnsRemain = i % 6;
+		bonus->targetSourceType = i % 4 ? BonusSource::ARTIFACT : BonusSource::SPELL_EFFECT;
+		bonuses.push_back(bonus);
+	}
+	return bonuses;
+}
+
+std::vector<CSelector> fieldSelectors()
+{
+	return {
+		Selector::all,
+		Selector::none,
+		Selector::type()(BonusType::LUCK),
+		Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::KNOWLEDGE)),
+		Selector::source(BonusSource::ARTIFACT, BonusSourceID(ArtifactID(3))),
+		Selector::sourceTypeSel(BonusSource::SPELL_EFFECT).And(Selector::valueType(BonusValueType::ADDITIVE_VALUE)),
+		Selector::type()(BonusType::LUCK).And(Selector::turns(2)),
+		Selector::turns(3).And(Selector::turns(1)),
+		Selector::turns(0),
+	};
+}
+}
+
+TEST(BonusListTest, TotalValueAppliesValueTypes)
+{
+	BonusList bonuses;
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::ARTIFACT, 10, BonusSourceID(), BonusSubtypeID(), BonusValueType::BASE_NUMBER));
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::ARTIFACT, 100, BonusSourceID(), BonusSubtypeID(), BonusValueType::PERCENT_TO_SOURCE));
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::SPELL_EFFECT, 5, BonusSourceID(), BonusSubtypeID(), BonusValueType::ADDITIVE_VALUE));
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::SPELL_EFFECT, 50, BonusSourceID(), BonusSubtypeID(), BonusValueType::PERCENT_TO_BASE));
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::SPELL_EFFECT, 10, BonusSourceID(), BonusSubtypeID(), BonusValueType::PERCENT_TO_ALL));
+
+	// ((10 * 200%) * 150% + 5) * 110%
+	EXPECT_EQ(bonuses.totalValue(), 38);
+
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::MORALE, BonusSource::SPELL_EFFECT, 30, BonusSourceID(), BonusSubtypeID(), BonusValueType::INDEPENDENT_MIN));
+	EXPECT_EQ(bonuses.totalValue(), 30);
+	EXPECT_EQ(bonuses.valOfBonuses(Selector::type()(BonusType::LUCK)), 38);
+	EXPECT_EQ(bonuses.valOfBonuses(Selector::type()(BonusType::MORALE)), 30);
+	EXPECT_EQ(bonuses.valOfBonuses(Selector::none), 0);
+
+	PackedBonusList packed;
+	packed.build(bonuses);
+
+	std::vector<uint8_t> mask;
+	packed.filter(mask, BonusFieldSelector(BonusType::LUCK));
+	EXPECT_EQ(packed.totalValue(mask), 38);
+	packed.filter(mask, BonusFieldSelector());
+	EXPECT_EQ(packed.totalValue(mask), 30);
+}
+
+TEST(BonusListTest, TurnsSelectorKeepsBonusesLastingLonger)
+{
+	BonusList bonuses;
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::N_TURNS, BonusType::STACKS_SPEED, BonusSource::SPELL_EFFECT, 1, BonusSourceID()));
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::N_TURNS, BonusType::STACKS_SPEED, BonusSource::SPELL_EFFECT, 10, BonusSourceID()));
+	bonuses.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::STACKS_SPEED, BonusSource::CREATURE_ABILITY, 100, BonusSourceID()));
+	bonuses[0]->turnsRemain = 1;
+	bonuses[1]->turnsRemain = 3;
+
+	const auto speed = Selector::type()(BonusType::STACKS_SPEED);
+	EXPECT_EQ(bonuses.valOfBonuses(speed.And(Selector::turns(0))), 111);
+	EXPECT_EQ(bonuses.valOfBonuses(speed.And(Selector::turns(1))), 110);
+	EXPECT_EQ(bonuses.valOfBonuses(speed.And(Selector::turns(3))), 100);
+
+	PackedBonusList packed;
+	packed.build(bonuses);
+
+	std::vector<uint8_t> mask;
+	packed.filter(mask, *speed.And(Selector::turns(2)).getFieldSelector());
+	EXPECT_EQ(mask, std::vector<uint8_t>({0, 1, 1}));
+	EXPECT_EQ(packed.totalValue(mask), 110);
+}
+
+TEST(BonusListTest, PackedTotalValueMatchesSelectedList)
+{
+	BonusList bonuses = makeBonuses();
+
+	PackedBonusList packed;
+	packed.build(bonuses);
+
+	for(const auto & selector : fieldSelectors())
+	{
+		BonusList selected;
+		bonuses.getBonuses(selected, selector);
+
+		std::vector<uint8_t> mask;
+		packed.filter(mask, *selector.getFieldSelector());
+
+		EXPECT_EQ(packed.totalValue(mask), selected.totalValue());
+		EXPECT_EQ(bonuses.valOfBonuses(selector), selected.totalValue());
+	}
+}
+
+TEST(BonusListTest, PackedSelectionMatchesSelector)
+{
+	BonusList bonuses = makeBonuses();
+
+	PackedBonusList packed;
+	packed.build(bonuses);
+
+	for(const auto & selector : fieldSelectors())
+	{
+		ASSERT_NE(selector.getFieldSelector(), nullptr);
+
+		BonusList expected;
+		BonusList actual;
+		bonuses.getBonuses(expected, selector);
+		packed.getBonuses(actual, bonuses, *selector.getFieldSelector());
+
+		ASSERT_EQ(actual.size(), expected.size());
+		for(size_t i = 0; i < expected.size(); i++)
+			EXPECT_EQ(actual[i], expected[i]);
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ * BonusQueryCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/BonusQueryCache.h"
+#include "../../lib/bonuses/BonusList.h"
+
+using namespace testing;
+
+TEST(BonusQueryCacheTest, TypedKeysAreDistinct)
+{
+	auto luck = BonusCacheKey::type(BonusType::LUCK);
+	auto morale = BonusCacheKey::type(BonusType::MORALE);
+	auto skill = BonusCacheKey::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::ATTACK));
+	auto otherSkill = BonusCacheKey::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::DEFENSE));
+	auto baseSkill = BonusCacheKey::typeSubtypeSource(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::ATTACK), BonusSource::HERO_BASE_SKILL);
+
+	EXPECT_TRUE(luck.isCacheable());
+	EXPECT_EQ(luck, BonusCacheKey::type(BonusType::LUCK));
+	EXPECT_FALSE(luck == morale);
+	EXPECT_FALSE(skill == otherSkill);
+	EXPECT_FALSE(skill == baseSkill);
+	EXPECT_FALSE(luck == BonusCacheKey("type_LUCK"));
+}
+
+TEST(BonusQueryCacheTest, ArgumentKeysAreDistinct)
+{
+	auto immunity = BonusCacheKey::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(SpellID(SpellID::BLESS)), 1);
+	auto otherSpellImmunity = BonusCacheKey::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(SpellID(SpellID::CURSE)), 1);
+	auto levelImmunity = BonusCacheKey::typeInfo(BonusType::LEVEL_SPELL_IMMUNITY, 1);
+	auto bless = BonusCacheKey::source(BonusSource::SPELL_EFFECT, BonusSourceID(SpellID(SpellID::BLESS)));
+	auto curse = BonusCacheKey::source(BonusSource::SPELL_EFFECT, BonusSourceID(SpellID(SpellID::CURSE)));
+
+	EXPECT_EQ(immunity, BonusCacheKey::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(SpellID(SpellID::BLESS)), 1));
+	EXPECT_FALSE(immunity == otherSpellImmunity);
+	EXPECT_FALSE(immunity == BonusCacheKey::typeSubtypeInfo(BonusType::SPELL_IMMUNITY, BonusSubtypeID(SpellID(SpellID::BLESS)), 0));
+	EXPECT_FALSE(immunity == BonusCacheKey::typeSubtype(BonusType::SPELL_IMMUNITY, BonusSubtypeID(SpellID(SpellID::BLESS))));
+	EXPECT_FALSE(levelImmunity == BonusCacheKey::type(BonusType::LEVEL_SPELL_IMMUNITY));
+	EXPECT_FALSE(bless == curse);
+
+	BonusQueryCache cache;
+	auto blessBonuses = std::make_shared<BonusList>();
+	cache.insert(bless, blessBonuses);
+
+	EXPECT_EQ(cache.find(bless), blessBonuses);
+	EXPECT_EQ(cache.find(curse), nullptr);
+}
+
+TEST(BonusQueryCacheTest, EmptyKeyIsNotCacheable)
+{
+	EXPECT_FALSE(BonusCacheKey().isCacheable());
+	EXPECT_FALSE(BonusCacheKey("").isCacheable());
+	EXPECT_FALSE(BonusCacheKey(std::string()).isCacheable());
+}
+
+TEST(BonusQueryCacheTest, FindReturnsInsertedResults)
+{
+	BonusQueryCache cache;
+	std::vector<TBonusListPtr> lists;
+
+	for(int i = 0; i < 100; i++)
+	{
+		lists.push_back(std::make_shared<BonusList>());
+		cache.insert(BonusCacheKey("query_" + std::to_string(i)), lists.back());
+	}
+	auto typed = std::make_shared<BonusList>();
+	cache.insert(BonusCacheKey::type(BonusType::LUCK), typed);
+
+	EXPECT_EQ(cache.size(), 101);
+	for(int i = 0; i < 100; i++)
+		EXPECT_EQ(cache.find(BonusCacheKey("query_" + std::to_string(i))), lists[i]);
+	EXPECT_EQ(cache.find(BonusCacheKey::type(BonusType::LUCK)), typed);
+	EXPECT_EQ(cache.find(BonusCacheKey::type(BonusType::MORALE)), nullptr);
+
+	cache.clear();
+
+	EXPECT_EQ(cache.size(), 0);
+	EXPECT_EQ(cache.find(BonusCacheKey::type(BonusType::LUCK)), nullptr);
+	EXPECT_EQ(cache.find(BonusCacheKey("query_0")), nullptr);
+}
@@ -0,0 +1,67 @@
+/*
+ * BonusSelectorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/BonusSelector.h"
+
+using namespace testing;
+
+class BonusSelectorTest : public Test
+{
+public:
+	Bonus luck;
+	Bonus attack;
+
+	BonusSelectorTest()
+		: luck(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::ARTIFACT, 1, BonusSourceID(ArtifactID(5)))
+		, attack(BonusDuration::PERMANENT, BonusType::PRIMARY_SKILL, BonusSource::HERO_BASE_SKILL, 2, BonusSourceID(), BonusSubtypeID(PrimarySkill::ATTACK))
+	{
+	}
+};
+
+TEST_F(BonusSelectorTest, CommonSelectorsAreData)
+{
+	auto selector = Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::ATTACK)).And(Selector::sourceType()(BonusSource::HERO_BASE_SKILL));
+
+	ASSERT_NE(selector.getFieldSelector(), nullptr);
+	EXPECT_TRUE(selector(&attack));
+	EXPECT_FALSE(selector(&luck));
+
+	EXPECT_NE(Selector::type()(BonusType::LUCK).getFieldSelector(), nullptr);
+	EXPECT_NE(Selector::source(BonusSource::ARTIFACT, BonusSourceID(ArtifactID(5))).getFieldSelector(), nullptr);
+	EXPECT_NE(Selector::all.And(Selector::valueType(BonusValueType::ADDITIVE_VALUE)).getFieldSelector(), nullptr);
+}
+
+TEST_F(BonusSelectorTest, SourceIdIsCompared)
+{
+	EXPECT_TRUE(Selector::source(BonusSource::ARTIFACT, BonusSourceID(ArtifactID(5)))(&luck));
+	EXPECT_FALSE(Selector::source(BonusSource::ARTIFACT, BonusSourceID(ArtifactID(6)))(&luck));
+}
+
+TEST_F(BonusSelectorTest, ConflictingFieldsSelectNothing)
+{
+	auto selector = Selector::type()(BonusType::LUCK).And(Selector::type()(BonusType::PRIMARY_SKILL));
+
+	EXPECT_FALSE(selector(&luck));
+	EXPECT_FALSE(selector(&attack));
+	EXPECT_TRUE(selector.Or(Selector::type()(BonusType::LUCK))(&luck));
+}
+
+TEST_F(BonusSelectorTest, ErasedSelectorsAreCombined)
+{
+	auto positive = CSelector([](const Bonus * b){ return b->val > 1; });
+
+	EXPECT_EQ(positive.getFieldSelector(), nullptr);
+	EXPECT_TRUE(Selector::all.And(positive)(&attack));
+	EXPECT_FALSE(Selector::type()(BonusType::PRIMARY_SKILL).And(positive)(&luck));
+	EXPECT_TRUE(Selector::type()(BonusType::LUCK).Or(positive)(&luck));
+	EXPECT_TRUE(Selector::type()(BonusType::LUCK).Not()(&attack));
+	EXPECT_FALSE(Selector::none(&luck));
+}
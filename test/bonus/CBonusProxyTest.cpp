@@ -0,0 +1,100 @@
+/*
+ * CBonusProxyTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/CBonusProxy.h"
+#include "../../lib/bonuses/CBonusSystemNode.h"
+
+using namespace testing;
+
+class CBonusProxyTest : public Test
+{
+public:
+	CBonusSystemNode hero;
+	CBonusSystemNode stack;
+
+	CBonusProxyTest()
+		: hero(CBonusSystemNode::HERO)
+		, stack(CBonusSystemNode::STACK_BATTLE)
+	{
+		stack.attachTo(hero);
+	}
+
+	static std::shared_ptr<Bonus> makeBonus(BonusType type, int val, BonusLimitEffect range = BonusLimitEffect::NO_LIMIT)
+	{
+		auto ret = std::make_shared<Bonus>(BonusDuration::PERMANENT, type, BonusSource::OTHER, val, BonusSourceID());
+		ret->effectRange = range;
+		return ret;
+	}
+};
+
+TEST_F(CBonusProxyTest, ValuesFollowTreeChanges)
+{
+	CTotalsProxy attack(&stack, Selector::type()(BonusType::PRIMARY_SKILL), 3);
+	CCheckProxy shooter(&stack, Selector::type()(BonusType::SHOOTER));
+
+	EXPECT_EQ(attack.getValue(), 3);
+	EXPECT_FALSE(shooter.getHasBonus());
+
+	hero.addNewBonus(makeBonus(BonusType::PRIMARY_SKILL, 2));
+	stack.addNewBonus(makeBonus(BonusType::PRIMARY_SKILL, 4, BonusLimitEffect::ONLY_MELEE_FIGHT));
+	stack.addNewBonus(makeBonus(BonusType::SHOOTER, 0));
+
+	EXPECT_EQ(attack.getValue(), 9);
+	EXPECT_EQ(attack.getMeleeValue(), 9);
+	EXPECT_EQ(attack.getRangedValue(), 5);
+	EXPECT_TRUE(shooter.getHasBonus());
+}
+
+// Same unit is read by several AI threads at once, every thread must see values of current tree version
+TEST_F(CBonusProxyTest, ConcurrentReadsSeeCurrentValues)
+{
+	CTotalsProxy attack(&stack, Selector::type()(BonusType::PRIMARY_SKILL), 0);
+	CCheckProxy shooter(&stack, Selector::type()(BonusType::SHOOTER));
+
+	const int threadsCount = 4;
+	const int readsCount = 200;
+
+	for(int round = 1; round <= 20; round++)
+	{
+		hero.addNewBonus(makeBonus(BonusType::PRIMARY_SKILL, round));
+		if(round % 2)
+			stack.addNewBonus(makeBonus(BonusType::PRIMARY_SKILL, 1, BonusLimitEffect::ONLY_DISTANCE_FIGHT));
+		if(round == 10)
+			stack.addNewBonus(makeBonus(BonusType::SHOOTER, 0));
+
+		const int expectedValue = stack.valOfBonuses(Selector::type()(BonusType::PRIMARY_SKILL));
+		const int expectedMelee = stack.valOfBonuses(Selector::type()(BonusType::PRIMARY_SKILL).And(Selector::effectRange()(BonusLimitEffect::NO_LIMIT)));
+		const bool expectedShooter = round >= 10;
+
+		std::atomic<int> mismatches(0);
+		std::vector<boost::thread> threads;
+
+		for(int i = 0; i < threadsCount; i++)
+		{
+			threads.emplace_back([&]()
+			{
+				for(int read = 0; read < readsCount; read++)
+				{
+					if(attack.getValue() != expectedValue
+						|| attack.getMeleeValue() != expectedMelee
+						|| attack.getRangedValue() != expectedValue
+						|| shooter.getHasBonus() != expectedShooter)
+						mismatches++;
+				}
+			});
+		}
+
+		for(auto & thread : threads)
+			thread.join();
+
+		EXPECT_EQ(mismatches, 0) << "round " << round;
+	}
+}
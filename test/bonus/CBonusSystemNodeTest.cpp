@@ -0,0 +1,95 @@
+/*
+ * CBonusSystemNodeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/CBonusSystemNode.h"
+#include "../../lib/bonuses/Bonus.h"
+
+using namespace testing;
+
+class CBonusSystemNodeTest : public Test
+{
+public:
+	CBonusSystemNode player;
+	CBonusSystemNode hero;
+	CBonusSystemNode otherHero;
+	CBonusSystemNode stack;
+
+	CBonusSystemNodeTest()
+		: player(CBonusSystemNode::PLAYER)
+		, hero(CBonusSystemNode::HERO)
+		, otherHero(CBonusSystemNode::HERO)
+		, stack(CBonusSystemNode::STACK_INSTANCE)
+	{
+		hero.attachTo(player);
+		otherHero.attachTo(player);
+		stack.attachTo(hero);
+	}
+
+	static std::shared_ptr<Bonus> makeBonus(BonusType type, int val)
+	{
+		return std::make_shared<Bonus>(BonusDuration::PERMANENT, type, BonusSource::OTHER, val, BonusSourceID());
+	}
+};
+
+TEST_F(CBonusSystemNodeTest, ChangeInvalidatesOnlyDescendants)
+{
+	auto playerVersion = player.getTreeVersion();
+	auto heroVersion = hero.getTreeVersion();
+	auto otherHeroVersion = otherHero.getTreeVersion();
+	auto stackVersion = stack.getTreeVersion();
+
+	hero.addNewBonus(makeBonus(BonusType::MORALE, 1));
+
+	EXPECT_EQ(player.getTreeVersion(), playerVersion);
+	EXPECT_EQ(otherHero.getTreeVersion(), otherHeroVersion);
+	EXPECT_NE(hero.getTreeVersion(), heroVersion);
+	EXPECT_NE(stack.getTreeVersion(), stackVersion);
+}
+
+TEST_F(CBonusSystemNodeTest, ParentChangeIsVisibleInCachedResults)
+{
+	auto selector = Selector::type()(BonusType::LUCK);
+	const std::string cachingStr = "type_LUCK";
+
+	EXPECT_EQ(stack.valOfBonuses(selector, cachingStr), 0);
+	EXPECT_EQ(otherHero.valOfBonuses(selector, cachingStr), 0);
+
+	player.addNewBonus(makeBonus(BonusType::LUCK, 2));
+
+	EXPECT_EQ(stack.valOfBonuses(selector, cachingStr), 2);
+	EXPECT_EQ(otherHero.valOfBonuses(selector, cachingStr), 2);
+
+	stack.addNewBonus(makeBonus(BonusType::LUCK, 1));
+
+	EXPECT_EQ(stack.valOfBonuses(selector, cachingStr), 3);
+	EXPECT_EQ(hero.valOfBonuses(selector, cachingStr), 2);
+}
+
+TEST_F(CBonusSystemNodeTest, GlobalChangeInvalidatesAllNodes)
+{
+	auto playerVersion = player.getTreeVersion();
+	auto stackVersion = stack.getTreeVersion();
+
+	CBonusSystemNode::treeHasChanged();
+
+	EXPECT_NE(player.getTreeVersion(), playerVersion);
+	EXPECT_NE(stack.getTreeVersion(), stackVersion);
+}
+
+TEST_F(CBonusSystemNodeTest, DetachInvalidatesFormerChild)
+{
+	player.addNewBonus(makeBonus(BonusType::LUCK, 2));
+	EXPECT_EQ(stack.valOfBonuses(Selector::type()(BonusType::LUCK), "type_LUCK"), 2);
+
+	stack.detachFrom(hero);
+
+	EXPECT_EQ(stack.valOfBonuses(Selector::type()(BonusType::LUCK), "type_LUCK"), 0);
+}
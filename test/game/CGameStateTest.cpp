@@ -25,11 +25,20 @@
 
 #include "../../lib/battle/BattleInfo.h"
 #include "../../lib/battle/BattleLayout.h"
+#include "../../lib/battle/CObstacleInstance.h"
+#include "../../lib/CPlayerState.h"
 #include "../../lib/CStack.h"
+#include "../../lib/VCMI_Lib.h"
 
 #include "../../lib/filesystem/ResourcePath.h"
 
 #include "../../lib/mapping/CMap.h"
+#include "../../lib/mapObjectConstructors/AObjectTypeHandler.h"
+#include "../../lib/mapObjectConstructors/CObjectClassesHandler.h"
+#include "../../lib/mapObjects/CGCreature.h"
+#include "../../lib/mapObjects/CGHeroInstance.h"
+#include "../../lib/pathfinder/CGPathNode.h"
+#include "../../lib/pathfinder/PathfinderAccessibility.h"
 
 #include "../../lib/spells/CSpellHandler.h"
 #include "../../lib/spells/ISpellMechanics.h"
@@ -211,6 +220,87 @@ public:
 		ASSERT_EQ(gameState->currentBattles.size(), 1);
 	}
 
+	//same as CGameHandler::createNewObject followed by CGameHandler::newObject
+	CGObjectInstance * addObject(const int3 & visitablePosition, MapObjectID objectID, MapObjectSubID subID, const std::function<void(CGObjectInstance *)> & configure = nullptr)
+	{
+		auto handler = VLC->objtypeh->getHandlerFor(objectID, subID);
+		auto terrain = gameState->map->getTile(visitablePosition).getTerrainID();
+
+		CGObjectInstance * object = handler->create(gameState->callback, nullptr);
+		handler->configureObject(object, gameState->getRandomGenerator());
+		object->appearance = handler->getTemplates(terrain).front();
+		object->setAnchorPos(visitablePosition + object->getVisitableOffset());
+
+		if(configure)
+			configure(object);
+
+		object->initObj(gameState->getRandomGenerator());
+
+		NewObject pack;
+		pack.newObject = object;
+		pack.initiator = PlayerColor::NEUTRAL;
+		gameCallback->sendAndApply(pack);
+
+		return object;
+	}
+
+	CGObjectInstance * addMonster(const int3 & visitablePosition, CreatureID creature)
+	{
+		return addObject(visitablePosition, Obj::MONSTER, creature, [creature](CGObjectInstance * object)
+		{
+			auto * monster = dynamic_cast<CGCreature *>(object);
+			monster->character = 2;
+			monster->addToSlot(SlotID(0), new CStackInstance(creature, -1));
+		});
+	}
+
+	//compares results of search in reused or repaired nodes with search from scratch
+	static void expectSamePaths(const CPathsInfo & actual, const CPathsInfo & expected, const std::string & context)
+	{
+		const auto nodeIndex = [](const CPathsInfo & paths, const CGPathNode * node) -> std::ptrdiff_t
+		{
+			return node ? node - paths.nodes.data() : -1;
+		};
+
+		ASSERT_EQ(actual.nodes.num_elements(), expected.nodes.num_elements());
+
+		for(size_t i = 0; i < expected.nodes.num_elements(); i++)
+		{
+			const CGPathNode & actualNode = actual.nodes.data()[i];
+			const CGPathNode & expectedNode = expected.nodes.data()[i];
+
+			if(expectedNode.layer == EPathfindingLayer::WRONG)
+				continue;
+
+			const std::string where = context + ", " + expectedNode.coord.toString() + ", layer " + std::to_string(expectedNode.layer.getNum());
+
+			EXPECT_TRUE(actualNode.accessible == expectedNode.accessible) << where;
+			EXPECT_EQ(actualNode.turns, expectedNode.turns) << where;
+			EXPECT_EQ(actualNode.moveRemains, expectedNode.moveRemains) << where;
+			EXPECT_TRUE(actualNode.action == expectedNode.action) << where;
+
+			if(expectedNode.turns == 255)
+				continue;
+
+			EXPECT_NEAR(actualNode.getCost(), expectedNode.getCost(), 1e-4) << where;
+
+			// paths of equal cost are allowed to go through different predecessor
+			const CGPathNode * actualBefore = actualNode.theNodeBefore;
+			const CGPathNode * expectedBefore = expectedNode.theNodeBefore;
+
+			if(nodeIndex(actual, actualBefore) == nodeIndex(expected, expectedBefore))
+				continue;
+
+			ASSERT_NE(actualBefore, nullptr) << where;
+			ASSERT_NE(expectedBefore, nullptr) << where;
+
+			const CGPathNode & sameTileExpected = expected.nodes.data()[nodeIndex(actual, actualBefore)];
+			EXPECT_NEAR(actualBefore->getCost(), sameTileExpected.getCost(), 1e-4) << where;
+			EXPECT_LE(actualBefore->getCost(), actualNode.getCost()) << where;
+			EXPECT_LE(actualBefore->coord.chebdist2d(actualNode.coord), 1) << where;
+		}
+	}
+
 	std::shared_ptr<CGameState> gameState;
 
 	std::shared_ptr<GameCallbackMock> gameCallback;
@@ -252,7 +342,7 @@ TEST_F(CGameStateTest, DISABLED_issue2765)
 
 		BattleUnitsChanged pack;
 		pack.changedStacks.emplace_back(info.id, UnitChanges::EOperation::ADD);
-		info.save(pack.changedStacks.back().data);
+		pack.changedStacks.back().info = info;
 		gameCallback->sendAndApply(pack);
 	}
 
@@ -342,7 +432,7 @@ TEST_F(CGameStateTest, DISABLED_battleResurrection)
 
 		BattleUnitsChanged pack;
 		pack.changedStacks.emplace_back(info.id, UnitChanges::EOperation::ADD);
-		info.save(pack.changedStacks.back().data);
+		pack.changedStacks.back().info = info;
 		gameCallback->sendAndApply(pack);
 	}
 
@@ -357,7 +447,7 @@ TEST_F(CGameStateTest, DISABLED_battleResurrection)
 
 		BattleUnitsChanged pack;
 		pack.changedStacks.emplace_back(info.id, UnitChanges::EOperation::ADD);
-		info.save(pack.changedStacks.back().data);
+		pack.changedStacks.back().info = info;
 		gameCallback->sendAndApply(pack);
 	}
 
@@ -401,3 +491,417 @@ TEST_F(CGameStateTest, DISABLED_battleResurrection)
 	EXPECT_EQ(unit->health.getCount(), 10);
 	EXPECT_EQ(unit->health.getResurrected(), 0);
 }
+
+// Live battle caches accessibility and reachability, every change of battle state must drop them
+// Battle states of BattleAI (HypotheticBattle) have no cache and always compute these from scratch
+TEST_F(CGameStateTest, battleReachabilityCacheFollowsStateChanges)
+{
+	startTestGame();
+
+	CGHeroInstance * attacker = map->heroesOnMap[0];
+	CGHeroInstance * defender = map->heroesOnMap[1];
+
+	startTestBattle(attacker, defender);
+
+	BattleInfo * battle = gameState->currentBattles.front().get();
+	ASSERT_NE(battle->getReachabilityCache(), nullptr);
+
+	const CreatureID creature(13);
+
+	auto addUnit = [battle, creature](BattleSide side)
+	{
+		battle::UnitInfo info;
+		info.id = battle->battleNextUnitId();
+		info.count = 10;
+		info.type = creature;
+		info.side = side;
+		info.position = battle->getAvailableHex(info.type, info.side);
+		info.summoned = false;
+		battle->addUnit(info.id, info);
+		return info.id;
+	};
+
+	auto freeHex = [battle](const battle::Unit * unit)
+	{
+		auto accessibility = battle->getAccessibility(unit);
+		for(si16 hex = GameConstants::BFIELD_SIZE / 2; hex < GameConstants::BFIELD_SIZE; hex++)
+			if(hex != unit->getPosition() && accessibility.accessible(BattleHex(hex), unit))
+				return BattleHex(hex);
+		return BattleHex();
+	};
+
+	// fills cache for all units, applies change and compares cached results with results computed from scratch
+	auto expectCacheFollows = [battle](const std::string & change, const std::function<void()> & applyChange)
+	{
+		for(const auto * unit : battle->battleAliveUnits())
+			battle->getReachability(unit);
+		battle->getAccessibility();
+
+		applyChange();
+
+		const auto units = battle->battleAliveUnits();
+		const auto cachedAccessibility = battle->getAccessibility();
+		std::vector<ReachabilityInfo> cached;
+		for(const auto * unit : units)
+			cached.push_back(battle->getReachability(unit));
+
+		battle->getReachabilityCache()->invalidate();
+
+		const auto expectedAccessibility = battle->getAccessibility();
+		EXPECT_TRUE(std::equal(cachedAccessibility.begin(), cachedAccessibility.end(), expectedAccessibility.begin())) << change;
+
+		for(size_t i = 0; i < units.size(); i++)
+		{
+			const auto expected = battle->getReachability(units[i]);
+			EXPECT_EQ(cached[i].distances, expected.distances) << change << ", unit " << units[i]->unitId();
+			EXPECT_TRUE(cached[i].predecessors == expected.predecessors) << change << ", unit " << units[i]->unitId();
+		}
+	};
+
+	uint32_t attackerUnit = 0;
+	uint32_t defenderUnit = 0;
+
+	expectCacheFollows("addUnit", [&]()
+	{
+		attackerUnit = addUnit(BattleSide::ATTACKER);
+		defenderUnit = addUnit(BattleSide::DEFENDER);
+	});
+
+	expectCacheFollows("moveUnit", [&]()
+	{
+		const CStack * unit = battle->getStack(attackerUnit);
+		battle->moveUnit(attackerUnit, freeHex(unit));
+	});
+
+	expectCacheFollows("setUnitState, moved", [&]()
+	{
+		CStack * unit = battle->getStack(defenderUnit);
+		battle::UnitStateSnapshot data;
+		unit->save(data);
+		data.position = freeHex(unit);
+		battle->setUnitState(defenderUnit, data, 0);
+	});
+
+	expectCacheFollows("setUnitState, killed", [&]()
+	{
+		CStack * unit = battle->getStack(attackerUnit);
+		battle::UnitStateSnapshot data;
+		unit->save(data);
+		data.health.fullUnits = 0;
+		data.health.firstHPleft = 0;
+		battle->setUnitState(attackerUnit, data, -unit->getAvailableHealth());
+	});
+
+	expectCacheFollows("removeUnit", [&]()
+	{
+		battle->removeUnit(attackerUnit);
+	});
+
+	expectCacheFollows("setGateState", [&]()
+	{
+		battle->setGateState(EGateState::CLOSED);
+	});
+
+	SpellCreatedObstacle obstacle;
+	obstacle.uniqueID = 1;
+	obstacle.ID = SpellID::QUICKSAND;
+	obstacle.pos = freeHex(battle->getStack(defenderUnit));
+	obstacle.obstacleType = CObstacleInstance::SPELL_CREATED;
+	obstacle.casterSide = BattleSide::DEFENDER;
+	obstacle.hidden = true;
+	obstacle.customSize.push_back(obstacle.pos);
+
+	expectCacheFollows("addObstacle", [&]()
+	{
+		ObstacleChanges changes;
+		obstacle.toInfo(changes);
+		battle->addObstacle(changes);
+	});
+
+	expectCacheFollows("updateObstacle", [&]()
+	{
+		ObstacleChanges changes;
+		obstacle.revealed = true;
+		obstacle.toInfo(changes, BattleChanges::EOperation::UPDATE);
+		battle->updateObstacle(changes);
+	});
+
+	expectCacheFollows("removeObstacle", [&]()
+	{
+		battle->removeObstacle(obstacle.uniqueID);
+	});
+
+	expectCacheFollows("nextRound", [&]()
+	{
+		battle->nextRound();
+	});
+}
+
+TEST_F(CGameStateTest, pathsRepairedAfterStepMatchFullCalculation)
+{
+	startTestGame();
+
+	// blocked tiles and guarded zone, so paths are not straight lines
+	addObject(int3(5, 5, 0), Obj::MINE, 0);
+	addMonster(int3(1, 6, 0), CreatureID(0));
+
+	CGHeroInstance * hero = map->heroesOnMap[0];
+
+	CPathsInfo repaired(gameState->getMapSize(), hero);
+	gameState->calculatePaths(hero, repaired);
+
+	for(int step = 0; step < 4; step++)
+	{
+		// any step that keeps hero on path of previous search and outside of objects and guarded zones can be repaired
+		const int3 from = hero->visitablePos();
+		const CGPathNode * target = nullptr;
+
+		for(const auto & dir : int3::getDirs())
+		{
+			const int3 tile = from + dir;
+			if(!gameState->isInTheMap(tile) || gameState->guardingCreaturePosition(tile).valid() || !map->getTile(tile).visitableObjects.empty())
+				continue;
+
+			const CGPathNode * node = repaired.getNode(tile);
+			if(node->turns == 0 && node->action == EPathNodeAction::NORMAL && node->theNodeBefore && node->theNodeBefore->coord == from)
+			{
+				target = node;
+				break;
+			}
+		}
+
+		ASSERT_NE(target, nullptr) << "step " << step;
+
+		TryMoveHero move;
+		move.id = hero->id;
+		move.start = hero->pos;
+		move.end = hero->convertFromVisitablePos(target->coord);
+		move.movePoints = target->moveRemains;
+		move.result = TryMoveHero::SUCCESS;
+		gameCallback->sendAndApply(move);
+
+		ASSERT_EQ(hero->visitablePos(), target->coord);
+
+		gameState->calculatePaths(hero, repaired);
+
+		CPathsInfo expected(gameState->getMapSize(), hero);
+		gameState->calculatePaths(hero, expected);
+
+		expectSamePaths(repaired, expected, "step " + std::to_string(step));
+	}
+}
+
+TEST_F(CGameStateTest, pathsRecalculatedInReusedNodesMatchFullCalculation)
+{
+	startTestGame();
+
+	CGHeroInstance * hero = map->heroesOnMap[0];
+	const int3 heroPos = hero->visitablePos();
+
+	CPathsInfo reused(gameState->getMapSize(), hero);
+	gameState->calculatePaths(hero, reused);
+
+	const auto expectSameAsFullCalculation = [&](const std::string & step, const std::function<void()> & change)
+	{
+		change();
+
+		// hero does not move, so only nodes reached by previous search and tiles that changed are reset
+		gameState->calculatePaths(hero, reused);
+
+		CPathsInfo expected(gameState->getMapSize(), hero);
+		gameState->calculatePaths(hero, expected);
+
+		expectSamePaths(reused, expected, step);
+	};
+
+	expectSameAsFullCalculation("nothing changed", [](){});
+
+	expectSameAsFullCalculation("add mine", [&]()
+	{
+		addObject(heroPos + int3(2, 0, 0), Obj::MINE, 0);
+	});
+
+	expectSameAsFullCalculation("add monster", [&]()
+	{
+		addMonster(heroPos + int3(0, 2, 0), CreatureID(0));
+	});
+
+	std::unordered_set<int3> area;
+	for(int x = -5; x < -1; x++)
+	{
+		for(int y = -5; y < -1; y++)
+		{
+			if(gameState->isInTheMap(heroPos + int3(x, y, 0)))
+				area.insert(heroPos + int3(x, y, 0));
+		}
+	}
+
+	expectSameAsFullCalculation("hide tiles", [&]()
+	{
+		FoWChange pack;
+		pack.player = hero->tempOwner;
+		pack.tiles = area;
+		pack.mode = ETileVisibility::HIDDEN;
+		gameCallback->sendAndApply(pack);
+	});
+}
+
+TEST_F(CGameStateTest, pathfinderAccessibilityUpdateMatchesRebuild)
+{
+	startTestGame();
+
+	CGHeroInstance * hero = map->heroesOnMap[0];
+	const PlayerColor player = hero->tempOwner;
+	const int3 sizes = gameState->getMapSize();
+
+	// everything pathfinder reads from tile that can be changed by objects, their state or fog of war
+	using TTileState = std::tuple<bool, bool, std::vector<ObjectInstanceID>, std::vector<ObjectInstanceID>, std::vector<bool>, int3, ui8>;
+	const auto tileState = [this, player](const int3 & pos) -> TTileState
+	{
+		const TerrainTile & tile = map->getTile(pos);
+		std::vector<ObjectInstanceID> blocking;
+		std::vector<ObjectInstanceID> visitable;
+		std::vector<bool> passable;
+		for(const auto * object : tile.blockingObjects)
+			blocking.push_back(object->id);
+		for(const auto * object : tile.visitableObjects)
+		{
+			visitable.push_back(object->id);
+			passable.push_back(object->passableFor(player));
+		}
+		const auto & fow = gameState->getPlayerTeam(player)->fogOfWarMap;
+		return {tile.blocked(), tile.visitable(), blocking, visitable, passable, gameState->guardingCreaturePosition(pos), fow[pos.z][pos.x][pos.y]};
+	};
+
+	const auto forEachTile = [sizes](const std::function<void(const int3 &)> & handler)
+	{
+		int3 pos;
+		for(pos.z = 0; pos.z < sizes.z; pos.z++)
+			for(pos.x = 0; pos.x < sizes.x; pos.x++)
+				for(pos.y = 0; pos.y < sizes.y; pos.y++)
+					handler(pos);
+	};
+
+	// build layer before any change, so all following changes are applied incrementally
+	gameState->getPathfinderAccessibility(player);
+
+	auto expectUpdateMatchesRebuild = [&](const std::string & change, const std::function<void()> & applyChange)
+	{
+		std::map<int3, TTileState> before;
+		forEachTile([&](const int3 & pos){ before[pos] = tileState(pos); });
+		const size_t revision = map->getTileRevision();
+
+		applyChange();
+
+		std::set<int3> logged;
+		ASSERT_TRUE(map->forEachTileChangedSince(revision, [&logged](const int3 & pos){ logged.insert(pos); })) << change;
+
+		forEachTile([&](const int3 & pos)
+		{
+			if(before[pos] != tileState(pos))
+				EXPECT_TRUE(logged.count(pos)) << change << ", tile " << pos.toString() << " changed but is not in log";
+		});
+
+		const auto updated = gameState->getPathfinderAccessibility(player);
+		const PathfinderAccessibility rebuilt(gameState.get(), player, player);
+
+		forEachTile([&](const int3 & pos)
+		{
+			for(int layer = 0; layer < EPathfindingLayer::NUM_LAYERS; layer++)
+				EXPECT_TRUE(updated->get(pos, EPathfindingLayer(layer)) == rebuilt.get(pos, EPathfindingLayer(layer))) << change << ", tile " << pos.toString() << ", layer " << layer;
+		});
+	};
+
+	CGObjectInstance * mine = nullptr;
+	CGObjectInstance * monster = nullptr;
+
+	expectUpdateMatchesRebuild("add mine", [&]()
+	{
+		mine = addObject(int3(5, 5, 0), Obj::MINE, 0);
+	});
+
+	expectUpdateMatchesRebuild("flag mine", [&]()
+	{
+		SetObjectProperty pack;
+		pack.id = mine->id;
+		pack.what = ObjProperty::OWNER;
+		pack.identifier = player;
+		gameCallback->sendAndApply(pack);
+	});
+
+	expectUpdateMatchesRebuild("add monster", [&]()
+	{
+		monster = addMonster(int3(1, 6, 0), CreatureID(0));
+	});
+
+	expectUpdateMatchesRebuild("teleport hero", [&]()
+	{
+		TryMoveHero pack;
+		pack.id = hero->id;
+		pack.start = hero->pos;
+		pack.end = hero->convertFromVisitablePos(int3(6, 7, 0));
+		pack.movePoints = hero->movementPointsRemaining();
+		pack.result = TryMoveHero::TELEPORTATION;
+		gameCallback->sendAndApply(pack);
+	});
+
+	expectUpdateMatchesRebuild("remove monster", [&]()
+	{
+		RemoveObject pack(monster->id, PlayerColor::NEUTRAL);
+		gameCallback->sendAndApply(pack);
+	});
+
+	expectUpdateMatchesRebuild("remove mine", [&]()
+	{
+		RemoveObject pack(mine->id, player);
+		gameCallback->sendAndApply(pack);
+	});
+
+	std::unordered_set<int3> area;
+	for(int x = 0; x < 4; x++)
+		for(int y = 0; y < 4; y++)
+			area.insert(int3(x, y + 10, 0));
+
+	expectUpdateMatchesRebuild("hide tiles", [&]()
+	{
+		FoWChange pack;
+		pack.player = player;
+		pack.tiles = area;
+		pack.mode = ETileVisibility::HIDDEN;
+		gameCallback->sendAndApply(pack);
+	});
+
+	expectUpdateMatchesRebuild("reveal tiles", [&]()
+	{
+		FoWChange pack;
+		pack.player = player;
+		pack.tiles = area;
+		pack.mode = ETileVisibility::REVEALED;
+		gameCallback->sendAndApply(pack);
+	});
+
+	CGObjectInstance * garrison = nullptr;
+
+	expectUpdateMatchesRebuild("add empty garrison", [&]()
+	{
+		garrison = addObject(int3(8, 3, 0), Obj::GARRISON, 0);
+	});
+
+	expectUpdateMatchesRebuild("guard garrison", [&]()
+	{
+		InsertNewStack pack;
+		pack.army = garrison->id;
+		pack.slot = SlotID(0);
+		pack.type = CreatureID(0);
+		pack.count = 10;
+		gameCallback->sendAndApply(pack);
+	});
+
+	expectUpdateMatchesRebuild("empty garrison", [&]()
+	{
+		EraseStack pack;
+		pack.army = garrison->id;
+		pack.slot = SlotID(0);
+		gameCallback->sendAndApply(pack);
+	});
+}
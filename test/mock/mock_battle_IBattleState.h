@@ -12,6 +12,7 @@
 
 #include "../../lib/battle/IBattleState.h"
 #include "../../lib/battle/BattleLayout.h"
+#include "../../lib/battle/Unit.h"
 #include "../../lib/int3.h"
 
 class BattleStateMock : public IBattleState
@@ -43,8 +44,8 @@ public:
 
 	MOCK_METHOD0(nextRound, void());
 	MOCK_METHOD1(nextTurn, void(uint32_t));
-	MOCK_METHOD2(addUnit, void(uint32_t, const JsonNode &));
-	MOCK_METHOD3(setUnitState, void(uint32_t, const JsonNode &, int64_t));
+	MOCK_METHOD2(addUnit, void(uint32_t, const battle::UnitInfo &));
+	MOCK_METHOD3(setUnitState, void(uint32_t, const battle::UnitStateSnapshot &, int64_t));
 	MOCK_METHOD2(moveUnit, void(uint32_t, BattleHex));
 	MOCK_METHOD1(removeUnit, void(uint32_t));
 	MOCK_METHOD2(updateUnit, void(uint32_t, const JsonNode &));
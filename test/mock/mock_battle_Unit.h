@@ -15,7 +15,7 @@
 class UnitMock : public battle::Unit
 {
 public:
-	MOCK_CONST_METHOD3(getAllBonuses, TConstBonusListPtr(const CSelector &, const CSelector &, const std::string &));
+	MOCK_CONST_METHOD3(getAllBonuses, TConstBonusListPtr(const CSelector &, const CSelector &, const BonusCacheKey &));
 	MOCK_CONST_METHOD0(getTreeVersion, int64_t());
 
 	MOCK_CONST_METHOD0(getCasterUnitId, int32_t());
@@ -89,8 +89,8 @@ public:
 	MOCK_CONST_METHOD0(acquire, std::shared_ptr<battle::Unit>());
 	MOCK_CONST_METHOD0(acquireState, std::shared_ptr<battle::CUnitState>());
 
-	MOCK_METHOD1(save, void(JsonNode &));
-	MOCK_METHOD1(load, void(const JsonNode &));
+	MOCK_METHOD1(save, void(battle::UnitStateSnapshot &));
+	MOCK_METHOD1(load, void(const battle::UnitStateSnapshot &));
 
 	MOCK_METHOD1(damage, void(int64_t &));
 	MOCK_METHOD3(heal, battle::HealInfo(int64_t &, EHealLevel, EHealPower));
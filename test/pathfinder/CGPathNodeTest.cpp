@@ -0,0 +1,83 @@
+/*
+ * CGPathNodeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/pathfinder/CGPathNode.h"
+
+namespace
+{
+
+/// Node with indices instead of pointers and generation counter instead of reset, used only to measure what packing would save
+struct PackedPathNode
+{
+	uint32_t nodeBefore;
+	float cost;
+	uint32_t generation;
+	uint16_t moveRemains;
+	uint8_t turns;
+	uint8_t flags; //accessibility, action and locked state
+};
+
+static_assert(sizeof(PackedPathNode) == 16, "Unexpected padding in PackedPathNode");
+
+template<typename Function>
+int64_t measure(const Function & function)
+{
+	const int repeats = 20;
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < repeats; i++)
+		function();
+
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	return duration.count() / repeats;
+}
+
+}
+
+// Run with --gtest_also_run_disabled_tests to compare cost of node reset done by NodeStorage::initialize
+TEST(CGPathNodeTest, DISABLED_ResetBenchmark)
+{
+	for(int size : {144, 252})
+	{
+		CPathsInfo paths(int3(size, size, 2), nullptr);
+		std::vector<PackedPathNode> packedNodes(paths.nodes.num_elements());
+		uint32_t generation = 0;
+
+		// typical search reaches land layer of one level
+		std::vector<CGPathNode *> reachedNodes;
+		for(int x = 0; x < size; x++)
+			for(int y = 0; y < size; y++)
+				reachedNodes.push_back(paths.getNode(int3(x, y, 0), EPathfindingLayer::LAND));
+
+		auto fullReset = measure([&]()
+		{
+			for(size_t i = 0; i < paths.nodes.num_elements(); i++)
+				paths.nodes.data()[i].reset();
+		});
+
+		auto reachedReset = measure([&]()
+		{
+			for(CGPathNode * node : reachedNodes)
+				node->reset();
+		});
+
+		auto packedFullReset = measure([&]()
+		{
+			generation++;
+			for(auto & node : packedNodes)
+				node = PackedPathNode{0, std::numeric_limits<float>::max(), generation, 0, 255, 0};
+		});
+
+		std::cout << "Map " << size << "x" << size << "x2, " << paths.nodes.num_elements() << " nodes" << std::endl;
+		std::cout << "  CGPathNode: " << paths.nodes.num_elements() * sizeof(CGPathNode) / 1024 << " KiB, full reset " << fullReset << " us, reset of " << reachedNodes.size() << " reached nodes " << reachedReset << " us" << std::endl;
+		std::cout << "  PackedPathNode: " << packedNodes.size() * sizeof(PackedPathNode) / 1024 << " KiB, full reset " << packedFullReset << " us" << std::endl;
+	}
+}
@@ -0,0 +1,167 @@
+/*
+ * PathfinderQueueTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/pathfinder/CGPathNode.h"
+#include "../../lib/pathfinder/PathfinderQueue.h"
+
+namespace
+{
+
+/// Dijkstra search over single level map with random movement costs, same access pattern as CPathfinder
+class QueueSearch
+{
+	int size;
+	std::vector<float> tileCosts;
+
+public:
+	std::vector<CGPathNode> nodes;
+
+	QueueSearch(int size)
+		: size(size)
+		, tileCosts(size * size)
+		, nodes(size * size)
+	{
+		std::mt19937 rng(size);
+		std::uniform_int_distribution<int> terrainCost(100, 175);
+
+		for(auto & cost : tileCosts)
+			cost = terrainCost(rng) / 1500.0f;
+	}
+
+	void run(EPathfinderQueue queueType)
+	{
+		auto queue = IPathfinderQueue::create(queueType);
+
+		for(int i = 0; i < nodes.size(); i++)
+		{
+			nodes[i].reset();
+			nodes[i].coord = int3(i % size, i / size, 0);
+		}
+
+		CGPathNode * initial = &nodes[size * size / 2 + size / 2];
+		initial->setCost(0);
+		queue->push(initial);
+
+		while(!queue->empty())
+		{
+			CGPathNode * node = queue->topAndPop();
+			node->locked = true;
+
+			for(int dy = -1; dy <= 1; dy++)
+			{
+				for(int dx = -1; dx <= 1; dx++)
+				{
+					int3 pos = node->coord + int3(dx, dy, 0);
+					if(pos.x < 0 || pos.y < 0 || pos.x >= size || pos.y >= size || (dx == 0 && dy == 0))
+						continue;
+
+					CGPathNode * neighbour = &nodes[pos.y * size + pos.x];
+					if(neighbour->locked)
+						continue;
+
+					float cost = node->getCost() + tileCosts[pos.y * size + pos.x] * (dx && dy ? 1.41f : 1.0f);
+					if(cost < neighbour->getCost())
+					{
+						neighbour->setCost(cost);
+						if(!neighbour->inPQ())
+							queue->push(neighbour);
+					}
+				}
+			}
+		}
+	}
+};
+
+const std::vector<EPathfinderQueue> queueTypes = {
+	EPathfinderQueue::FIBONACCI_HEAP,
+	EPathfinderQueue::QUATERNARY_HEAP,
+	EPathfinderQueue::BUCKET_QUEUE
+};
+
+}
+
+TEST(PathfinderQueueTest, AllQueuesFindSameCosts)
+{
+	QueueSearch search(72);
+	search.run(EPathfinderQueue::FIBONACCI_HEAP);
+
+	std::vector<float> expected;
+	for(const auto & node : search.nodes)
+		expected.push_back(node.getCost());
+
+	for(auto queueType : queueTypes)
+	{
+		search.run(queueType);
+
+		for(int i = 0; i < expected.size(); i++)
+		{
+			EXPECT_TRUE(search.nodes[i].locked);
+			EXPECT_NEAR(search.nodes[i].getCost(), expected[i], 1e-4);
+		}
+	}
+}
+
+// Node may return to cost of its older queue entry after update or after being popped and pushed again
+TEST(PathfinderQueueTest, OutdatedEntriesAreNotPopped)
+{
+	for(auto queueType : queueTypes)
+	{
+		auto queue = IPathfinderQueue::create(queueType);
+		std::vector<CGPathNode> nodes(3);
+
+		nodes[0].setCost(1.0f);
+		queue->push(&nodes[0]);
+		nodes[1].setCost(0.5f);
+		queue->push(&nodes[1]);
+
+		// cost raised and lowered back while queued
+		nodes[0].setCost(2.0f);
+		nodes[0].setCost(1.0f);
+
+		// popped and pushed again with cost of its first entry
+		nodes[1].setCost(0.8f);
+		ASSERT_EQ(queue->topAndPop(), &nodes[1]);
+		nodes[1].setCost(0.5f);
+		queue->push(&nodes[1]);
+
+		nodes[2].setCost(3.0f);
+		queue->push(&nodes[2]);
+
+		std::vector<CGPathNode *> popped;
+		while(!queue->empty() && popped.size() < 10)
+			popped.push_back(queue->topAndPop());
+
+		const std::vector<CGPathNode *> expected = {&nodes[1], &nodes[0], &nodes[2]};
+		EXPECT_EQ(popped, expected) << "queue " << static_cast<int>(queueType);
+		EXPECT_TRUE(queue->empty()) << "queue " << static_cast<int>(queueType);
+	}
+}
+
+// Run with --gtest_also_run_disabled_tests to compare queue implementations
+TEST(PathfinderQueueTest, DISABLED_Benchmark)
+{
+	for(int size : {144, 252})
+	{
+		QueueSearch search(size);
+
+		for(auto queueType : queueTypes)
+		{
+			const int repeats = 10;
+			auto start = std::chrono::steady_clock::now();
+
+			for(int i = 0; i < repeats; i++)
+				search.run(queueType);
+
+			auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			std::cout << "Map " << size << "x" << size << ", queue " << static_cast<int>(queueType) << ": " << duration.count() / repeats << " us per search" << std::endl;
+		}
+	}
+}
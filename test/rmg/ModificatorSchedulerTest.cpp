@@ -0,0 +1,131 @@
+/*
+ * ModificatorSchedulerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/threadpool/ModificatorScheduler.h"
+
+namespace
+{
+
+/// Diamond-shaped graph with independent branches and a job depending on a later one
+const std::vector<std::vector<size_t>> dependencyGraph = {
+	{3},       // 0 waits for 3
+	{},        // 1
+	{1},       // 2
+	{},        // 3
+	{0, 2},    // 4
+	{},        // 5
+	{4, 5},    // 6
+	{1, 3, 6}  // 7
+};
+
+struct JobLog
+{
+	boost::mutex mx;
+	std::vector<size_t> started;
+	std::vector<size_t> finished;
+	std::vector<std::atomic<bool>> done;
+
+	explicit JobLog(size_t jobsCount)
+		: done(jobsCount)
+	{
+	}
+
+	std::vector<ModificatorScheduler::Job> makeJobs(const std::vector<std::vector<size_t>> & graph, std::atomic<int> & violations)
+	{
+		std::vector<ModificatorScheduler::Job> jobs;
+		for(size_t i = 0; i < graph.size(); i++)
+		{
+			jobs.emplace_back([this, i, &graph, &violations]()
+			{
+				for(size_t dependency : graph[i])
+					if(!done[dependency])
+						violations++;
+
+				{
+					boost::lock_guard<boost::mutex> lock(mx);
+					started.push_back(i);
+				}
+				boost::this_thread::sleep_for(boost::chrono::microseconds(100 * (i % 3)));
+				{
+					boost::lock_guard<boost::mutex> lock(mx);
+					finished.push_back(i);
+				}
+				done[i] = true;
+			});
+		}
+		return jobs;
+	}
+};
+
+}
+
+TEST(ModificatorSchedulerTest, SequentialRunRespectsDependencies)
+{
+	JobLog log(dependencyGraph.size());
+	std::atomic<int> violations(0);
+	size_t callbacks = 0;
+
+	ModificatorScheduler scheduler(log.makeJobs(dependencyGraph, violations), dependencyGraph, [&callbacks](){ callbacks++; });
+	scheduler.runSequential();
+
+	EXPECT_EQ(violations, 0);
+	EXPECT_EQ(callbacks, dependencyGraph.size());
+	EXPECT_EQ(log.finished.size(), dependencyGraph.size());
+}
+
+TEST(ModificatorSchedulerTest, SequentialRunPicksFirstReadyJob)
+{
+	// same order as repeatedly running first job of the list whose dependencies are finished
+	const std::vector<size_t> expected = {1, 2, 3, 0, 4, 5, 6, 7};
+
+	for(int run = 0; run < 3; run++)
+	{
+		JobLog log(dependencyGraph.size());
+		std::atomic<int> violations(0);
+
+		ModificatorScheduler scheduler(log.makeJobs(dependencyGraph, violations), dependencyGraph, [](){});
+		scheduler.runSequential();
+
+		EXPECT_EQ(log.started, expected) << "run " << run;
+	}
+}
+
+TEST(ModificatorSchedulerTest, ParallelRunRespectsDependencies)
+{
+	// wide random graph, every job depends only on jobs with lower index
+	std::mt19937 rng(7);
+	std::vector<std::vector<size_t>> graph(200);
+	for(size_t i = 1; i < graph.size(); i++)
+	{
+		const size_t count = rng() % 4;
+		for(size_t j = 0; j < count; j++)
+			graph[i].push_back(rng() % i);
+		vstd::removeDuplicates(graph[i]);
+	}
+
+	for(size_t threads : {1, 2, 4, 8})
+	{
+		JobLog log(graph.size());
+		std::atomic<int> violations(0);
+		std::atomic<size_t> callbacks(0);
+
+		ModificatorScheduler scheduler(log.makeJobs(graph, violations), graph, [&callbacks](){ callbacks++; });
+		scheduler.runParallel(threads);
+
+		EXPECT_EQ(violations, 0) << threads << " threads";
+		EXPECT_EQ(callbacks, graph.size()) << threads << " threads";
+
+		auto finished = log.finished;
+		std::sort(finished.begin(), finished.end());
+		EXPECT_TRUE(std::adjacent_find(finished.begin(), finished.end()) == finished.end()) << threads << " threads, job run twice";
+		EXPECT_EQ(finished.size(), graph.size()) << threads << " threads";
+	}
+}
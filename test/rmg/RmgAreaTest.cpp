@@ -0,0 +1,180 @@
+/*
+ * RmgAreaTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/RmgArea.h"
+
+using namespace rmg;
+
+namespace
+{
+
+Tileset randomTiles(std::mt19937 & rng, const int3 & origin, int size, int count)
+{
+	std::uniform_int_distribution<int> coord(0, size - 1);
+	std::uniform_int_distribution<int> level(0, 1);
+
+	Tileset result;
+	for(int i = 0; i < count; i++)
+		result.insert(origin + int3(coord(rng), coord(rng), level(rng)));
+	return result;
+}
+
+Tileset referenceBorder(const Tileset & tiles)
+{
+	Tileset result;
+	for(const auto & t : tiles)
+	{
+		for(const auto & dir : int3::getDirs())
+		{
+			if(!tiles.count(t + dir))
+				result.insert(t);
+		}
+	}
+	return result;
+}
+
+Tileset referenceBorderOutside(const Tileset & tiles)
+{
+	Tileset result;
+	for(const auto & t : tiles)
+	{
+		for(const auto & dir : int3::getDirs())
+		{
+			if(!tiles.count(t + dir))
+				result.insert(t + dir);
+		}
+	}
+	return result;
+}
+
+void expectArea(const Area & area, const Tileset & expected)
+{
+	EXPECT_EQ(area.getTiles(), expected);
+	EXPECT_EQ(area.getTilesVector().size(), expected.size());
+	EXPECT_EQ(area.empty(), expected.empty());
+	EXPECT_EQ(area.getBorder(), referenceBorder(expected));
+	EXPECT_EQ(area.getBorderOutside(), referenceBorderOutside(expected));
+}
+
+}
+
+TEST(RmgAreaTest, SetOperationsMatchTileset)
+{
+	std::mt19937 rng(42);
+
+	for(int i = 0; i < 20; i++)
+	{
+		// sizes above 64 make rows span several words, negative origins cover translated areas
+		const int size = i % 2 ? 40 : 150;
+		const Tileset tilesA = randomTiles(rng, int3(-10, 5, 0), size, size * 3);
+		const Tileset tilesB = randomTiles(rng, int3(20, -7, 0), size, size * 3);
+
+		Area a(tilesA);
+		Area b(tilesB);
+		expectArea(a, tilesA);
+
+		Tileset united = tilesA;
+		united.insert(tilesB.begin(), tilesB.end());
+		Tileset intersection;
+		Tileset difference;
+		for(const auto & t : tilesA)
+		{
+			if(tilesB.count(t))
+				intersection.insert(t);
+			else
+				difference.insert(t);
+		}
+
+		expectArea(a + b, united);
+		expectArea(a * b, intersection);
+		expectArea(a - b, difference);
+		EXPECT_EQ(a.overlap(b), !intersection.empty());
+		EXPECT_TRUE((a + b).contains(b));
+		EXPECT_EQ(a.contains(b), intersection.size() == tilesB.size());
+
+		const int3 shift(-33, 71, 0);
+		Tileset translated;
+		for(const auto & t : tilesA)
+			translated.insert(t + shift);
+		expectArea(a + shift, translated);
+		expectArea((a + shift) - shift, tilesA);
+	}
+}
+
+TEST(RmgAreaTest, AddAndEraseTiles)
+{
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> coord(-80, 80);
+
+	Area area;
+	Tileset expected;
+	for(int i = 0; i < 2000; i++)
+	{
+		int3 tile(coord(rng), coord(rng), 0);
+		if(i % 3 == 2)
+		{
+			area.erase(tile);
+			expected.erase(tile);
+		}
+		else
+		{
+			area.add(tile);
+			expected.insert(tile);
+		}
+		ASSERT_EQ(area.contains(tile), expected.count(tile) != 0);
+	}
+	expectArea(area, expected);
+
+	area.erase_if([](const int3 & tile)
+	{
+		return tile.x < 0;
+	});
+	vstd::erase_if(expected, [](const int3 & tile)
+	{
+		return tile.x < 0;
+	});
+	expectArea(area, expected);
+}
+
+TEST(RmgAreaTest, ConnectedAreas)
+{
+	Area area(Tileset{int3(0, 0, 0), int3(1, 1, 0), int3(5, 0, 0), int3(70, 3, 0), int3(71, 3, 0)});
+
+	EXPECT_FALSE(area.connected());
+	EXPECT_EQ(connectedAreas(area, false).size(), 3);
+	EXPECT_EQ(connectedAreas(area, true).size(), 4);
+
+	area.subtract(Area(Tileset{int3(5, 0, 0), int3(70, 3, 0), int3(71, 3, 0)}));
+	EXPECT_TRUE(area.connected());
+	EXPECT_FALSE(area.connected(true));
+}
+
+TEST(RmgAreaTest, DistanceMapMatchesBorderLayers)
+{
+	std::mt19937 rng(5);
+	Area area(randomTiles(rng, int3(3, 3, 0), 30, 700));
+
+	std::map<int, Tileset> reverseDistanceMap;
+	auto distanceMap = area.computeDistanceMap(reverseDistanceMap);
+
+	EXPECT_EQ(distanceMap.size(), area.getTiles().size());
+
+	// reference: distance is number of border layers removed before tile becomes border itself
+	Area remaining(area);
+	for(int distance = 0; !remaining.empty(); distance++)
+	{
+		const Tileset border = remaining.getBorder();
+		EXPECT_EQ(reverseDistanceMap[distance], border);
+		for(const auto & tile : border)
+			EXPECT_EQ(distanceMap.at(tile), distance);
+		remaining.subtract(Area(border));
+	}
+}
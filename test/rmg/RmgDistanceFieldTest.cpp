@@ -0,0 +1,165 @@
+/*
+ * RmgDistanceFieldTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/RmgDistanceField.h"
+
+using namespace rmg;
+
+TEST(RmgDistanceFieldTest, MatchesNearestSourceDistance)
+{
+	std::vector<int> seeds(300);
+	std::iota(seeds.begin(), seeds.end(), 1);
+	// tiles of these fields are not reached by nearest source when distance is propagated between neighbouring tiles
+	vstd::concatenate(seeds, std::vector<int>{1052, 1109, 1559, 2259, 2768, 4537});
+
+	for(int seed : seeds)
+	{
+		std::mt19937 rng(seed);
+
+		const int width = std::uniform_int_distribution<int>(1, 80)(rng);
+		const int height = std::uniform_int_distribution<int>(1, 60)(rng);
+		const int3 origin(std::uniform_int_distribution<int>(-5, 20)(rng), std::uniform_int_distribution<int>(-5, 20)(rng), 1);
+
+		// sources are spread around the field, so some of them lie outside of it
+		std::uniform_int_distribution<int> coordX(origin.x - 30, origin.x + width + 30);
+		std::uniform_int_distribution<int> coordY(origin.y - 30, origin.y + height + 30);
+
+		DistanceField field(origin, width, height);
+		std::vector<ui32> expected(static_cast<size_t>(width) * height, DistanceField::INFINITE_DISTANCE);
+
+		const int steps = std::uniform_int_distribution<int>(1, 60)(rng);
+		for(int step = 0; step < steps; step++)
+		{
+			// object-like cluster of tiles or single tile
+			const int3 corner(coordX(rng), coordY(rng), 1);
+			const int size = std::uniform_int_distribution<int>(1, 4)(rng);
+			std::vector<int3> sources;
+			for(int t = 0; t < size * size; t++)
+				sources.push_back(corner + int3(t % size, t / size, 0));
+
+			field.addSources(sources, [&field](const int3 & tile, ui32 distance)
+			{
+				ASSERT_EQ(field.get(tile), distance);
+			});
+
+			for(int y = origin.y; y < origin.y + height; y++)
+			{
+				for(int x = origin.x; x < origin.x + width; x++)
+				{
+					const int3 tile(x, y, origin.z);
+					auto & expectedDistance = expected[static_cast<size_t>(y - origin.y) * width + (x - origin.x)];
+					for(const auto & source : sources)
+						vstd::amin(expectedDistance, static_cast<ui32>(source.dist2dSQ(tile)));
+					ASSERT_EQ(field.get(tile), expectedDistance) << "seed " << seed << ", step " << step << ", tile " << tile.toString();
+				}
+			}
+		}
+
+		EXPECT_FALSE(field.contains(origin + int3(0, 0, 1)));
+		EXPECT_EQ(field.get(origin - int3(1, 0, 0)), DistanceField::INFINITE_DISTANCE);
+	}
+}
+
+// Same sequence of updates as ObjectManager::updateDistances, possible area shrinks as objects are placed
+TEST(RmgDistanceFieldTest, TilesByDistanceFollowsNearestSource)
+{
+	const int3 origin(0, 0, 0);
+	const int width = 40;
+	const int height = 30;
+	const float initialDistance = 10000.f;
+
+	for(int seed = 1; seed <= 5; seed++)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> coordX(-5, width + 5);
+		std::uniform_int_distribution<int> coordY(-5, height + 5);
+
+		DistanceField field(origin, width, height);
+		TilesByDistance tilesByDistance;
+		std::vector<int3> allSources;
+		std::vector<int3> blocked;
+		std::map<int3, float> stored; //distance kept for possible tiles only, as in RmgMap
+
+		Area possible;
+		for(int y = 0; y < height; y++)
+			for(int x = 0; x < width; x++)
+				possible.add(int3(x, y, 0));
+
+		for(const auto & tile : possible.getTilesVector())
+		{
+			stored[tile] = initialDistance;
+			tilesByDistance.set(tile, initialDistance);
+		}
+
+		auto storedDistance = [&](const int3 & tile)
+		{
+			return stored.count(tile) ? stored.at(tile) : initialDistance;
+		};
+
+		for(int i = 0; i < 25; i++)
+		{
+			const int3 corner(coordX(rng), coordY(rng), 0);
+			std::vector<int3> sources;
+			for(int t = 0; t < 4; t++)
+				sources.push_back(corner + int3(t % 2, t / 2, 0));
+			allSources.insert(allSources.end(), sources.begin(), sources.end());
+
+			// object blocks tiles around it too, these leave possible area before next sources are added
+			for(int y = -1; y <= 2; y++)
+			{
+				for(int x = -1; x <= 2; x++)
+				{
+					const int3 tile = corner + int3(x, y, 0);
+					if(!possible.contains(tile))
+						continue;
+					possible.erase(tile);
+					stored.erase(tile);
+					if(x < 0 || y < 0 || x > 1 || y > 1)
+						blocked.push_back(tile);
+				}
+			}
+
+			// some of them become possible again after more sources were added
+			if(i % 5 == 4 && !blocked.empty())
+			{
+				possible.add(blocked.front());
+				blocked.erase(blocked.begin());
+			}
+
+			tilesByDistance.assignArea(possible, [&](const int3 & tile)
+			{
+				return std::min(static_cast<float>(field.get(tile)), storedDistance(tile));
+			});
+
+			field.addSources(sources, [&](const int3 & tile, ui32 d)
+			{
+				if(!possible.contains(tile))
+					return;
+				stored[tile] = std::min(static_cast<float>(d), storedDistance(tile));
+				tilesByDistance.set(tile, stored[tile]);
+			});
+
+			std::vector<TilesByDistance::TEntry> expected;
+			for(const auto & tile : possible.getTilesVector())
+			{
+				ui32 d = DistanceField::INFINITE_DISTANCE;
+				for(const auto & source : allSources)
+					vstd::amin(d, static_cast<ui32>(source.dist2dSQ(tile)));
+				expected.emplace_back(std::min(static_cast<float>(d), initialDistance), tile);
+			}
+			std::sort(expected.begin(), expected.end(), TilesByDistance::FarthestFirst());
+
+			const std::vector<TilesByDistance::TEntry> actual(tilesByDistance.begin(), tilesByDistance.end());
+			ASSERT_EQ(actual, expected) << "seed " << seed << ", step " << i;
+			ASSERT_EQ(tilesByDistance.getArea(), possible);
+		}
+	}
+}
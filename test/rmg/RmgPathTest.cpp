@@ -0,0 +1,221 @@
+/*
+ * RmgPathTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/RmgPath.h"
+
+#include <boost/heap/priority_queue.hpp>
+
+using namespace rmg;
+
+namespace
+{
+
+/// Previous implementation of Path::search based on std::map, used as reference
+Tileset referenceSearch(const Area & area, const Area & start, const int3 & dst, bool straight, const std::function<float(const int3 &, const int3 &)> & moveCost)
+{
+	using TDistance = std::pair<int3, float>;
+	struct NodeComparer
+	{
+		bool operator()(const TDistance & lhs, const TDistance & rhs) const
+		{
+			return (rhs.second < lhs.second);
+		}
+	};
+
+	Area searchArea = area;
+	searchArea.add(dst);
+	Tileset result{dst};
+
+	Tileset closed;
+	boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>> open;
+	std::map<int3, int3> cameFrom;
+	std::map<int3, float> distances;
+
+	cameFrom[dst] = int3(-1, -1, -1);
+	distances[dst] = 0;
+	open.push(std::make_pair(dst, 0.f));
+
+	while(!open.empty())
+	{
+		int3 currentNode = open.top().first;
+		open.pop();
+		closed.insert(currentNode);
+
+		if(start.contains(currentNode))
+		{
+			for(int3 backTracking = currentNode; cameFrom[backTracking].valid(); backTracking = cameFrom[backTracking])
+				result.insert(backTracking);
+			return result;
+		}
+
+		auto allDirs = int3::getDirs();
+		std::vector<int3> dirs(allDirs.begin(), allDirs.end());
+		if(straight)
+			dirs.assign(rmg::dirs4.begin(), rmg::dirs4.end());
+
+		for(const auto & dir : dirs)
+		{
+			int3 pos = currentNode + dir;
+			if(closed.count(pos) || !searchArea.contains(pos))
+				continue;
+
+			float distance = distances[currentNode] + moveCost(currentNode, pos) + currentNode.dist2d(pos);
+			int bestDistanceSoFar = std::numeric_limits<int>::max();
+			if(distances.count(pos))
+				bestDistanceSoFar = static_cast<int>(distances[pos]);
+
+			if(distance < bestDistanceSoFar)
+			{
+				cameFrom[pos] = currentNode;
+				open.push(std::make_pair(pos, distance));
+				distances[pos] = distance;
+			}
+		}
+	}
+	return {};
+}
+
+Area randomArea(std::mt19937 & rng, int size)
+{
+	std::uniform_int_distribution<int> blocked(0, 3);
+	Tileset tiles;
+	for(int y = 0; y < size; y++)
+	{
+		for(int x = 0; x < size; x++)
+		{
+			if(blocked(rng))
+				tiles.insert(int3(x, y, 0));
+		}
+	}
+	return Area(tiles);
+}
+
+}
+
+TEST(RmgPathTest, SearchMatchesReference)
+{
+	std::mt19937 rng(17);
+	const int size = 40;
+	std::uniform_int_distribution<int> coord(0, size - 1);
+
+	for(int i = 0; i < 30; i++)
+	{
+		const Area area = randomArea(rng, size);
+		const Area border(area.getBorder());
+		auto moveCost = [&border](const int3 & src, const int3 & dst)
+		{
+			return 1.f / (1.f + border.distanceSqr(dst));
+		};
+
+		const int3 dst(coord(rng), coord(rng), 0);
+		Area start;
+		for(int t = 0; t < 5; t++)
+			start.add(area.getTilesVector().at(rng() % area.getTilesVector().size()));
+
+		for(bool straight : {true, false})
+		{
+			Path path(area);
+			path.connect(start);
+
+			const Tileset expected = referenceSearch(area, start, dst, straight, moveCost);
+			const Path found = path.search(dst, straight, moveCost);
+
+			EXPECT_EQ(found.valid(), !expected.empty());
+			EXPECT_EQ(found.getPathArea().getTiles(), expected);
+		}
+	}
+}
+
+TEST(RmgPathTest, SearchForAreaMatchesSearchForTileset)
+{
+	std::mt19937 rng(29);
+	const int size = 40;
+	const Area area = randomArea(rng, size);
+	const auto & tiles = area.getTilesVector();
+
+	for(int i = 0; i < 30; i++)
+	{
+		Path path(area);
+		path.connect(tiles.at(rng() % tiles.size()));
+
+		Tileset destination;
+		for(int t = 0; t < 4; t++)
+			destination.insert(tiles.at(rng() % tiles.size()));
+
+		const Path fromArea = path.search(Area(destination), false);
+		const Path fromTileset = path.search(destination, false);
+
+		EXPECT_EQ(fromArea.getPathArea().getTiles(), fromTileset.getPathArea().getTiles());
+		EXPECT_TRUE(fromArea.getPathArea().overlap(std::vector<int3>(destination.begin(), destination.end())));
+	}
+}
+
+// Run with --gtest_also_run_disabled_tests to compare with previous implementation, cost functions resemble road and connection placement
+TEST(RmgPathTest, DISABLED_Benchmark)
+{
+	std::mt19937 rng(23);
+	const int size = 144;
+	const Area area = randomArea(rng, size);
+	const auto & tiles = area.getTilesVector();
+
+	std::vector<float> borderDistances(size * size);
+	for(int i = 0; i < size * size; i++)
+		borderDistances[i] = static_cast<float>(std::min({i % size, i / size, size - 1 - i % size, size - 1 - i / size}));
+
+	auto roadCost = [&borderDistances](const int3 & src, const int3 & dst)
+	{
+		float ret = dst.dist2d(src);
+		float dist = borderDistances[dst.y * size + dst.x];
+		if(dist > 1.0f)
+			ret /= dist;
+		return ret;
+	};
+
+	auto connectionCost = [&borderDistances](const int3 & src, const int3 & dst)
+	{
+		return 1.f / (1.f + borderDistances[dst.y * size + dst.x]);
+	};
+
+	std::vector<int3> destinations;
+	for(int i = 0; i < 100; i++)
+		destinations.push_back(tiles.at(rng() % tiles.size()));
+
+	auto measure = [&](const std::string & name, const std::function<void(const int3 &)> & search)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for(const auto & dst : destinations)
+			search(dst);
+
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		logGlobal->info("%s: %d us per search", name, duration.count() / destinations.size());
+	};
+
+	Path path(area);
+	path.connect(tiles.front());
+	Area start(path.getPathArea());
+
+	measure("Roads", [&](const int3 & dst)
+	{
+		path.search(dst, true, roadCost);
+	});
+	measure("Roads, previous implementation", [&](const int3 & dst)
+	{
+		referenceSearch(area, start, dst, true, roadCost);
+	});
+	measure("Connections", [&](const int3 & dst)
+	{
+		path.search(dst, false, connectionCost);
+	});
+	measure("Connections, previous implementation", [&](const int3 & dst)
+	{
+		referenceSearch(area, start, dst, false, connectionCost);
+	});
+}
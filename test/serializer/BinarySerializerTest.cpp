@@ -0,0 +1,189 @@
+/*
+ * BinarySerializerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "mock/mock_IGameCallback.h"
+
+#include "../../lib/bonuses/Bonus.h"
+#include "../../lib/bonuses/Limiters.h"
+#include "../../lib/bonuses/Propagators.h"
+#include "../../lib/bonuses/Updaters.h"
+#include "../../lib/gameState/CGameState.h"
+#include "../../lib/networkPacks/BattleChanges.h"
+#include "../../lib/serializer/CLoadFile.h"
+#include "../../lib/serializer/CMemorySerializer.h"
+#include "../../lib/serializer/CSaveFile.h"
+
+using namespace testing;
+
+TEST(BinarySerializerTest, SharedPointersKeepIdentity)
+{
+	std::vector<std::shared_ptr<Bonus>> saved;
+	for(int i = 0; i < 100; i++)
+		saved.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::ARTIFACT, i, BonusSourceID(ArtifactID(i % 7))));
+
+	// every bonus is referenced twice
+	for(int i = 0; i < 100; i++)
+		saved.push_back(saved[99 - i]);
+
+	CMemorySerializer mem;
+	mem.oser & saved;
+
+	std::vector<std::shared_ptr<Bonus>> loaded;
+	mem.iser & loaded;
+
+	ASSERT_EQ(loaded.size(), saved.size());
+	EXPECT_EQ(mem.iser.loadedPointers.size(), 100);
+
+	for(int i = 0; i < 100; i++)
+	{
+		EXPECT_EQ(loaded[i]->val, i);
+		EXPECT_EQ(loaded[i], loaded[199 - i]);
+	}
+}
+
+TEST(BinarySerializerTest, RepeatedStringsAreCompacted)
+{
+	std::vector<std::string> saved;
+	for(int i = 0; i < 1000; i++)
+		saved.push_back("string" + std::to_string(i % 10));
+
+	CMemorySerializer mem;
+	mem.oser & saved;
+
+	std::vector<std::string> loaded;
+	mem.iser & loaded;
+
+	EXPECT_EQ(loaded, saved);
+	EXPECT_EQ(mem.oser.savedStrings.size(), 10);
+	EXPECT_EQ(mem.iser.loadedStrings.size(), 10);
+}
+
+TEST(BinarySerializerTest, UnitChangesSurviveLegacyFormat)
+{
+	for(auto version : {ESerializationVersion::COMPRESSED_SAVES, ESerializationVersion::CURRENT})
+	{
+		std::vector<UnitChanges> saved;
+		saved.emplace_back(5, UnitChanges::EOperation::RESET_STATE);
+		saved.back().healthDelta = -42;
+		saved.back().state.waiting = true;
+		saved.back().state.waitedThisTurn = true;
+		saved.back().state.counterAttacks.used = 1;
+		saved.back().state.counterAttacks.totalCache = 2;
+		saved.back().state.health.firstHPleft = 7;
+		saved.back().state.health.fullUnits = 11;
+		saved.back().state.cloneID = 8;
+		saved.back().state.position = BattleHex(34);
+
+		saved.emplace_back(8, UnitChanges::EOperation::ADD);
+		saved.back().info.id = 8;
+		saved.back().info.count = 13;
+		saved.back().info.type = CreatureID(13);
+		saved.back().info.side = BattleSide::DEFENDER;
+		saved.back().info.position = BattleHex(50);
+		saved.back().info.summoned = true;
+
+		CMemorySerializer mem;
+		mem.oser.version = version;
+		mem.iser.version = version;
+		mem.oser & saved;
+
+		std::vector<UnitChanges> loaded;
+		mem.iser & loaded;
+
+		ASSERT_EQ(loaded.size(), 2);
+		EXPECT_EQ(loaded[0].id, 5);
+		EXPECT_EQ(loaded[0].healthDelta, -42);
+		EXPECT_EQ(loaded[0].operation, UnitChanges::EOperation::RESET_STATE);
+		EXPECT_TRUE(loaded[0].state.waiting);
+		EXPECT_TRUE(loaded[0].state.waitedThisTurn);
+		EXPECT_FALSE(loaded[0].state.defending);
+		EXPECT_EQ(loaded[0].state.counterAttacks.used, 1);
+		EXPECT_EQ(loaded[0].state.counterAttacks.totalCache, 2);
+		EXPECT_EQ(loaded[0].state.health.firstHPleft, 7);
+		EXPECT_EQ(loaded[0].state.health.fullUnits, 11);
+		EXPECT_EQ(loaded[0].state.cloneID, 8);
+		EXPECT_EQ(loaded[0].state.position, BattleHex(34));
+
+		EXPECT_EQ(loaded[1].operation, UnitChanges::EOperation::ADD);
+		EXPECT_EQ(loaded[1].info.id, 8);
+		EXPECT_EQ(loaded[1].info.count, 13);
+		EXPECT_EQ(loaded[1].info.type, CreatureID(13));
+		EXPECT_EQ(loaded[1].info.side, BattleSide::DEFENDER);
+		EXPECT_EQ(loaded[1].info.position, BattleHex(50));
+		EXPECT_TRUE(loaded[1].info.summoned);
+	}
+}
+
+TEST(BinarySerializerTest, SaveFileSpanningMultipleChunks)
+{
+	std::vector<int64_t> saved;
+	for(int64_t i = 0; i < 1000000; i++)
+		saved.push_back(i % 1000);
+
+	auto tempPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-test-%%%%%%%%.vsgm1");
+	{
+		CSaveFile save(tempPath);
+		save << saved;
+		save.flush();
+	}
+
+	// compressed data must be smaller than serialized data
+	EXPECT_LT(boost::filesystem::file_size(tempPath), saved.size());
+
+	std::vector<int64_t> loaded;
+	{
+		CLoadFile load(tempPath);
+		load >> loaded;
+	}
+	boost::filesystem::remove(tempPath);
+
+	EXPECT_EQ(loaded, saved);
+}
+
+// Loads and saves game specified in VCMI_BENCHMARK_SAVEGAME environment variable, e.g. late-game save on XL map
+// Requires installed game data and mods used by this save
+// Run with --gtest_also_run_disabled_tests
+TEST(BinarySerializerTest, DISABLED_SaveGameBenchmark)
+{
+	const char * savePath = std::getenv("VCMI_BENCHMARK_SAVEGAME");
+	if(savePath == nullptr)
+		GTEST_SKIP() << "VCMI_BENCHMARK_SAVEGAME is not set";
+
+	GameCallbackMock callback(nullptr);
+	const int repeats = 3;
+
+	for(int i = 0; i < repeats; i++)
+	{
+		auto loadStart = std::chrono::steady_clock::now();
+		{
+			CLoadFile lf(savePath, ESerializationVersion::MINIMAL);
+			lf.serializer.cb = &callback;
+			callback.loadCommonState(lf);
+		}
+		auto loadDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loadStart);
+
+		auto tempPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-benchmark-%%%%%%%%.vsgm1");
+		auto saveStart = std::chrono::steady_clock::now();
+		{
+			CSaveFile save(tempPath);
+			callback.saveCommonState(save);
+			save.flush();
+		}
+		auto saveDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - saveStart);
+
+		std::cout << "Load: " << loadDuration.count() << " ms, save: " << saveDuration.count() << " ms, size: " << boost::filesystem::file_size(tempPath) << " bytes" << std::endl;
+
+		boost::filesystem::remove(tempPath);
+		delete callback.gameState();
+		callback.setGameState(nullptr);
+	}
+}
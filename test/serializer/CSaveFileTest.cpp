@@ -0,0 +1,151 @@
+/*
+ * CSaveFileTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../../lib/serializer/CLoadFile.h"
+#include "../../lib/serializer/CSaveFile.h"
+
+using namespace testing;
+
+class CSaveFileTest : public Test
+{
+public:
+	boost::filesystem::path directory;
+	boost::filesystem::path savePath;
+
+	void SetUp() override
+	{
+		directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-save-%%%%-%%%%");
+		boost::filesystem::create_directories(directory);
+		savePath = directory / "save.vsgm1";
+	}
+
+	void TearDown() override
+	{
+		boost::system::error_code ec;
+		boost::filesystem::remove_all(directory, ec);
+	}
+
+	std::shared_ptr<CSaveFile> makeSave(const std::vector<std::string> & content)
+	{
+		auto save = std::make_shared<CSaveFile>(savePath);
+		*save << content;
+		return save;
+	}
+
+	std::vector<std::string> load()
+	{
+		std::vector<std::string> content;
+		CLoadFile loader(savePath);
+		loader >> content;
+		return content;
+	}
+
+	bool hasTemporaryFile() const
+	{
+		boost::filesystem::path tempName = savePath;
+		tempName += ".tmp";
+		return boost::filesystem::exists(tempName);
+	}
+};
+
+TEST_F(CSaveFileTest, FlushReplacesExistingSave)
+{
+	const std::vector<std::string> oldContent = {"old"};
+	const std::vector<std::string> newContent(1000, "new save content");
+
+	makeSave(oldContent)->flush();
+	EXPECT_EQ(load(), oldContent);
+
+	makeSave(newContent)->flush();
+	EXPECT_EQ(load(), newContent);
+	EXPECT_FALSE(hasTemporaryFile());
+}
+
+TEST_F(CSaveFileTest, FailedFlushRemovesTemporaryFile)
+{
+	// non-empty directory can not be replaced by rename
+	boost::filesystem::create_directories(savePath / "subdirectory");
+
+	EXPECT_ANY_THROW(makeSave({"content"})->flush());
+	EXPECT_FALSE(hasTemporaryFile());
+	EXPECT_TRUE(boost::filesystem::is_directory(savePath / "subdirectory"));
+}
+
+TEST_F(CSaveFileTest, WriterReportsResultOnceFileIsWritten)
+{
+	const std::vector<std::string> content(1000, "written in background");
+
+	makeSave({"old"})->flush();
+
+	SaveFileWriter writer;
+	std::optional<bool> result;
+	writer.write(makeSave(content), [&](bool success)
+	{
+		EXPECT_EQ(load(), content);
+		EXPECT_FALSE(hasTemporaryFile());
+		result = success;
+	});
+	writer.waitForPendingSave();
+
+	EXPECT_EQ(result, std::optional<bool>(true));
+	EXPECT_EQ(load(), content);
+
+	// callback is called only once
+	result.reset();
+	writer.waitForPendingSave();
+	writer.poll();
+	EXPECT_FALSE(result.has_value());
+}
+
+TEST_F(CSaveFileTest, WriterReportsFailure)
+{
+	boost::filesystem::create_directories(savePath / "subdirectory");
+
+	SaveFileWriter writer;
+	std::optional<bool> result;
+	writer.write(makeSave({"content"}), [&](bool success)
+	{
+		result = success;
+	});
+
+	while(!result.has_value())
+	{
+		writer.poll();
+		boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+	}
+
+	EXPECT_FALSE(*result);
+	EXPECT_FALSE(hasTemporaryFile());
+	EXPECT_TRUE(boost::filesystem::is_directory(savePath / "subdirectory"));
+}
+
+TEST_F(CSaveFileTest, NextWriteWaitsForPreviousOne)
+{
+	const std::vector<std::string> first(1000, "first");
+	const std::vector<std::string> second(1000, "second");
+
+	SaveFileWriter writer;
+	std::vector<bool> results;
+	writer.write(makeSave(first), [&](bool success)
+	{
+		EXPECT_EQ(load(), first);
+		results.push_back(success);
+	});
+	writer.write(makeSave(second), [&](bool success)
+	{
+		results.push_back(success);
+	});
+	writer.waitForPendingSave();
+
+	EXPECT_EQ(results, std::vector<bool>({true, true}));
+	EXPECT_EQ(load(), second);
+}
@@ -0,0 +1,144 @@
+/*
+ * ConnectionTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../../lib/networkPacks/PacksForClient.h"
+#include "../../lib/serializer/Connection.h"
+#include "../../lib/serializer/ESerializationVersion.h"
+
+namespace test
+{
+
+using ::testing::Test;
+
+class FakeNetworkConnection final : public INetworkConnection
+{
+public:
+	std::vector<std::vector<std::byte>> sentPackets;
+
+	void sendPacket(const std::vector<std::byte> & message) override
+	{
+		sentPackets.push_back(message);
+	}
+
+	void sendPacket(const NetworkPacketPtr & message) override
+	{
+		sentPackets.push_back(message ? *message : std::vector<std::byte>());
+	}
+
+	void setAsyncWritesEnabled(bool on) override {}
+	void close() override {}
+};
+
+class ConnectionTest : public Test
+{
+public:
+	std::shared_ptr<FakeNetworkConnection> senderNetwork;
+	std::shared_ptr<FakeNetworkConnection> receiverNetwork;
+	std::unique_ptr<CConnection> sender;
+	std::unique_ptr<CConnection> receiver;
+
+	ConnectionTest()
+		: senderNetwork(std::make_shared<FakeNetworkConnection>())
+		, receiverNetwork(std::make_shared<FakeNetworkConnection>())
+		, sender(std::make_unique<CConnection>(senderNetwork))
+		, receiver(std::make_unique<CConnection>(receiverNetwork))
+	{
+	}
+
+	static std::string makeText(size_t length)
+	{
+		std::mt19937 rng(42);
+		std::string result;
+		for (size_t i = 0; i < length; ++i)
+			result += static_cast<char>('a' + rng() % 26);
+		return result;
+	}
+
+	std::string transferText(const std::string & text)
+	{
+		PlayerMessageClient pack(PlayerColor(1), text);
+		sender->sendPack(pack);
+
+		auto received = receiver->retrievePack(senderNetwork->sentPackets.back());
+		auto * message = dynamic_cast<PlayerMessageClient *>(received.get());
+		if (message == nullptr)
+			return {};
+		return message->text;
+	}
+};
+
+TEST_F(ConnectionTest, smallPackIsNotCompressed)
+{
+	sender->setSerializationVersion(ESerializationVersion::CURRENT);
+	receiver->setSerializationVersion(ESerializationVersion::CURRENT);
+
+	std::string text = makeText(100);
+	EXPECT_EQ(transferText(text), text);
+	EXPECT_EQ(senderNetwork->sentPackets.back().front(), std::byte{0});
+}
+
+TEST_F(ConnectionTest, largePackIsNotCompressedWithoutNegotiation)
+{
+	std::string text = makeText(10000);
+	EXPECT_EQ(transferText(text), text);
+	EXPECT_GT(senderNetwork->sentPackets.back().size(), text.size());
+}
+
+TEST_F(ConnectionTest, largePackIsCompressed)
+{
+	sender->setSerializationVersion(ESerializationVersion::CURRENT);
+	receiver->setSerializationVersion(ESerializationVersion::CURRENT);
+
+	std::string text = makeText(10000);
+	EXPECT_EQ(transferText(text), text);
+	EXPECT_LT(senderNetwork->sentPackets.back().size(), text.size());
+}
+
+TEST_F(ConnectionTest, compressionReusesPreviousPacks)
+{
+	sender->setSerializationVersion(ESerializationVersion::CURRENT);
+	receiver->setSerializationVersion(ESerializationVersion::CURRENT);
+
+	std::string text = makeText(10000);
+	EXPECT_EQ(transferText(text), text);
+	size_t firstPackSize = senderNetwork->sentPackets.back().size();
+
+	EXPECT_EQ(transferText(text), text);
+	size_t secondPackSize = senderNetwork->sentPackets.back().size();
+
+	// second pack is identical to first one and must be encoded as reference to already sent data
+	EXPECT_LT(secondPackSize * 10, firstPackSize);
+}
+
+TEST_F(ConnectionTest, serializedPackIsCompressedPerConnection)
+{
+	sender->setSerializationVersion(ESerializationVersion::CURRENT);
+	receiver->setSerializationVersion(ESerializationVersion::CURRENT);
+
+	std::string text = makeText(10000);
+	PlayerMessageClient pack(PlayerColor(1), text);
+
+	auto serialized = sender->serializePack(pack);
+	sender->sendSerializedPack(serialized);
+	sender->sendSerializedPack(serialized);
+
+	ASSERT_EQ(senderNetwork->sentPackets.size(), 2);
+	for (const auto & packet : senderNetwork->sentPackets)
+	{
+		auto received = receiver->retrievePack(packet);
+		auto * message = dynamic_cast<PlayerMessageClient *>(received.get());
+		ASSERT_NE(message, nullptr);
+		EXPECT_EQ(message->text, text);
+	}
+}
+
+}
@@ -112,7 +112,7 @@ public:
 	{
 	}
 
-    void onUnitAdded(uint32_t id, const JsonNode & data)
+    void onUnitAdded(uint32_t id, const ::battle::UnitInfo & info)
 	{
 		using namespace ::battle;
 
@@ -124,7 +124,7 @@ public:
 
 		EXPECT_CALL(clone, acquireState()).WillOnce(Return(cloneState));
 
-		cloneAddInfo->load(id, data);
+		*cloneAddInfo = info;
 	}
 
 	void checkCloneLifetimeMarker(uint32_t id, const std::vector<Bonus> & bonus)
@@ -189,9 +189,9 @@ public:
 		}
 	}
 
-    void onUnitAdded(uint32_t id, const JsonNode & data)
+    void onUnitAdded(uint32_t id, const ::battle::UnitInfo & info)
 	{
-		unitAddInfo->load(id, data);
+		*unitAddInfo = info;
 	}
 
 protected: